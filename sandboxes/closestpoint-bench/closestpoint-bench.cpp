@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/SLA/IndexedMesh.hpp>
+
+const std::string USAGE_STR = {
+    "Usage: closestpoint-bench stlfilename.stl [num_points] [seed]"
+};
+
+using namespace Slic3r;
+
+// Compares the batched closest point query IndexedMesh::squared_distances() with calling
+// IndexedMesh::squared_distance() for each point, on random points around the mesh.
+// The number of the mismatching results shall be zero.
+int main(const int argc, const char *argv[])
+{
+    if (argc < 2) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_SUCCESS;
+    }
+    const size_t   num_points = argc > 2 ? size_t(std::max(1, atoi(argv[2]))) : 200000;
+    const unsigned seed       = argc > 3 ? unsigned(atoi(argv[3])) : 0;
+
+    TriangleMesh mesh;
+    if (! mesh.ReadSTLFile(argv[1])) {
+        std::cerr << "Error loading " << argv[1] << std::endl;
+        return -1;
+    }
+    mesh.repair();
+    if (mesh.facets_count() == 0) {
+        std::cerr << "Error loading " << argv[1] << " . It is empty." << std::endl;
+        return -1;
+    }
+    mesh.require_shared_vertices();
+
+    auto             start  = std::chrono::steady_clock::now();
+    sla::IndexedMesh emesh(mesh);
+    double           t_tree = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Random points in the bounding box of the mesh inflated by a tenth of its size.
+    BoundingBoxf3 bb     = mesh.bounding_box();
+    Vec3d         margin = 0.1 * bb.size();
+    std::mt19937  rng(seed);
+    std::uniform_real_distribution<double> dist_x(bb.min.x() - margin.x(), bb.max.x() + margin.x());
+    std::uniform_real_distribution<double> dist_y(bb.min.y() - margin.y(), bb.max.y() + margin.y());
+    std::uniform_real_distribution<double> dist_z(bb.min.z() - margin.z(), bb.max.z() + margin.z());
+    std::vector<Vec3d> points(num_points);
+    for (Vec3d &p : points)
+        p = Vec3d(dist_x(rng), dist_y(rng), dist_z(rng));
+
+    std::vector<double> dists_single(num_points);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_points; ++ i)
+        dists_single[i] = emesh.squared_distance(points[i]);
+    double t_single = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<size_t> face_ids;
+    std::vector<Vec3d>  closest;
+    start = std::chrono::steady_clock::now();
+    std::vector<double> dists_batched = emesh.squared_distances(points, face_ids, closest);
+    double t_batched = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t num_mismatches = 0;
+    for (size_t i = 0; i < num_points; ++ i)
+        if (dists_single[i] != dists_batched[i])
+            ++ num_mismatches;
+
+    std::cout << mesh.facets_count() << " triangles, " << num_points << " points" << std::endl;
+    std::cout << "AABB tree: " << t_tree << " s" << std::endl;
+    std::cout << "per point query: " << t_single << " s, " << double(num_points) / t_single << " points/s" << std::endl;
+    std::cout << "batched query: " << t_batched << " s, " << double(num_points) / t_batched << " points/s" << std::endl;
+    std::cout << "mismatches: " << num_mismatches << std::endl;
+    return num_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/MedialAxis.hpp>
+
+const std::string USAGE_STR = {
+    "Usage: medialaxis-bench stlfilename.stl [layer_height_mm] [extrusion_width_mm] [repeat]"
+};
+
+using namespace Slic3r;
+
+// Runs MedialAxis::build() over the areas of the slices thinner than two extrusions,
+// which is what the thin walls and the gap fill of the perimeter generator feed it with.
+// The checksum of the output allows to verify that a change of the implementation keeps the output identical.
+int main(const int argc, const char *argv[])
+{
+    if (argc < 2) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_SUCCESS;
+    }
+    const double layer_height = argc > 2 ? atof(argv[2]) : 0.2;
+    const double width        = argc > 3 ? atof(argv[3]) : 0.45;
+    const int    repeat       = argc > 4 ? std::max(1, atoi(argv[4])) : 1;
+
+    TriangleMesh mesh;
+    if (! mesh.ReadSTLFile(argv[1])) {
+        std::cerr << "Error loading " << argv[1] << std::endl;
+        return -1;
+    }
+    mesh.repair();
+    if (mesh.facets_count() == 0) {
+        std::cerr << "Error loading " << argv[1] << " . It is empty." << std::endl;
+        return -1;
+    }
+
+    std::vector<float> zs;
+    for (double z = 0.5 * layer_height; z < mesh.bounding_box().max.z(); z += layer_height)
+        zs.emplace_back(float(z));
+    std::vector<ExPolygons> slices;
+    TriangleMeshSlicer(&mesh).slice(zs, SlicingMode::Regular, &slices, []() {});
+
+    // Thin areas: what does not survive an opening by the width of two extrusions.
+    const coord_t   max_width = scale_(2. * width);
+    const coord_t   min_width = scale_(0.2 * width);
+    ExPolygons      thin_areas;
+    for (const ExPolygons &slice : slices)
+        for (const ExPolygon &expoly : slice)
+            append(thin_areas, diff_ex(to_polygons(expoly), offset2(to_polygons(expoly), - float(max_width / 2), float(max_width / 2)), true));
+
+    double   checksum   = 0.;
+    size_t   num_points = 0;
+    auto     start      = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++ i)
+        for (const ExPolygon &expoly : thin_areas) {
+            ThickPolylines polylines;
+            MedialAxis(expoly, max_width, min_width, coord_t(scale_(layer_height))).build(polylines);
+            if (i == 0)
+                for (const ThickPolyline &polyline : polylines) {
+                    num_points += polyline.points.size();
+                    for (size_t j = 0; j < polyline.points.size(); ++ j)
+                        checksum += double(polyline.points[j].x()) + double(polyline.points[j].y()) + polyline.width[j];
+                }
+        }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << slices.size() << " layers, " << thin_areas.size() << " thin areas, " << num_points << " points" << std::endl;
+    std::cout << "checksum: " << std::fixed << checksum << std::endl;
+    std::cout << "medial axis: " << elapsed / repeat << " s per run" << std::endl;
+    return EXIT_SUCCESS;
+}
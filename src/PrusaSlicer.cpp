@@ -17,10 +17,17 @@
     #endif /* SLIC3R_GUI */
 #endif /* WIN32 */
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/nowide/args.hpp>
 #include <boost/nowide/cenv.hpp>
+#include <boost/nowide/fstream.hpp>
 #include <boost/nowide/iostream.hpp>
 #include <boost/nowide/integration/filesystem.hpp>
 
@@ -54,6 +61,42 @@
 
 using namespace Slic3r;
 
+static ArrangeParams arrange_params(const DynamicPrintConfig &print_config)
+{
+    ArrangeParams arrange_cfg;
+    arrange_cfg.min_obj_distance = scaled(PrintConfig::min_object_distance(&print_config)) * 2;
+    arrange_cfg.min_obj_distance += scaled(print_config.opt_float("duplicate_distance"));
+    return arrange_cfg;
+}
+
+// Duplicates the model dups times and arranges it on the bed, or around the center point if supplied.
+static void arrange_model(Model &model, const DynamicPrintConfig &print_config, const Points &bed, int dups, const Vec2d *center)
+{
+    ArrangeParams arrange_cfg = arrange_params(print_config);
+    if (dups > 1)
+        // if all input objects have defined position(s) apply duplication to the whole model
+        duplicate(model, size_t(dups), bed, arrange_cfg);
+    if (center)
+        arrange_objects(model, InfiniteBed{scaled(*center)}, arrange_cfg);
+    else
+        arrange_objects(model, bed, arrange_cfg);
+}
+
+// Number of slicing jobs to run concurrently in the --server and --batch modes.
+static size_t num_concurrent_jobs(const DynamicPrintAndCLIConfig &config)
+{
+    int jobs = config.opt_int("jobs");
+    return size_t((jobs > 0) ? jobs : std::max(1, int(boost::thread::hardware_concurrency())));
+}
+
+// Unless the number of threads is set explicitly, give each of the concurrent jobs an equal share of the cores.
+static void share_threads_between_jobs(DynamicPrintConfig &print_config, size_t num_jobs)
+{
+    ConfigOptionInt *opt_threads = print_config.option<ConfigOptionInt>("slicing_threads", true);
+    if (opt_threads->value == 0 && num_jobs > 1)
+        opt_threads->value = std::max(1, int(boost::thread::hardware_concurrency() / num_jobs));
+}
+
 int CLI::run(int argc, char **argv)
 {
     // Mark the main thread for the debugger and for runtime checks.
@@ -442,6 +485,11 @@ int CLI::run(int argc, char **argv)
         } else if (opt_key == "export_3mf") {
             if (! this->export_models(IO::TMF))
                 return 1;
+        } else if (opt_key == "server") {
+            return this->run_server(printer_technology);
+        } else if (opt_key == "batch") {
+            if (int ret = this->run_batch(printer_technology, bed, dups, user_center_specified); ret != 0)
+                return ret;
         } else if (opt_key == "export_gcode" || opt_key == "export_sla" || opt_key == "slice") {
             if (opt_key == "export_gcode" && printer_technology == ptSLA) {
                 boost::nowide::cerr << "error: cannot export G-code for an FFF configuration" << std::endl;
@@ -465,9 +513,6 @@ int CLI::run(int argc, char **argv)
                 std::string outfile = m_config.opt_string("output");
                 Print       fff_print;
                 SLAPrint    sla_print;
-                std::shared_ptr<SLAArchive> sla_archive = Slic3r::get_output_format(m_print_config);
-
-                sla_print.set_printer(sla_archive);
                 sla_print.set_status_callback(
                             [](const PrintBase::SlicingStatus& s)
                 {
@@ -475,73 +520,24 @@ int CLI::run(int argc, char **argv)
                         printf("%3d%s %s\n", s.percent, "% =>", s.main_text.c_str());
                 });
 
-                PrintBase  *print = (printer_technology == ptFFF) ? static_cast<PrintBase*>(&fff_print) : static_cast<PrintBase*>(&sla_print);
-                
                 if (! m_config.opt_bool("dont_arrange")) {
-                    ArrangeParams arrange_cfg;
-                    arrange_cfg.min_obj_distance = scaled(PrintConfig::min_object_distance(&m_print_config)) * 2;
-                    arrange_cfg.min_obj_distance += scaled(m_print_config.opt_float("duplicate_distance"));
-                    if (dups > 1) {
-                            try {
-                            // if all input objects have defined position(s) apply duplication to the whole model
-                            duplicate(model, size_t(dups), bed, arrange_cfg);
-                        } catch (std::exception & ex) {
-                            boost::nowide::cerr << "error: " << ex.what() << std::endl;
-                            return 1;
-                        }
+                    try {
+                        arrange_model(model, m_print_config, bed, dups, user_center_specified ? &m_config.option<ConfigOptionPoint>("center")->value : nullptr);
+                    } catch (std::exception & ex) {
+                        boost::nowide::cerr << "error: " << ex.what() << std::endl;
+                        return 1;
                     }
-                    if (user_center_specified) {
-                        Vec2d c = m_config.option<ConfigOptionPoint>("center")->value;
-                        arrange_objects(model, InfiniteBed{scaled(c)}, arrange_cfg);
-                    } else
-                        arrange_objects(model, bed, arrange_cfg);
                 }
-                if (printer_technology == ptFFF) {
-                    for (auto* mo : model.objects)
-                        fff_print.auto_assign_extruders(mo);
-                } else {
-                    // The default for "output_filename_format" is good for FDM: "[input_filename_base].gcode"
-                    // Replace it with a reasonable SLA default.
-                    std::string &format = m_print_config.opt_string("output_filename_format", true);
-                    if (format == static_cast<const ConfigOptionString*>(m_print_config.def()->get("output_filename_format")->default_value.get())->value)
-                        format = "[input_filename_base].SL1";
-                }
-                print->apply(model, m_print_config);
-                std::pair<PrintBase::PrintValidationError, std::string> err = print->validate();
-                if (err.first != PrintBase::PrintValidationError::pveNone) {
-                    boost::nowide::cerr << err.second << std::endl;
+                std::string outfile_requested = outfile;
+                std::string error = export_print(fff_print, sla_print, model, m_print_config, printer_technology, outfile);
+                if (! error.empty()) {
+                    boost::nowide::cerr << error << std::endl;
                     return 1;
                 }
-                if (print->empty())
-                    boost::nowide::cout << "Nothing to print for " << outfile << " . Either the print is empty or no object is fully inside the print volume." << std::endl;
+                if (outfile.empty())
+                    boost::nowide::cout << "Nothing to print for " << outfile_requested << " . Either the print is empty or no object is fully inside the print volume." << std::endl;
                 else
-                    try {
-                        std::string outfile_final;
-                        print->process();
-                        if (printer_technology == ptFFF) {
-                            // The outfile is processed by a PlaceholderParser.
-                            outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
-                            outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
-                        } else if (printer_technology == ptSLA) {
-                            outfile = sla_print.output_filepath(outfile);
-                            // We need to finalize the filename beforehand because the export function sets the filename inside the zip metadata
-                            outfile_final = sla_print.print_statistics().finalize_output_path(outfile);
-                            sla_archive->export_print(outfile_final, sla_print);
-                        }
-                        if (outfile != outfile_final) {
-                            if (Slic3r::rename_file(outfile, outfile_final)) {
-                                boost::nowide::cerr << "Renaming file " << outfile << " to " << outfile_final << " failed" << std::endl;
-                                return 1;
-                            }
-                            outfile = outfile_final;
-                        }
-                        // Run the post-processing scripts if defined.
-                        run_post_process_scripts(outfile, fff_print.full_print_config());
-                        boost::nowide::cout << "Slicing result exported to " << outfile << std::endl;
-                    } catch (const std::exception &ex) {
-                        boost::nowide::cerr << ex.what() << std::endl;
-                        return 1;
-                    }
+                    boost::nowide::cout << "Slicing result exported to " << outfile << std::endl;
 /*
                 print.center = ! m_config.has("center")
                     && ! m_config.has("align_xy")
@@ -600,6 +596,452 @@ int CLI::run(int argc, char **argv)
     return 0;
 }
 
+std::string CLI::export_print(Print &fff_print, SLAPrint &sla_print, Model &model, DynamicPrintConfig &print_config,
+                              PrinterTechnology printer_technology, std::string &outfile)
+{
+    std::shared_ptr<SLAArchive> sla_archive;
+    if (printer_technology == ptFFF) {
+        for (auto* mo : model.objects)
+            fff_print.auto_assign_extruders(mo);
+    } else {
+        sla_archive = Slic3r::get_output_format(print_config);
+        sla_print.set_printer(sla_archive);
+        // The default for "output_filename_format" is good for FDM: "[input_filename_base].gcode"
+        // Replace it with a reasonable SLA default.
+        std::string &format = print_config.opt_string("output_filename_format", true);
+        if (format == static_cast<const ConfigOptionString*>(print_config.def()->get("output_filename_format")->default_value.get())->value)
+            format = "[input_filename_base].SL1";
+    }
+    PrintBase *print = (printer_technology == ptFFF) ? static_cast<PrintBase*>(&fff_print) : static_cast<PrintBase*>(&sla_print);
+    print->apply(model, print_config);
+    std::pair<PrintBase::PrintValidationError, std::string> err = print->validate();
+    if (err.first != PrintBase::PrintValidationError::pveNone)
+        return err.second;
+    if (print->empty()) {
+        outfile.clear();
+        return std::string();
+    }
+    try {
+        std::string outfile_final;
+        print->process();
+        if (printer_technology == ptFFF) {
+            // The outfile is processed by a PlaceholderParser.
+            outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
+            outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
+        } else if (printer_technology == ptSLA) {
+            outfile = sla_print.output_filepath(outfile);
+            // We need to finalize the filename beforehand because the export function sets the filename inside the zip metadata
+            outfile_final = sla_print.print_statistics().finalize_output_path(outfile);
+            sla_archive->export_print(outfile_final, sla_print);
+        }
+        if (outfile != outfile_final) {
+            if (Slic3r::rename_file(outfile, outfile_final))
+                return "Renaming file " + outfile + " to " + outfile_final + " failed";
+            outfile = outfile_final;
+        }
+        // Run the post-processing scripts if defined.
+        run_post_process_scripts(outfile, fff_print.full_print_config());
+    } catch (const std::exception &ex) {
+        return ex.what();
+    }
+    return std::string();
+}
+
+// Splits a line of the --server input into the command line tokens. Tokens containing spaces may be enclosed in double quotes.
+static std::vector<std::string> split_job_line(const std::string &line)
+{
+    std::vector<std::string> tokens;
+    std::string              token;
+    bool                     in_quotes = false;
+    bool                     has_token = false;
+    for (char c : line) {
+        if (c == '"') {
+            in_quotes = ! in_quotes;
+            has_token = true;
+        } else if (! in_quotes && (c == ' ' || c == '\t' || c == '\r')) {
+            if (has_token)
+                tokens.emplace_back(std::move(token));
+            token.clear();
+            has_token = false;
+        } else {
+            token += c;
+            has_token = true;
+        }
+    }
+    if (has_token)
+        tokens.emplace_back(std::move(token));
+    return tokens;
+}
+
+// Models loaded by the --server jobs, reused by the following jobs until the input file is modified.
+class ServerModelCache
+{
+public:
+    // Returns a copy of the cached model or loads it. Returns false and fills in the error message if the file could not be loaded.
+    bool get(const std::string &path, Model &model, DynamicPrintConfig &config, std::string &error)
+    {
+        boost::system::error_code ec;
+        std::time_t timestamp = boost::filesystem::last_write_time(path, ec);
+        if (ec) {
+            error = "No such file: " + path;
+            return false;
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                auto it = m_models.find(path);
+                if (it != m_models.end() && it->second.timestamp == timestamp) {
+                    it->second.last_used = ++ m_counter;
+                    // The copy keeps the object IDs, so that a Print reused from the previous job recognizes the unchanged objects.
+                    model  = it->second.model;
+                    config = it->second.config;
+                    return true;
+                }
+                if (m_loading.find(path) == m_loading.end())
+                    break;
+                // Another worker is loading the same file, wait for it instead of loading the file twice.
+                m_loaded.wait(lock);
+            }
+            m_loading.insert(path);
+        }
+        bool loaded = false;
+        try {
+            ConfigSubstitutionContext config_substitutions(ForwardCompatibilitySubstitutionRule::Enable);
+            model = Model::read_from_file(path, &config, &config_substitutions, Model::LoadAttribute::AddDefaultInstances);
+            if (model.objects.empty())
+                error = "Error: file is empty: " + path;
+            else
+                loaded = true;
+        } catch (std::exception &ex) {
+            error = path + ": " + ex.what();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loading.erase(path);
+        m_loaded.notify_all();
+        if (! loaded)
+            return false;
+        if (m_models.size() >= max_models) {
+            // Evict the least recently used model.
+            auto it_oldest = std::min_element(m_models.begin(), m_models.end(),
+                [](const auto &l, const auto &r) { return l.second.last_used < r.second.last_used; });
+            m_models.erase(it_oldest);
+        }
+        CachedModel &cached = m_models[path];
+        cached.timestamp = timestamp;
+        cached.last_used = ++ m_counter;
+        cached.model     = model;
+        cached.config    = config;
+        return true;
+    }
+
+private:
+    static constexpr size_t max_models = 16;
+
+    struct CachedModel {
+        std::time_t         timestamp { 0 };
+        size_t              last_used { 0 };
+        Model               model;
+        DynamicPrintConfig  config;
+    };
+    std::map<std::string, CachedModel>  m_models;
+    size_t                              m_counter { 0 };
+    // Files being loaded by one of the workers.
+    std::set<std::string>               m_loading;
+    std::condition_variable             m_loaded;
+    std::mutex                          m_mutex;
+};
+
+// Executes a single --server job: loads the input files, applies the job options over the server configuration,
+// arranges, slices and exports. Returns an error message, or an empty string on success.
+static std::string run_server_job(const std::vector<std::string> &tokens, const DynamicPrintConfig &server_config, PrinterTechnology printer_technology,
+                                  ServerModelCache &model_cache, Print &fff_print, SLAPrint &sla_print, std::string &outfile)
+{
+    DynamicPrintAndCLIConfig job_config;
+    std::vector<std::string> input_files;
+    std::vector<const char*> argv { "" };
+    for (const std::string &token : tokens)
+        argv.emplace_back(token.c_str());
+    if (! job_config.read_cli(int(argv.size()), argv.data(), &input_files))
+        return "Invalid job options";
+    if (input_files.empty())
+        return "No input file";
+
+    Model              model;
+    DynamicPrintConfig print_config = server_config;
+    std::set<ObjectID> object_ids;
+    for (const std::string &file : input_files) {
+        Model              file_model;
+        DynamicPrintConfig file_config;
+        std::string        error;
+        if (! model_cache.get(file, file_model, file_config, error))
+            return error;
+        PrinterTechnology file_printer_technology = Slic3r::printer_technology(file_config);
+        if (file_printer_technology != ptUnknown && file_printer_technology != printer_technology)
+            return "Mixing configurations for FFF and SLA technologies";
+        print_config.apply(file_config, true);
+        if (model.objects.empty()) {
+            // Keep the IDs of the model and of its objects, so that the Print of the previous job
+            // only invalidates what really changed.
+            model = std::move(file_model);
+            for (const ModelObject *o : model.objects)
+                object_ids.insert(o->id());
+        } else {
+            for (const ModelObject *o : file_model.objects)
+                if (object_ids.insert(o->id()).second)
+                    model.add_object_copy(*o);
+                else
+                    // The same file is listed multiple times, its copies need their own IDs.
+                    model.add_object(*o);
+        }
+    }
+    // The job options override both the server configuration and the configuration stored in the input files.
+    print_config.apply(job_config, true);
+    print_config.normalize_fdm();
+    std::string validity = print_config.validate();
+    if (! validity.empty())
+        return validity;
+
+    const ConfigOptionBool *opt_dont_arrange = job_config.opt<ConfigOptionBool>("dont_arrange");
+    if (opt_dont_arrange == nullptr || ! opt_dont_arrange->value)
+        arrange_objects(model, get_bed_shape(print_config), arrange_params(print_config));
+
+    const ConfigOptionString *opt_output = job_config.opt<ConfigOptionString>("output");
+    outfile = (opt_output == nullptr) ? std::string() : opt_output->value;
+    return CLI::export_print(fff_print, sla_print, model, print_config, printer_technology, outfile);
+}
+
+int CLI::run_server(PrinterTechnology printer_technology)
+{
+    using clock_type = std::chrono::steady_clock;
+    auto seconds_since = [](clock_type::time_point t) { return std::chrono::duration<double>(clock_type::now() - t).count(); };
+
+    const size_t            num_workers = num_concurrent_jobs(m_config);
+    share_threads_between_jobs(m_print_config, num_workers);
+    ServerModelCache        model_cache;
+    std::deque<std::pair<size_t, std::vector<std::string>>> queue;
+    std::mutex              queue_mutex;
+    std::condition_variable queue_condition;
+    bool                    input_finished = false;
+    std::mutex              output_mutex;
+    size_t                  num_succeeded  = 0;
+    size_t                  num_failed     = 0;
+    const clock_type::time_point server_start = clock_type::now();
+
+    auto worker = [&]() {
+        // Each worker keeps its print objects alive between the jobs, so that a job slicing the same objects
+        // as the previous one reuses the already generated data.
+        Print    fff_print;
+        SLAPrint sla_print;
+        fff_print.set_status_silent();
+        sla_print.set_status_silent();
+        for (;;) {
+            std::pair<size_t, std::vector<std::string>> job;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_condition.wait(lock, [&]() { return input_finished || ! queue.empty(); });
+                if (queue.empty())
+                    return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            // Wake up the reader waiting for a free slot in the queue.
+            queue_condition.notify_all();
+            const clock_type::time_point job_start = clock_type::now();
+            std::string outfile;
+            std::string error;
+            try {
+                error = run_server_job(job.second, m_print_config, printer_technology, model_cache, fff_print, sla_print, outfile);
+            } catch (const std::exception &ex) {
+                error = ex.what();
+            }
+            double seconds = seconds_since(job_start);
+            std::lock_guard<std::mutex> lock(output_mutex);
+            if (! error.empty()) {
+                ++ num_failed;
+                // The message is squeezed to a single line to keep the protocol line based.
+                std::replace(error.begin(), error.end(), '\n', ' ');
+                boost::nowide::cout << "error " << job.first << " " << seconds << " " << error << std::endl;
+            } else {
+                ++ num_succeeded;
+                if (outfile.empty())
+                    boost::nowide::cout << "empty " << job.first << " " << seconds << std::endl;
+                else
+                    boost::nowide::cout << "ok " << job.first << " " << seconds << " " << outfile << std::endl;
+            }
+        }
+    };
+
+    std::vector<boost::thread> workers;
+    for (size_t i = 0; i < num_workers; ++ i) {
+        workers.emplace_back(create_thread(worker));
+        set_thread_name(workers.back(), "slic3r_server_" + std::to_string(i));
+    }
+
+    // Read the jobs. At most num_workers jobs are waiting in the queue, the reader blocks until a worker picks one up.
+    std::string line;
+    size_t      job_id = 0;
+    while (std::getline(boost::nowide::cin, line)) {
+        std::vector<std::string> tokens = split_job_line(line);
+        if (tokens.empty() || boost::starts_with(tokens.front(), "#"))
+            continue;
+        if (tokens.size() == 1 && (tokens.front() == "quit" || tokens.front() == "exit"))
+            break;
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_condition.wait(lock, [&]() { return queue.size() < num_workers; });
+        queue.emplace_back(++ job_id, std::move(tokens));
+        lock.unlock();
+        queue_condition.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        input_finished = true;
+    }
+    queue_condition.notify_all();
+    for (boost::thread &thread : workers)
+        thread.join();
+
+    double seconds = seconds_since(server_start);
+    boost::nowide::cout << "finished " << num_succeeded << " " << num_failed << " " << seconds
+        << " (" << ((seconds > 0.) ? double(num_succeeded + num_failed) / seconds : 0.) << " jobs/s)" << std::endl;
+    return (num_failed == 0) ? 0 : 1;
+}
+
+// Rough estimate of the memory needed to slice a model, used to limit the number of --batch jobs running at the same time.
+// The meshes are copied into the print objects and the layers with their extrusions take a multiple of the mesh size.
+static size_t estimate_print_memory(const Model &model)
+{
+    size_t num_facets = 0;
+    for (const ModelObject *model_object : model.objects)
+        for (const ModelVolume *model_volume : model_object->volumes)
+            num_facets += model_volume->mesh().facets_count();
+    return (size_t(64) << 20) + num_facets * 1024;
+}
+
+int CLI::run_batch(PrinterTechnology printer_technology, const Points &bed, int dups, bool user_center_specified)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    const std::string output = m_config.opt_string("output");
+    if (! output.empty() && ! boost::filesystem::is_directory(output)) {
+        boost::nowide::cerr << "error: --output has to be an existing directory in the --batch mode" << std::endl;
+        return 1;
+    }
+    const Vec2d *center = user_center_specified ? &m_config.option<ConfigOptionPoint>("center")->value : nullptr;
+    const bool   arrange = ! m_config.opt_bool("dont_arrange");
+
+    // Each job runs in its own share of the TBB worker pool. A job is admitted only if its estimated memory fits into the budget
+    // together with the running jobs, a single job is always admitted to guarantee progress.
+    const size_t            num_workers   = std::min(num_concurrent_jobs(m_config), m_models.size());
+    share_threads_between_jobs(m_print_config, num_workers);
+    const size_t            memory_budget = total_physical_memory() / 2;
+    size_t                  memory_used   = 0;
+    size_t                  num_running   = 0;
+    size_t                  next_job      = 0;
+    size_t                  num_failed    = 0;
+    std::mutex              mutex;
+    std::condition_variable condition;
+    const clock_type::time_point batch_start = clock_type::now();
+
+    // The jobs run concurrently, thus jobs whose outputs would share a basename would overwrite each other's outputs.
+    // Such jobs get a numbered suffix of their input name, which names their output and log files.
+    std::vector<std::string> inputs;
+    std::vector<std::string> log_paths;
+    {
+        std::set<std::string> output_bases;
+        for (Model &model : m_models) {
+            boost::filesystem::path input(model.objects.front()->input_file);
+            boost::filesystem::path dir  = output.empty() ? input.parent_path() : boost::filesystem::path(output);
+            std::string             stem = input.stem().string();
+            std::string             name = stem;
+            for (size_t n = 2; ! output_bases.insert((dir / name).string()).second; ++ n)
+                name = stem + "_" + std::to_string(n);
+            inputs.emplace_back(input.string());
+            log_paths.emplace_back((dir / name).string() + ".log");
+            if (name != stem) {
+                std::string renamed = (input.parent_path() / (name + input.extension().string())).string();
+                for (ModelObject *model_object : model.objects)
+                    model_object->input_file = renamed;
+            }
+        }
+    }
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t job_idx;
+            size_t job_memory;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (next_job == m_models.size())
+                    return;
+                job_idx    = next_job ++;
+                job_memory = estimate_print_memory(m_models[job_idx]);
+                condition.wait(lock, [&]() { return num_running == 0 || memory_budget == 0 || memory_used + job_memory <= memory_budget; });
+                memory_used += job_memory;
+                ++ num_running;
+            }
+
+            Model             &model = m_models[job_idx];
+            const std::string &input = inputs[job_idx];
+            DynamicPrintConfig print_config = m_print_config;
+            std::string        outfile      = output;
+            std::string        log;
+            std::string        error;
+            const clock_type::time_point job_start = clock_type::now();
+            try {
+                Print    fff_print;
+                SLAPrint sla_print;
+                auto status_callback = [&log](const PrintBase::SlicingStatus &s) {
+                    if (s.percent >= 0 && s.args.empty())
+                        log += std::to_string(s.percent) + "% => " + s.main_text + "\n";
+                };
+                fff_print.set_status_callback(status_callback);
+                sla_print.set_status_callback(status_callback);
+                if (arrange)
+                    arrange_model(model, print_config, bed, dups, center);
+                error = export_print(fff_print, sla_print, model, print_config, printer_technology, outfile);
+            } catch (const std::exception &ex) {
+                error = ex.what();
+            }
+            double seconds = std::chrono::duration<double>(clock_type::now() - job_start).count();
+            // Release the meshes of the finished job.
+            model.clear_objects();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            memory_used -= job_memory;
+            -- num_running;
+            condition.notify_all();
+            std::string log_path = log_paths[job_idx];
+            if (! error.empty()) {
+                ++ num_failed;
+                boost::nowide::cerr << input << ": " << error << std::endl;
+                log += "Slicing of " + input + " failed after " + std::to_string(seconds) + " s: " + error + "\n";
+            } else if (outfile.empty()) {
+                boost::nowide::cout << "Nothing to print for " << input << " . Either the print is empty or no object is fully inside the print volume." << std::endl;
+                log += "Nothing to print\n";
+            } else {
+                boost::nowide::cout << "Slicing result of " << input << " exported to " << outfile << " in " << seconds << " s" << std::endl;
+                log += "Slicing result exported to " + outfile + " in " + std::to_string(seconds) + " s\n";
+                log_path = outfile + ".log";
+            }
+            boost::nowide::ofstream log_file(log_path);
+            log_file << log;
+        }
+    };
+
+    std::vector<boost::thread> workers;
+    for (size_t i = 0; i < num_workers; ++ i) {
+        workers.emplace_back(create_thread(worker));
+        set_thread_name(workers.back(), "slic3r_batch_" + std::to_string(i));
+    }
+    for (boost::thread &thread : workers)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(clock_type::now() - batch_start).count();
+    boost::nowide::cout << "Batch of " << m_models.size() << " files sliced in " << seconds << " s using " << num_workers << " jobs, "
+        << num_failed << " failed" << std::endl;
+    return (num_failed == 0) ? 0 : 1;
+}
+
 bool CLI::setup(int argc, char **argv)
 {
     {
@@ -6,6 +6,9 @@
 
 namespace Slic3r {
 
+class Print;
+class SLAPrint;
+
 namespace IO {
 	enum ExportFormat : int { 
         AMF, 
@@ -23,6 +26,12 @@ public:
 
     DynamicPrintConfig& full_print_config() { return m_print_config; }
 
+    /// Slices a model and exports the G-code or the SLA archive. The CLI state is not accessed, thus it may be called
+    /// from multiple threads, each with its own print objects. Returns an error message, or an empty string on success.
+    /// On success, outfile contains the path of the exported file, or it is empty if there was nothing to print.
+    static std::string export_print(Print &fff_print, SLAPrint &sla_print, Model &model, DynamicPrintConfig &print_config,
+                                    PrinterTechnology printer_technology, std::string &outfile);
+
 private:
     DynamicPrintAndCLIConfig    m_config;
     DynamicPrintConfig			m_print_config;
@@ -43,6 +52,12 @@ private:
     bool has_print_action() const { return m_config.opt_bool("export_gcode") || m_config.opt_bool("export_sla"); }
     
     std::string output_filepath(const Model &model, IO::ExportFormat format) const;
+
+    /// Runs the slicing service: jobs are read from stdin one per line, results are reported to stdout.
+    int run_server(PrinterTechnology printer_technology);
+
+    /// Slices each of the loaded models into its own output file, running multiple models concurrently.
+    int run_batch(PrinterTechnology printer_technology, const Points &bed, int dups, bool user_center_specified);
 };
 
 }
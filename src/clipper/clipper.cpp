@@ -742,11 +742,16 @@ TEdge* ClipperBase::ProcessBound(TEdge* E, bool NextIsForward)
 //------------------------------------------------------------------------------
 
 bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
+{
+  return AddPath(pg.data(), pg.data() + pg.size(), PolyTyp, Closed);
+}
+
+bool ClipperBase::AddPath(const IntPoint *pg, const IntPoint *pg_end, PolyType PolyTyp, bool Closed)
 {
   CLIPPERLIB_PROFILE_FUNC();
   // Remove duplicate end point from a closed input path.
   // Remove duplicate points from the end of the input path.
-  int highI = (int)pg.size() -1;
+  int highI = (int)(pg_end - pg) -1;
   if (Closed) 
     while (highI > 0 && (pg[highI] == pg[0])) 
       --highI;
@@ -756,7 +761,7 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
     return false;
 
   // Allocate a new edge array.
-  std::vector<TEdge> edges(highI + 1);
+  std::vector<TEdge> edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
   if (result)
@@ -789,13 +794,13 @@ bool ClipperBase::AddPaths(const Paths &ppg, PolyType PolyTyp, bool Closed)
     return false;
 
   // Allocate a new edge array.
-  std::vector<TEdge> edges(num_edges_total);
+  std::vector<TEdge> edges = AllocateEdges(num_edges_total);
   // Fill in the edge array.
   bool result = false;
   TEdge *p_edge = edges.data();
   for (Paths::size_type i = 0; i < ppg.size(); ++i)
     if (num_edges[i]) {
-      bool res = AddPathInternal(ppg[i], num_edges[i] - 1, PolyTyp, Closed, p_edge);
+      bool res = AddPathInternal(ppg[i].data(), num_edges[i] - 1, PolyTyp, Closed, p_edge);
       if (res) {
         p_edge += num_edges[i];
         result = true;
@@ -807,7 +812,7 @@ bool ClipperBase::AddPaths(const Paths &ppg, PolyType PolyTyp, bool Closed)
   return result;
 }
 
-bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges)
+bool ClipperBase::AddPathInternal(const IntPoint *pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges)
 {
   CLIPPERLIB_PROFILE_FUNC();
 #ifdef use_lines
@@ -818,7 +823,7 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
     throw clipperException("AddPath: Open paths have been disabled.");
 #endif
 
-  assert(highI >= 0 && highI < pg.size());
+  assert(highI >= 0);
 
   //1. Basic (first) edge initialization ...
   try
@@ -981,10 +986,44 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
 }
 //------------------------------------------------------------------------------
 
+// Upper bound of the number of edges kept by ClipperBase::Clear() for reuse, roughly 16MB on a 64bit system.
+static constexpr size_t max_edges_free_capacity = 128 * 1024;
+
+// Upper bound of the number of edges kept by ClipperBase::ShrinkPools() for an idle engine.
+static constexpr size_t max_edges_free_capacity_idle = 4 * 1024;
+
+void ClipperBase::ShrinkPools()
+{
+  while (m_edgesFreeCapacity > max_edges_free_capacity_idle && ! m_edgesFree.empty()) {
+    m_edgesFreeCapacity -= std::min(m_edgesFreeCapacity, m_edgesFree.back().capacity());
+    m_edgesFree.pop_back();
+  }
+}
+
+std::vector<TEdge> ClipperBase::AllocateEdges(size_t num_edges)
+{
+  std::vector<TEdge> edges;
+  if (! m_edgesFree.empty()) {
+    // Reuse the last released edge array. Its allocation is kept if it is large enough.
+    edges = std::move(m_edgesFree.back());
+    m_edgesFree.pop_back();
+    m_edgesFreeCapacity -= std::min(m_edgesFreeCapacity, edges.capacity());
+    edges.clear();
+  }
+  edges.resize(num_edges);
+  return edges;
+}
+
 void ClipperBase::Clear()
 {
   CLIPPERLIB_PROFILE_FUNC();
   m_MinimaList.clear();
+  // Keep the edge arrays for reuse, but don't keep too much memory allocated.
+  for (std::vector<TEdge> &edges : m_edges)
+    if (m_edgesFreeCapacity + edges.capacity() <= max_edges_free_capacity) {
+      m_edgesFreeCapacity += edges.capacity();
+      m_edgesFree.emplace_back(std::move(edges));
+    }
   m_edges.clear();
   m_UseFullRange = false;
   m_HasOpenPaths = false;
@@ -1067,6 +1106,7 @@ IntRect ClipperBase::GetBounds()
 
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
+  m_OutPtsChunksUsed(0),
   m_OutPtsFree(nullptr),
   m_OutPtsChunkSize(32),
   m_OutPtsChunkLast(32),
@@ -1209,27 +1249,67 @@ OutPt* Clipper::AllocateOutPt()
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
     // Get a point from the last chunk.
-    pt = m_OutPts.back() + (m_OutPtsChunkLast ++);
+    pt = m_OutPts[m_OutPtsChunksUsed - 1] + (m_OutPtsChunkLast ++);
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.push_back(new OutPt[m_OutPtsChunkSize]);
+    // The last chunk is full. Reuse a chunk released by DisposeAllOutRecs() or allocate a new one.
+    if (m_OutPtsChunksUsed == m_OutPts.size())
+      m_OutPts.push_back(new OutPt[m_OutPtsChunkSize]);
+    pt = m_OutPts[m_OutPtsChunksUsed ++];
     m_OutPtsChunkLast = 1;
-    pt = m_OutPts.back();
   }
   return pt;
 }
 
+// Upper bounds of the output points and output polygons kept by Clipper::DisposeAllOutRecs() for reuse.
+static constexpr size_t max_out_pts_chunks_free = 1024;
+static constexpr size_t max_poly_outs_free      = 4096;
+
 void Clipper::DisposeAllOutRecs()
 {
-  for (OutPt *pts : m_OutPts)
-    delete[] pts;
-  for (OutRec *rec : m_PolyOuts)
-    delete rec;
-  m_OutPts.clear();
+  // Keep the chunks of output points for reuse, but don't keep too much memory allocated.
+  for (size_t i = max_out_pts_chunks_free; i < m_OutPts.size(); ++ i)
+    delete[] m_OutPts[i];
+  if (m_OutPts.size() > max_out_pts_chunks_free)
+    m_OutPts.resize(max_out_pts_chunks_free);
+  m_OutPtsChunksUsed = 0;
   m_OutPtsFree = nullptr;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
+  for (OutRec *rec : m_PolyOuts)
+    if (m_PolyOutsFree.size() < max_poly_outs_free)
+      m_PolyOutsFree.push_back(rec);
+    else
+      delete rec;
   m_PolyOuts.clear();
 }
+
+// Upper bounds of the output points and output polygons kept by Clipper::ShrinkPools() for an idle engine.
+static constexpr size_t max_out_pts_chunks_idle = 32;
+static constexpr size_t max_poly_outs_idle      = 128;
+
+void Clipper::ShrinkPools()
+{
+  assert(m_PolyOuts.empty() && m_OutPtsChunksUsed == 0);
+  ClipperBase::ShrinkPools();
+  for (size_t i = max_out_pts_chunks_idle; i < m_OutPts.size(); ++ i)
+    delete[] m_OutPts[i];
+  if (m_OutPts.size() > max_out_pts_chunks_idle)
+    m_OutPts.resize(max_out_pts_chunks_idle);
+  for (size_t i = max_poly_outs_idle; i < m_PolyOutsFree.size(); ++ i)
+    delete m_PolyOutsFree[i];
+  if (m_PolyOutsFree.size() > max_poly_outs_idle)
+    m_PolyOutsFree.resize(max_poly_outs_idle);
+}
+
+void Clipper::FreeOutRecs()
+{
+  DisposeAllOutRecs();
+  for (OutPt *pts : m_OutPts)
+    delete[] pts;
+  m_OutPts.clear();
+  for (OutRec *rec : m_PolyOutsFree)
+    delete rec;
+  m_PolyOutsFree.clear();
+}
 //------------------------------------------------------------------------------
 
 void Clipper::SetWindingCount(TEdge &edge) const
@@ -2011,7 +2091,13 @@ void Clipper::AppendPolygon(TEdge *e1, TEdge *e2) const
 
 OutRec* Clipper::CreateOutRec()
 {
-  OutRec* result = new OutRec;
+  OutRec* result;
+  if (m_PolyOutsFree.empty())
+    result = new OutRec;
+  else {
+    result = m_PolyOutsFree.back();
+    m_PolyOutsFree.pop_back();
+  }
   result->IsHole = false;
   result->IsOpen = false;
   result->FirstLeft = 0;
@@ -3380,6 +3466,7 @@ void ClipperOffset::Clear()
     delete m_polyNodes.Childs[i];
   m_polyNodes.Childs.clear();
   m_lowest.X = -1;
+  m_clipper.Clear();
 }
 //------------------------------------------------------------------------------
 
@@ -3487,7 +3574,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3517,7 +3606,9 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
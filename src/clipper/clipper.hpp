@@ -293,15 +293,22 @@ public:
   ClipperBase() : m_UseFullRange(false), m_HasOpenPaths(false) {}
   ~ClipperBase() { Clear(); }
   bool AddPath(const Path &pg, PolyType PolyTyp, bool Closed);
+  // Add a path stored in a continuous array of points [begin, end) without copying it into a Path first.
+  bool AddPath(const IntPoint *begin, const IntPoint *end, PolyType PolyTyp, bool Closed);
   bool AddPaths(const Paths &ppg, PolyType PolyTyp, bool Closed);
+  // Clear the input paths. The edge arrays are kept in a pool to be reused by the following AddPath() / AddPaths() calls.
   void Clear();
+  // Release the pooled edge arrays above the small amount an idle engine keeps.
+  void ShrinkPools();
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
   // When enabled the PreserveCollinear property prevents this default behavior to allow these inner vertices to appear in the solution.
   bool PreserveCollinear() const {return m_PreserveCollinear;};
   void PreserveCollinear(bool value) {m_PreserveCollinear = value;};
 protected:
-  bool AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
+  bool AddPathInternal(const IntPoint *pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
+  // Get an edge array of num_edges value initialized edges, recycled from m_edgesFree if possible.
+  std::vector<TEdge> AllocateEdges(size_t num_edges);
   TEdge* AddBoundsToLML(TEdge *e, bool IsClosed);
   void Reset();
   TEdge* ProcessBound(TEdge* E, bool IsClockwise);
@@ -316,6 +323,10 @@ protected:
   bool              m_UseFullRange;
   // A vector of edges per each input path.
   std::vector<std::vector<TEdge>> m_edges;
+  // Edge arrays released by Clear(), their memory is reused by the following AddPath() / AddPaths() calls.
+  std::vector<std::vector<TEdge>> m_edgesFree;
+  // Number of edges allocated by m_edgesFree, to limit the memory kept by a long living ClipperBase.
+  size_t           m_edgesFreeCapacity = 0;
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -327,8 +338,11 @@ class Clipper : public ClipperBase
 {
 public:
   Clipper(int initOptions = 0);
-  ~Clipper() { Clear(); }
+  ~Clipper() { Clear(); FreeOutRecs(); }
+  // Clear the input paths and the output polygons. The memory of the output polygons is kept for the next Execute() call.
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
+  // Release the pooled memory above the small amount an idle engine keeps. To be called after Clear().
+  void ShrinkPools();
   bool Execute(ClipType clipType,
       Paths &solution,
       PolyFillType fillType = pftEvenOdd) 
@@ -360,8 +374,13 @@ private:
   
   // Output polygons.
   std::vector<OutRec*>  m_PolyOuts;
+  // Output polygons released by DisposeAllOutRecs(), to be reused by CreateOutRec().
+  std::vector<OutRec*>  m_PolyOutsFree;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
+  // The chunks are not released by DisposeAllOutRecs(), they are reused by the next Execute() call.
   std::vector<OutPt*>   m_OutPts;
+  // Number of chunks of m_OutPts in use, the rest of the chunks is free for reuse.
+  size_t                m_OutPtsChunksUsed;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkSize;
@@ -419,6 +438,8 @@ private:
   void DisposeOutPt(OutPt *pt) { pt->Next = m_OutPtsFree; m_OutPtsFree = pt; }
   void DisposeOutPts(OutPt*& pp) { if (pp != nullptr) { pp->Prev->Next = m_OutPtsFree; m_OutPtsFree = pp; } }
   void DisposeAllOutRecs();
+  // Release the memory of the output polygons and points kept for reuse.
+  void FreeOutRecs();
   bool ProcessIntersections(const cInt topY);
   void BuildIntersectList(const cInt topY);
   void ProcessEdgesAtTopOfScanbeam(const cInt topY);
@@ -453,6 +474,8 @@ public:
   void Execute(Paths& solution, double delta);
   void Execute(PolyTree& solution, double delta);
   void Clear();
+  // Release the pooled memory above the small amount an idle engine keeps. To be called after Clear().
+  void ShrinkPools() { m_clipper.ShrinkPools(); }
   double MiterLimit;
   double ArcTolerance;
   double ShortestEdgeLength;
@@ -465,6 +488,8 @@ private:
   double m_miterLim, m_StepsPerRad;
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Clipper to clean up the offsetted polygons, kept to reuse its memory by the next Execute() call.
+  Clipper  m_clipper;
 
   void FixOrientations();
   void DoOffset(double delta);
@@ -8,6 +8,8 @@
 #include <iterator>
 #include <future>
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 #ifndef NDEBUG
 #include <iostream>
@@ -75,6 +77,145 @@ inline void enumerate(
 
 namespace placers {
 
+/**
+ * @brief A cache of no-fit polygons keyed by the shapes of the stationary and
+ * the orbiting items.
+ *
+ * The nfp of a pair of items follows the translation of the stationary item
+ * and it does not depend on the translation of the orbiting item. The nfps
+ * are therefore stored relative to the stationary item's translation and they
+ * are reused for every pair of items with the same shapes, inflations and
+ * rotations, which is the common case when arranging copies of an object.
+ * The cache is keyed by fingerprints of the items, the shapes of the items are
+ * stored with each nfp and compared on a hit, thus a fingerprint collision
+ * results in a cache miss and not in a wrong nfp.
+ * The cache is thread safe and it may be shared by subsequent arrange calls.
+ */
+template<class RawShape>
+class NfpCache {
+public:
+    struct Key {
+        size_t stationary = 0;
+        size_t orbiter    = 0;
+
+        bool operator==(const Key &other) const
+        {
+            return stationary == other.stationary && orbiter == other.orbiter;
+        }
+    };
+
+    /// Fingerprint of the item's shape with its inflation and rotation.
+    static size_t fingerprint(const _Item<RawShape> &item)
+    {
+        size_t seed = 0;
+        auto combine = [&seed](size_t v) {
+            seed ^= v + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        };
+
+        for (auto it = item.cbegin(); it != item.cend(); ++it) {
+            combine(std::hash<TCoord<TPoint<RawShape>>>()(getX(*it)));
+            combine(std::hash<TCoord<TPoint<RawShape>>>()(getY(*it)));
+        }
+        combine(std::hash<TCoord<TPoint<RawShape>>>()(item.inflation()));
+        combine(std::hash<double>()(double(item.rotation())));
+
+        return seed;
+    }
+
+    /// Whether the two items have the same shape, inflation and rotation,
+    /// thus the same fingerprint and the same nfps with any other item.
+    static bool same_shape(const _Item<RawShape> &a, const _Item<RawShape> &b)
+    {
+        return ItemShape(a).matches(b);
+    }
+
+    /// Retrieve the nfp relative to the stationary item's translation.
+    bool find(const Key &key,
+              const _Item<RawShape> &stationary,
+              const _Item<RawShape> &orbiter,
+              RawShape &nfp) const
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto it = nfps_.find(key);
+        if (it == nfps_.end() || !it->second.stationary.matches(stationary) ||
+            !it->second.orbiter.matches(orbiter))
+            return false;
+        nfp = it->second.nfp;
+        return true;
+    }
+
+    void insert(const Key &key,
+                const _Item<RawShape> &stationary,
+                const _Item<RawShape> &orbiter,
+                RawShape &&nfp)
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        // Keep the memory bounded, the cache is refilled quickly anyway.
+        if (nfps_.size() >= max_size_) nfps_.clear();
+        // Replaces the nfp of a pair of items with colliding fingerprints.
+        nfps_[key] = Entry{ItemShape(stationary), ItemShape(orbiter), std::move(nfp)};
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return nfps_.size();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        nfps_.clear();
+    }
+
+private:
+    // The untranslated shape of an item with its inflation and rotation.
+    struct ItemShape {
+        RawShape shape;
+        TCoord<TPoint<RawShape>> inflation = 0;
+        double rotation = 0.;
+
+        ItemShape() = default;
+        explicit ItemShape(const _Item<RawShape> &item)
+            : shape(item.rawShape())
+            , inflation(item.inflation())
+            , rotation(double(item.rotation()))
+        {}
+
+        bool matches(const _Item<RawShape> &item) const
+        {
+            return inflation == item.inflation() &&
+                   rotation == double(item.rotation()) &&
+                   std::equal(sl::cbegin(shape), sl::cend(shape),
+                              item.cbegin(), item.cend(),
+                              [](const TPoint<RawShape> &p1,
+                                 const TPoint<RawShape> &p2) {
+                                  return getX(p1) == getX(p2) &&
+                                         getY(p1) == getY(p2);
+                              });
+        }
+    };
+
+    struct Entry {
+        ItemShape stationary;
+        ItemShape orbiter;
+        RawShape  nfp;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &k) const
+        {
+            return k.stationary ^ (k.orbiter + 0x9e3779b97f4a7c15ull +
+                                   (k.stationary << 6) + (k.stationary >> 2));
+        }
+    };
+
+    static const size_t max_size_ = 100000;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, Entry, KeyHash> nfps_;
+};
+
 template<class RawShape>
 struct NfpPConfig {
 
@@ -169,6 +310,13 @@ struct NfpPConfig {
 
     std::function<void(const ItemGroup &, NfpPConfig &config)> on_preload;
 
+    /**
+     * @brief An optional cache of the no-fit polygons. If the same cache is
+     * handed over to multiple arrange calls, the nfps of the already seen
+     * pairs of shapes are reused.
+     */
+    std::shared_ptr<NfpCache<RawShape>> nfp_cache;
+
     NfpPConfig(): rotations({0.0, Pi/2.0, Pi, 3*Pi/2}),
         alignment(Alignment::CENTER), starting_point(Alignment::CENTER) {}
 };
@@ -612,9 +760,33 @@ private:
         }
         // /////////////////////////////////////////////////////////////////////
 
-        __parallel::enumerate(items_.begin(), items_.end(),
-                              [&nfps, &trsh](const Item& sh, size_t n)
+        // Reuse the nfps of the already seen pairs of shapes. Only the
+        // missing ones are calculated.
+        NfpCache<RawShape> *cache = config_.nfp_cache.get();
+        std::vector<typename NfpCache<RawShape>::Key> keys;
+        std::vector<size_t> missing;
+        missing.reserve(items_.size());
+
+        if (cache) {
+            size_t orbiter_fp = NfpCache<RawShape>::fingerprint(trsh);
+            keys.reserve(items_.size());
+            for (size_t n = 0; n < items_.size(); ++n) {
+                const Item &sh = items_[n];
+                keys.push_back({NfpCache<RawShape>::fingerprint(sh), orbiter_fp});
+                if (cache->find(keys.back(), sh, trsh, nfps[n]))
+                    shapelike::translate(nfps[n], sh.translation());
+                else
+                    missing.emplace_back(n);
+            }
+        } else {
+            for (size_t n = 0; n < items_.size(); ++n) missing.emplace_back(n);
+        }
+
+        auto &items = items_;
+        __parallel::enumerate(missing.begin(), missing.end(),
+                              [&nfps, &trsh, &items](size_t n, size_t)
         {
+            const Item& sh = items[n];
             auto& fixedp = sh.transformedShape();
             auto& orbp = trsh.transformedShape();
             auto subnfp_r = noFitPolygon<NfpLevel::CONVEX_ONLY>(fixedp, orbp);
@@ -622,6 +794,13 @@ private:
             nfps[n] = subnfp_r.first;
         });
 
+        if (cache)
+            for (size_t n : missing) {
+                RawShape nfp = nfps[n];
+                shapelike::translate(nfp, -items_[n].get().translation());
+                cache->insert(keys[n], items_[n], trsh, std::move(nfp));
+            }
+
         return nfp::merge(nfps);
     }
 
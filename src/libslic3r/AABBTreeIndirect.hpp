@@ -7,10 +7,14 @@
 #define slic3r_AABBTreeIndirect_hpp_
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <numeric>
 #include <type_traits>
 #include <vector>
 
+#include <tbb/parallel_for.h>
+
 #include "Utils.hpp" // for next_highest_power_of_2()
 
 extern "C"
@@ -551,6 +555,33 @@ namespace detail {
 		return up_sqr_d;
 	}
 
+	// Spread the lower 21 bits of x so that there are two zero bits between each of them.
+	inline uint64_t morton_spread_bits(uint64_t x)
+	{
+		x &= 0x1fffff;
+		x = (x | x << 32) & 0x1f00000000ffffull;
+		x = (x | x << 16) & 0x1f0000ff0000ffull;
+		x = (x | x << 8)  & 0x100f00f00f00f00full;
+		x = (x | x << 4)  & 0x10c30c30c30c30c3ull;
+		x = (x | x << 2)  & 0x1249249249249249ull;
+		return x;
+	}
+
+	// Morton code of a point inside a bounding box, used to order queries so that
+	// consecutive queries traverse the same branches of the tree.
+	template<typename BoundingBox, typename VectorType>
+	inline uint64_t morton_code(const BoundingBox &bbox, const VectorType &pt)
+	{
+		static constexpr double cells = double(1 << 21) - 1.;
+		uint64_t code = 0;
+		for (int dim = 0; dim < 3; ++ dim) {
+			double size = double(bbox.max()(dim) - bbox.min()(dim));
+			double t    = size > 0. ? (double(pt(dim)) - double(bbox.min()(dim))) / size : 0.;
+			code |= morton_spread_bits(uint64_t(std::clamp(t, 0., 1.) * cells)) << dim;
+		}
+		return code;
+	}
+
 } // namespace detail
 
 // Build a balanced AABB Tree over an indexed triangles set, balancing the tree
@@ -692,6 +723,72 @@ inline typename VectorType::Scalar squared_distance_to_indexed_triangle_set(
     	detail::squared_distance_to_indexed_triangle_set_recursive(distancer, size_t(0), Scalar(0), std::numeric_limits<Scalar>::infinity(), hit_idx_out, hit_point_out);
 }
 
+// Batched squared_distance_to_indexed_triangle_set() for many query points.
+// The points are sorted along a Morton curve and processed in parallel chunks of neighboring points.
+// The closest triangle of the previous point of a chunk bounds the search for the next point,
+// which prunes most of the tree traversal when the queries are dense.
+// The outputs are indexed the same as the input points, distances are -1 if the input is empty.
+template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline void squared_distances_to_indexed_triangle_set(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Points to which the closest points on the indexed triangle set are searched for.
+	const std::vector<VectorType>		&points,
+	// Squared distances to the closest points.
+	std::vector<typename VectorType::Scalar> &squared_distances_out,
+	// Indices of the closest triangles in faces.
+	std::vector<size_t> 				&hit_idxs_out,
+	// Positions of the closest points on the indexed triangle set.
+	std::vector<VectorType>				&hit_points_out)
+{
+    using Scalar = typename VectorType::Scalar;
+    squared_distances_out.assign(points.size(), Scalar(-1));
+    hit_idxs_out.assign(points.size(), 0);
+    hit_points_out.assign(points.size(), VectorType::Zero());
+    if (tree.empty() || points.empty())
+        return;
+
+    std::vector<std::pair<uint64_t, size_t>> order(points.size());
+    const auto &root_bbox = tree.node(0).bbox;
+    for (size_t i = 0; i < points.size(); ++ i)
+        order[i] = { detail::morton_code(root_bbox, points[i]), i };
+    std::sort(order.begin(), order.end());
+
+    static constexpr size_t chunk_size = 256;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, order.size(), chunk_size),
+        [&](const tbb::blocked_range<size_t> &range) {
+        size_t hint_idx = size_t(-1);
+        for (size_t k = range.begin(); k < range.end(); ++ k) {
+            size_t             pt_idx    = order[k].second;
+            const VectorType  &point     = points[pt_idx];
+            auto               distancer = detail::IndexedTriangleSetDistancer<VertexType, IndexedFaceType, TreeType, VectorType>
+                { vertices, faces, tree, point };
+            size_t             hit_idx   = 0;
+            VectorType         hit_point = VectorType::Zero();
+            Scalar             up_sqr_d  = std::numeric_limits<Scalar>::infinity();
+            if (hint_idx != size_t(-1)) {
+                // The closest triangle of the previous point gives an upper bound of the distance.
+                const auto &triangle = faces[hint_idx];
+                hit_point = detail::closest_point_to_triangle<VectorType>(point,
+                    vertices[triangle(0)].template cast<Scalar>(),
+                    vertices[triangle(1)].template cast<Scalar>(),
+                    vertices[triangle(2)].template cast<Scalar>());
+                hit_idx  = hint_idx;
+                up_sqr_d = (hit_point - point).squaredNorm();
+            }
+            squared_distances_out[pt_idx] =
+                detail::squared_distance_to_indexed_triangle_set_recursive(distancer, size_t(0), Scalar(0), up_sqr_d, hit_idx, hit_point);
+            hit_idxs_out[pt_idx]   = hit_idx;
+            hit_points_out[pt_idx] = hit_point;
+            hint_idx = hit_idx;
+        }
+    });
+}
+
 // Decides if exists some triangle in defined radius on a 3D indexed triangle set using a pre-built AABBTreeIndirect::Tree.
 // Closest point to triangle test will be performed with the accuracy of VectorType::Scalar
 // even if the triangle mesh and the AABB Tree are built with floats.
@@ -207,6 +207,9 @@ void AppConfig::set_defaults()
     if (get("seq_top_layer_only").empty())
         set("seq_top_layer_only", "1");
 
+    if (get("gcode_preview_quantized").empty())
+        set("gcode_preview_quantized", "1");
+
     if (get("use_perspective_camera").empty())
         set("use_perspective_camera", "1");
 
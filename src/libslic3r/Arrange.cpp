@@ -81,6 +81,12 @@ using ItemGroup = std::vector<std::reference_wrapper<Item>>;
 // A coefficient used in separating bigger items and smaller items.
 const double BIG_ITEM_TRESHOLD = 0.02;
 
+// Minimum number of identical items to be arranged into a lattice instead of
+// running the nfp placer.
+const size_t LATTICE_MIN_ITEMS = 20;
+
+using NfpCache = placers::NfpCache<clppr::Polygon>;
+
 // Fill in the placer algorithm configuration with values carefully chosen for
 // Slic3r.
 template<class PConf>
@@ -105,6 +111,10 @@ void fill_config(PConf& pcfg, const ArrangeParams &params) {
     
     // Allow parallel execution.
     pcfg.parallel = params.parallel;
+
+    // The nfps are cached for the duration of a single arrange call, where
+    // the copies of an object share the nfps with their neighbors.
+    pcfg.nfp_cache = std::make_shared<NfpCache>();
 }
 
 // Apply penalty to object function result. This is used only when alignment
@@ -474,6 +484,87 @@ template<class S> Radians min_area_boundingbox_rotation(const S &sh)
         .angleToX();
 }
 
+// Only the rectangular beds are filled with a lattice.
+template<class BinT>
+bool arrange_lattice(std::vector<Item> &, const BinT &, const ArrangeParams &)
+{
+    return false;
+}
+
+// Fast path for a set of identical items on an empty rectangular bed: the
+// bounding boxes of the items are stacked into a grid centered in the bed,
+// as the nfp placer centers the pile if there is nothing on the bed.
+// Returns false if the items are not eligible, the nfp placer is used then.
+static bool arrange_lattice(std::vector<Item> &items, const Box &bin, const ArrangeParams &params)
+{
+    if (items.size() < LATTICE_MIN_ITEMS)
+        return false;
+
+    for (const Item &itm : items)
+        if (! NfpCache::same_shape(itm, items.front()))
+            return false;
+
+    Box  ibb = items.front().boundingBox();
+    auto w   = ibb.width();
+    auto h   = ibb.height();
+    if (w <= 0 || h <= 0)
+        return false;
+
+    // No more columns or rows than items, the bin may be infinite.
+    size_t cols = size_t(std::min(bin.width() / w, decltype(w)(items.size())));
+    size_t rows = size_t(std::min(bin.height() / h, decltype(h)(items.size())));
+    size_t capacity = cols * rows;
+    if (capacity == 0)
+        return false;
+
+    // Place the items with higher priority first, like the first fit selection does.
+    std::vector<size_t> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&items](size_t l, size_t r) {
+        return items[l].priority() > items[r].priority();
+    });
+
+    auto center = bin.center();
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (params.stopcondition && params.stopcondition())
+            break;
+
+        size_t bed_idx = i / capacity;
+        size_t idx     = i % capacity;
+        size_t n       = std::min(capacity, order.size() - bed_idx * capacity);
+
+        // Choose a grid close to a square for the items on this bed.
+        size_t c = size_t(std::ceil(std::sqrt(double(n) * h / w)));
+        c = std::max(size_t(1), std::min(c, cols));
+        size_t r = (n + c - 1) / c;
+        if (r > rows) {
+            r = rows;
+            c = (n + r - 1) / r;
+        }
+
+        clppr::IntPoint origin{getX(center) - clppr::cInt(c) * w / 2,
+                               getY(center) - clppr::cInt(r) * h / 2};
+        clppr::IntPoint target{origin.X + clppr::cInt(idx % c) * w,
+                               origin.Y + clppr::cInt(idx / c) * h};
+
+        Item &itm = items[order[i]];
+        itm.translate(target - itm.boundingBox().minCorner());
+        itm.binId(int(bed_idx));
+
+        if (params.progressind)
+            params.progressind(unsigned(order.size() - i - 1));
+
+        if (params.on_packed) {
+            ArrangePolygon ap;
+            ap.bed_idx  = itm.binId();
+            ap.priority = itm.priority();
+            params.on_packed(ap);
+        }
+    }
+
+    return true;
+}
+
 template<class BinT> // Arrange for arbitrary bin type
 void _arrange(
         std::vector<Item> &           shapes,
@@ -515,6 +606,12 @@ void _arrange(
         for (auto &itm : shapes)
             itm.rotation(min_area_boundingbox_rotation(itm.rawShape()));
 
+    // Copies of a single object on an empty bed don't need the nfp placer.
+    if (excludes.empty() && arrange_lattice(shapes, corrected_bin, params)) {
+        for (Item &itm : shapes) itm.inflate(-infl);
+        return;
+    }
+
     arranger(inp.begin(), inp.end());
     for (Item &itm : inp) itm.inflate(-infl);
 }
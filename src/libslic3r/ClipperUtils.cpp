@@ -2,6 +2,8 @@
 #include "Geometry.hpp"
 #include "ShortestPath.hpp"
 
+#include <memory>
+
 // #define CLIPPER_UTILS_DEBUG
 
 #ifdef CLIPPER_UTILS_DEBUG
@@ -159,16 +161,112 @@ Slic3r::Polylines ClipperPaths_to_Slic3rPolylines(const ClipperLib::Paths &input
     return retval;
 }
 
+// Clipper engines are reused by the Clipper operations of a single thread, so that the memory pools of the engines
+// (edges, output polygons and output points) stay allocated from one Clipper operation to the other.
+// A Clipper operation may call another Clipper operation while holding an engine, therefore the engines are leased
+// from a per thread stack of idle engines and returned there cleared once the lease goes out of scope.
+// An idle engine keeps just a small part of its pools and only a few engines are kept per thread,
+// so that the worker threads don't hold on to the memory of their largest Clipper operations.
+template<typename TEngine>
+class ClipperEngineLease
+{
+public:
+    ClipperEngineLease() {
+        std::vector<std::unique_ptr<TEngine>> &idle = idle_engines();
+        if (idle.empty())
+            m_engine = std::make_unique<TEngine>();
+        else {
+            m_engine = std::move(idle.back());
+            idle.pop_back();
+        }
+    }
+    ~ClipperEngineLease() {
+        std::vector<std::unique_ptr<TEngine>> &idle = idle_engines();
+        if (idle.size() < max_idle_engines) {
+            reset(*m_engine);
+            m_engine->ShrinkPools();
+            idle.emplace_back(std::move(m_engine));
+        }
+    }
+    ClipperEngineLease(const ClipperEngineLease &) = delete;
+    ClipperEngineLease& operator=(const ClipperEngineLease &) = delete;
+
+    TEngine& operator*() { return *m_engine; }
+    TEngine* operator->() { return m_engine.get(); }
+
+private:
+    // Deeper nesting of Clipper operations is rare, such engines are released.
+    static constexpr size_t max_idle_engines = 4;
+
+    static std::vector<std::unique_ptr<TEngine>>& idle_engines() {
+        static thread_local std::vector<std::unique_ptr<TEngine>> engines;
+        return engines;
+    }
+    // Clear the engine and set its parameters back to the defaults of a newly constructed engine.
+    static void reset(ClipperLib::Clipper &clipper) {
+        clipper.Clear();
+        clipper.PreserveCollinear(false);
+        clipper.ReverseSolution(false);
+        clipper.StrictlySimple(false);
+    }
+    static void reset(ClipperLib::ClipperOffset &co) {
+        co.Clear();
+        co.MiterLimit         = 2.;
+        co.ArcTolerance       = 0.25;
+        co.ShortestEdgeLength = 0.;
+    }
+
+    std::unique_ptr<TEngine> m_engine;
+};
+
+using ClipperLease       = ClipperEngineLease<ClipperLib::Clipper>;
+using ClipperOffsetLease = ClipperEngineLease<ClipperLib::ClipperOffset>;
+
+// Feed the Slic3r paths to Clipper one by one through a reused conversion buffer,
+// instead of converting all of them into a newly allocated ClipperLib::Paths first.
+static void clipper_add_path(ClipperLib::Clipper &clipper, const Points &points, ClipperLib::PolyType type, bool closed)
+{
+    static thread_local ClipperLib::Path path;
+    path.clear();
+    path.reserve(points.size());
+    for (const Point &pt : points)
+        path.emplace_back(pt.x(), pt.y());
+    clipper.AddPath(path.data(), path.data() + path.size(), type, closed);
+    if (path.capacity() > 64 * 1024)
+        // Don't keep the buffer of an exceptionally long path allocated.
+        ClipperLib::Path().swap(path);
+}
+
+static void clipper_add_paths(ClipperLib::Clipper &clipper, const Polygons &polygons, ClipperLib::PolyType type, bool closed)
+{
+    for (const Polygon &polygon : polygons)
+        clipper_add_path(clipper, polygon.points, type, closed);
+}
+
+static void clipper_add_paths(ClipperLib::Clipper &clipper, const ExPolygons &expolygons, ClipperLib::PolyType type, bool closed)
+{
+    for (const ExPolygon &expolygon : expolygons) {
+        clipper_add_path(clipper, expolygon.contour.points, type, closed);
+        for (const Polygon &hole : expolygon.holes)
+            clipper_add_path(clipper, hole.points, type, closed);
+    }
+}
+
+static void clipper_add_paths(ClipperLib::Clipper &clipper, const Polylines &polylines, ClipperLib::PolyType type, bool closed)
+{
+    for (const Polyline &polyline : polylines)
+        clipper_add_path(clipper, polyline.points, type, closed);
+}
+
 ExPolygons ClipperPaths_to_Slic3rExPolygons(const ClipperLib::Paths &input)
 {
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperLease clipper;
     
     // perform union
-    clipper.AddPaths(input, ClipperLib::ptSubject, true);
+    clipper->AddPaths(input, ClipperLib::ptSubject, true);
     ClipperLib::PolyTree polytree;
-    clipper.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);  // offset results work with both EvenOdd and NonZero
+    clipper->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);  // offset results work with both EvenOdd and NonZero
     
     // write to ExPolygons object
     return PolyTreeToExPolygons(polytree);
@@ -226,16 +324,16 @@ ClipperLib::Paths _offset(ClipperLib::Paths &&input, ClipperLib::EndType endType
     scaleClipperPolygons(input);
     
     // perform offset
-    ClipperLib::ClipperOffset co;
+    ClipperOffsetLease co;
     if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     else
-        co.MiterLimit = miterLimit;
+        co->MiterLimit = miterLimit;
     double delta_scaled = delta * float(CLIPPER_OFFSET_SCALE);
-    co.ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-    co.AddPaths(input, joinType, endType);
+    co->ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+    co->AddPaths(input, joinType, endType);
     ClipperLib::Paths retval;
-    co.Execute(retval, delta_scaled);
+    co->Execute(retval, delta_scaled);
     
     // unscale output
     unscaleClipperPolygons(retval);
@@ -262,14 +360,14 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygon &expolygon, const double delta
     {
         ClipperLib::Path input = Slic3rMultiPoint_to_ClipperPath(expolygon.contour);
         scaleClipperPolygon(input);
-        ClipperLib::ClipperOffset co;
+        ClipperOffsetLease co;
         if (joinType == jtRound)
-            co.ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
+            co->ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
         else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-        co.AddPath(input, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta_scaled);
+            co->MiterLimit = miterLimit;
+        co->ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+        co->AddPath(input, joinType, ClipperLib::etClosedPolygon);
+        co->Execute(contours, delta_scaled);
     }
 
     // 2) Offset the holes one by one, collect the results.
@@ -279,15 +377,15 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygon &expolygon, const double delta
         for (Polygons::const_iterator it_hole = expolygon.holes.begin(); it_hole != expolygon.holes.end(); ++ it_hole) {
             ClipperLib::Path input = Slic3rMultiPoint_to_ClipperPath_reversed(*it_hole);
             scaleClipperPolygon(input);
-            ClipperLib::ClipperOffset co;
+            ClipperOffsetLease co;
             if (joinType == jtRound)
-                co.ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
+                co->ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
             else
-                co.MiterLimit = miterLimit;
-            co.ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-            co.AddPath(input, joinType, ClipperLib::etClosedPolygon);
+                co->MiterLimit = miterLimit;
+            co->ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+            co->AddPath(input, joinType, ClipperLib::etClosedPolygon);
             ClipperLib::Paths out;
-            co.Execute(out, - delta_scaled);
+            co->Execute(out, - delta_scaled);
             holes.insert(holes.end(), out.begin(), out.end());
         }
     }
@@ -297,11 +395,10 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygon &expolygon, const double delta
     if (holes.empty()) {
         output = std::move(contours);
     } else {
-        ClipperLib::Clipper clipper;
-        clipper.Clear();
-        clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-        clipper.AddPaths(holes, ClipperLib::ptClip, true);
-        clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        ClipperLease clipper;
+        clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+        clipper->AddPaths(holes, ClipperLib::ptClip, true);
+        clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     }
     
     // 4) Unscale the output.
@@ -328,14 +425,14 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygons &expolygons, const double del
         {
             ClipperLib::Path input = Slic3rMultiPoint_to_ClipperPath(it_expoly->contour);
             scaleClipperPolygon(input);
-            ClipperLib::ClipperOffset co;
+            ClipperOffsetLease co;
             if (joinType == jtRound)
-                co.ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
+                co->ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
             else
-                co.MiterLimit = miterLimit;
-            co.ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-            co.AddPath(input, joinType, ClipperLib::etClosedPolygon);
-            co.Execute(contours, delta_scaled);
+                co->MiterLimit = miterLimit;
+            co->ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+            co->AddPath(input, joinType, ClipperLib::etClosedPolygon);
+            co->Execute(contours, delta_scaled);
         }
         if (contours.empty())
             // No need to try to offset the holes.
@@ -352,15 +449,15 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygons &expolygons, const double del
                 for (Polygons::const_iterator it_hole = it_expoly->holes.begin(); it_hole != it_expoly->holes.end(); ++ it_hole) {
                     ClipperLib::Path input = Slic3rMultiPoint_to_ClipperPath_reversed(*it_hole);
                     scaleClipperPolygon(input);
-                    ClipperLib::ClipperOffset co;
+                    ClipperOffsetLease co;
                     if (joinType == jtRound)
-                        co.ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
+                        co->ArcTolerance = miterLimit * double(CLIPPER_OFFSET_SCALE);
                     else
-                        co.MiterLimit = miterLimit;
-                    co.ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-                    co.AddPath(input, joinType, ClipperLib::etClosedPolygon);
+                        co->MiterLimit = miterLimit;
+                    co->ShortestEdgeLength = double(std::abs(delta_scaled * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+                    co->AddPath(input, joinType, ClipperLib::etClosedPolygon);
                     ClipperLib::Paths out;
-                    co.Execute(out, - delta_scaled);
+                    co->Execute(out, - delta_scaled);
                     holes.insert(holes.end(), out.begin(), out.end());
                 }
             }
@@ -373,12 +470,11 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygons &expolygons, const double del
             } else if (delta < 0) {
                 // Negative offset. There is a chance, that the offsetted hole intersects the outer contour. 
                 // Subtract the offsetted holes from the offsetted contours.
-                ClipperLib::Clipper clipper;
-                clipper.Clear();
-                clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-                clipper.AddPaths(holes, ClipperLib::ptClip, true);
+                ClipperLease clipper;
+                clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+                clipper->AddPaths(holes, ClipperLib::ptClip, true);
                 ClipperLib::Paths output;
-                clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+                clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
                 if (! output.empty()) {
                     contours_cummulative.insert(contours_cummulative.end(), output.begin(), output.end());
                     ++ expolygons_collected;
@@ -404,10 +500,9 @@ ClipperLib::Paths _offset(const Slic3r::ExPolygons &expolygons, const double del
     ClipperLib::Paths output;
     if (expolygons_collected > 1 && delta > 0) {
         // There is a chance that the outwards offsetted expolygons may intersect. Perform a union.
-        ClipperLib::Clipper clipper;
-        clipper.Clear(); 
-        clipper.AddPaths(contours_cummulative, ClipperLib::ptSubject, true);
-        clipper.Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        ClipperLease clipper;
+        clipper->AddPaths(contours_cummulative, ClipperLib::ptSubject, true);
+        clipper->Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     } else {
         // Negative offset. The shrunk expolygons shall not mutually intersect. Just copy the output.
         output = std::move(contours_cummulative);
@@ -429,26 +524,26 @@ _offset2(const Polygons &polygons, const double delta1, const double delta2,
     scaleClipperPolygons(input);
     
     // prepare ClipperOffset object
-    ClipperLib::ClipperOffset co;
+    ClipperOffsetLease co;
     if (joinType == jtRound) {
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     } else {
-        co.MiterLimit = miterLimit;
+        co->MiterLimit = miterLimit;
     }
     double delta_scaled1 = delta1 * float(CLIPPER_OFFSET_SCALE);
     double delta_scaled2 = delta2 * float(CLIPPER_OFFSET_SCALE);
-    co.ShortestEdgeLength = double(std::max(std::abs(delta_scaled1), std::abs(delta_scaled2)) * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR);
+    co->ShortestEdgeLength = double(std::max(std::abs(delta_scaled1), std::abs(delta_scaled2)) * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR);
     
     // perform first offset
     ClipperLib::Paths output1;
-    co.AddPaths(input, joinType, ClipperLib::etClosedPolygon);
-    co.Execute(output1, delta_scaled1);
+    co->AddPaths(input, joinType, ClipperLib::etClosedPolygon);
+    co->Execute(output1, delta_scaled1);
     
     // perform second offset
-    co.Clear();
-    co.AddPaths(output1, joinType, ClipperLib::etClosedPolygon);
+    co->Clear();
+    co->AddPaths(output1, joinType, ClipperLib::etClosedPolygon);
     ClipperLib::Paths retval;
-    co.Execute(retval, delta_scaled2);
+    co->Execute(retval, delta_scaled2);
     
     // unscale output
     unscaleClipperPolygons(retval);
@@ -497,30 +592,33 @@ T _clipper_do(const ClipperLib::ClipType     clipType,
               const ClipperLib::PolyFillType fillType,
               const bool                     safety_offset_)
 {
-    // read input
-    ClipperLib::Paths input_subject = Slic3rMultiPoints_to_ClipperPaths(std::forward<TSubj>(subject));
-    ClipperLib::Paths input_clip    = Slic3rMultiPoints_to_ClipperPaths(std::forward<TClip>(clip));
+    // init Clipper
+    ClipperLease clipper;
     
-    // perform safety offset
     if (safety_offset_) {
+        // read input
+        ClipperLib::Paths input_subject = Slic3rMultiPoints_to_ClipperPaths(std::forward<TSubj>(subject));
+        ClipperLib::Paths input_clip    = Slic3rMultiPoints_to_ClipperPaths(std::forward<TClip>(clip));
+        
+        // perform safety offset
         if (clipType == ClipperLib::ctUnion) {
             safety_offset(&input_subject);
         } else {
             safety_offset(&input_clip);
         }
+        
+        // add polygons
+        clipper->AddPaths(input_subject, ClipperLib::ptSubject, true);
+        clipper->AddPaths(input_clip,    ClipperLib::ptClip,    true);
+    } else {
+        // add polygons, they don't need to be modified, thus they don't need to be converted to ClipperLib::Paths
+        clipper_add_paths(*clipper, subject, ClipperLib::ptSubject, true);
+        clipper_add_paths(*clipper, clip,    ClipperLib::ptClip,    true);
     }
     
-    // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
-    
-    // add polygons
-    clipper.AddPaths(input_subject, ClipperLib::ptSubject, true);
-    clipper.AddPaths(input_clip,    ClipperLib::ptClip,    true);
-    
     // perform operation
     T retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -550,26 +648,31 @@ bool test_path(const ClipperLib::Path &path) {
 inline ClipperLib::PolyTree _clipper_do_polytree2(const ClipperLib::ClipType clipType, const Polygons &subject, 
     const Polygons &clip, const ClipperLib::PolyFillType fillType, const bool safety_offset_)
 {
-    // read input
-    ClipperLib::Paths input_subject = Slic3rMultiPoints_to_ClipperPaths(subject);
-    ClipperLib::Paths input_clip    = Slic3rMultiPoints_to_ClipperPaths(clip);
-    
-    // perform safety offset
-    if (safety_offset_)
+    ClipperLease clipper;
+    ClipperLib::Paths input_subject;
+    if (safety_offset_) {
+        // read input
+        input_subject                = Slic3rMultiPoints_to_ClipperPaths(subject);
+        ClipperLib::Paths input_clip = Slic3rMultiPoints_to_ClipperPaths(clip);
+        
+        // perform safety offset
         safety_offset((clipType == ClipperLib::ctUnion) ? &input_subject : &input_clip);
-    
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(input_subject, ClipperLib::ptSubject, true);
-    clipper.AddPaths(input_clip,    ClipperLib::ptClip,    true);
+        
+        clipper->AddPaths(input_subject, ClipperLib::ptSubject, true);
+        clipper->AddPaths(input_clip,    ClipperLib::ptClip,    true);
+    } else {
+        clipper_add_paths(*clipper, subject, ClipperLib::ptSubject, true);
+        clipper_add_paths(*clipper, clip,    ClipperLib::ptClip,    true);
+    }
     // Perform the operation with the output to input_subject.
     // This pass does not generate a PolyTree, which is a very expensive operation with the current Clipper library
     // if there are overapping edges.
-    clipper.Execute(clipType, input_subject, fillType, fillType);
+    clipper->Execute(clipType, input_subject, fillType, fillType);
     // Perform an additional Union operation to generate the PolyTree ordering.
-    clipper.Clear();
-    clipper.AddPaths(input_subject, ClipperLib::ptSubject, true);
+    clipper->Clear();
+    clipper->AddPaths(input_subject, ClipperLib::ptSubject, true);
     ClipperLib::PolyTree retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
 
     // if safety_offset_, remove too small polygons & holes
     if (safety_offset_)
@@ -595,24 +698,22 @@ ClipperLib::PolyTree _clipper_do_pl(const ClipperLib::ClipType clipType, const P
     const Polygons &clip, const ClipperLib::PolyFillType fillType,
     const bool safety_offset_)
 {
-    // read input
-    ClipperLib::Paths input_subject = Slic3rMultiPoints_to_ClipperPaths(subject);
-    ClipperLib::Paths input_clip    = Slic3rMultiPoints_to_ClipperPaths(clip);
-    
-    // perform safety offset
-    if (safety_offset_) safety_offset(&input_clip);
-    
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperLease clipper;
     
     // add polygons
-    clipper.AddPaths(input_subject, ClipperLib::ptSubject, false);
-    clipper.AddPaths(input_clip,    ClipperLib::ptClip,    true);
+    clipper_add_paths(*clipper, subject, ClipperLib::ptSubject, false);
+    if (safety_offset_) {
+        // perform safety offset
+        ClipperLib::Paths input_clip = Slic3rMultiPoints_to_ClipperPaths(clip);
+        safety_offset(&input_clip);
+        clipper->AddPaths(input_clip, ClipperLib::ptClip, true);
+    } else
+        clipper_add_paths(*clipper, clip, ClipperLib::ptClip, true);
     
     // perform operation
     ClipperLib::PolyTree retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -827,7 +928,7 @@ void safety_offset(ClipperLib::Paths* paths)
     scaleClipperPolygons(*paths);
     
     // perform offset (delta = scale 1e-05)
-    ClipperLib::ClipperOffset co;
+    ClipperOffsetLease co;
 #ifdef CLIPPER_UTILS_DEBUG
     if (clipper_export_enabled) {
         static int iRun = 0;
@@ -837,20 +938,20 @@ void safety_offset(ClipperLib::Paths* paths)
     ClipperLib::Paths out;
     for (size_t i = 0; i < paths->size(); ++ i) {
         ClipperLib::Path &path = (*paths)[i];
-        co.Clear();
-        co.MiterLimit = 2;
+        co->Clear();
+        co->MiterLimit = 2;
         bool ccw = ClipperLib::Orientation(path);
         if (! ccw)
             std::reverse(path.begin(), path.end());
         {
             CLIPPERUTILS_PROFILE_BLOCK(safety_offset_AddPaths);
-            co.AddPath((*paths)[i], ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
+            co->AddPath((*paths)[i], ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
         }
         {
             CLIPPERUTILS_PROFILE_BLOCK(safety_offset_Execute);
             // offset outside by 10um
             ClipperLib::Paths out_this;
-            co.Execute(out_this, ccw ? 10.f * float(CLIPPER_OFFSET_SCALE) : -10.f * float(CLIPPER_OFFSET_SCALE));
+            co->Execute(out_this, ccw ? 10.f * float(CLIPPER_OFFSET_SCALE) : -10.f * float(CLIPPER_OFFSET_SCALE));
             if (! ccw) {
                 // Reverse the resulting contours once again.
                 for (ClipperLib::Paths::iterator it = out_this.begin(); it != out_this.end(); ++ it)
@@ -871,12 +972,11 @@ void safety_offset(ClipperLib::Paths* paths)
 Polygons top_level_islands(const Slic3r::Polygons &polygons)
 {
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperLease clipper;
     // perform union
-    clipper.AddPaths(Slic3rMultiPoints_to_ClipperPaths(polygons), ClipperLib::ptSubject, true);
+    clipper_add_paths(*clipper, polygons, ClipperLib::ptSubject, true);
     ClipperLib::PolyTree polytree;
-    clipper.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
+    clipper->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
     // Convert only the top level islands to the output.
     Polygons out;
     out.reserve(polytree.ChildCount());
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <string_view>
+#include <unordered_set>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/erase.hpp>
@@ -805,13 +807,102 @@ ConfigSubstitutions ConfigBase::load(const std::string &file, ForwardCompatibili
 ConfigSubstitutions ConfigBase::load_from_ini(const std::string &file, ForwardCompatibilitySubstitutionRule compatibility_rule)
 {
     try {
-    boost::property_tree::ptree tree;
-    boost::nowide::ifstream ifs(file);
-    boost::property_tree::read_ini(ifs, tree);
-        return this->load(tree, compatibility_rule);
+        boost::nowide::ifstream ifs(file, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        return this->load_from_ini_string(data, compatibility_rule);
     } catch (const ConfigurationError &e) {
         throw ConfigurationError(format("Failed loading configuration file \"%1%\": %2%", file, e.what()));
+    }
+}
+
+void tokenize_ini(const std::string &data,
+                  const std::function<void(std::string_view name, size_t line_no)> &section_fn,
+                  const std::function<void(std::string_view key, std::string_view value, size_t line_no)> &key_value_fn)
+{
+    const char *ptr = data.data();
+    const char *end = ptr + data.size();
+    // Skip the UTF-8 byte order mark.
+    if (data.size() >= 3 && strncmp(ptr, "\xEF\xBB\xBF", 3) == 0)
+        ptr += 3;
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; };
+    for (size_t line_no = 1; ptr < end; ++ line_no) {
+        const char *line_end = std::find(ptr, end, '\n');
+        const char *b = ptr;
+        const char *e = line_end;
+        ptr = (line_end == end) ? end : line_end + 1;
+        // Trim the line.
+        for (; b < e && is_space(*b); ++ b) ;
+        for (; e > b && is_space(*(e - 1)); -- e) ;
+        if (b == e || *b == ';' || *b == '#')
+            // Empty line or a comment.
+            continue;
+        if (*b == '[') {
+            if (*(e - 1) != ']')
+                throw ConfigurationError(format("Unmatched '[' at line %1%", line_no));
+            const char *name_begin = b + 1;
+            const char *name_end   = e - 1;
+            for (; name_begin < name_end && is_space(*name_begin); ++ name_begin) ;
+            for (; name_end > name_begin && is_space(*(name_end - 1)); -- name_end) ;
+            section_fn(std::string_view(name_begin, name_end - name_begin), line_no);
+            continue;
+        }
+        const char *eq = std::find(b, e, '=');
+        if (eq == e)
+            throw ConfigurationError(format("'=' character not found at line %1%", line_no));
+        const char *key_end = eq;
+        for (; key_end > b && is_space(*(key_end - 1)); -- key_end) ;
+        if (key_end == b)
+            throw ConfigurationError(format("Key expected at line %1%", line_no));
+        const char *value = eq + 1;
+        for (; value < e && is_space(*value); ++ value) ;
+        key_value_fn(std::string_view(b, key_end - b), std::string_view(value, e - value), line_no);
+    }
 }
+
+void read_ini_tree(const std::string &data, boost::property_tree::ptree &tree)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree  result;
+    pt::ptree *section = nullptr;
+    tokenize_ini(data,
+        [&result, &section](std::string_view name, size_t line_no) {
+            std::string key(name);
+            if (result.find(key) != result.not_found())
+                throw ConfigurationError(format("Duplicate section \"%1%\" at line %2%", key, line_no));
+            section = &result.push_back(std::make_pair(std::move(key), pt::ptree()))->second;
+        },
+        [&result, &section](std::string_view key_view, std::string_view value, size_t line_no) {
+            pt::ptree  &parent = section ? *section : result;
+            std::string key(key_view);
+            if (parent.find(key) != parent.not_found())
+                throw ConfigurationError(format("Duplicate key \"%1%\" at line %2%", key, line_no));
+            parent.push_back(std::make_pair(std::move(key), pt::ptree(std::string(value))));
+        });
+    tree.swap(result);
+}
+
+ConfigSubstitutions ConfigBase::load_from_ini_string(const std::string &data, ForwardCompatibilitySubstitutionRule compatibility_rule)
+{
+    ConfigSubstitutionContext substitutions_ctxt(compatibility_rule);
+    // Keys already loaded, boost::property_tree::read_ini() refuses duplicate keys.
+    std::unordered_set<std::string_view> keys;
+    // Keys following a section header are not top level keys, they are ignored the same way load(ptree) ignores them.
+    bool in_section = false;
+    tokenize_ini(data,
+        [&in_section](std::string_view /* name */, size_t /* line_no */) { in_section = true; },
+        [this, &keys, &in_section, &substitutions_ctxt](std::string_view key, std::string_view value, size_t line_no) {
+            if (in_section)
+                return;
+            if (! keys.insert(key).second)
+                throw ConfigurationError(format("Duplicate key \"%1%\" at line %2%", key, line_no));
+            try {
+                t_config_option_key opt_key(key);
+                this->set_deserialize(opt_key, std::string(value), substitutions_ctxt);
+            } catch (UnknownOptionException & /* e */) {
+                // ignore
+            }
+        });
+    return std::move(substitutions_ctxt.substitutions);
 }
 
 ConfigSubstitutions ConfigBase::load(const boost::property_tree::ptree &tree, ForwardCompatibilitySubstitutionRule compatibility_rule)
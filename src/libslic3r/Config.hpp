@@ -10,6 +10,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "libslic3r.h"
 #include "clonable_ptr.hpp"
@@ -37,6 +38,17 @@ extern bool         unescape_strings_cstyle(const std::string &str, std::vector<
 
 extern std::string  escape_ampersand(const std::string& str);
 
+// Tokenize the content of an ini file, accepting the same syntax as boost::property_tree::read_ini():
+// the UTF-8 byte order mark, empty lines and comments starting with ';' or '#' are skipped, keys, values
+// and section names are trimmed. section_fn is called for each [section] header and key_value_fn for each
+// key = value line. Throws ConfigurationError on a malformed line.
+extern void         tokenize_ini(const std::string &data,
+                                 const std::function<void(std::string_view name, size_t line_no)> &section_fn,
+                                 const std::function<void(std::string_view key, std::string_view value, size_t line_no)> &key_value_fn);
+// Read the content of an ini file into a property tree using tokenize_ini().
+// Equivalent to boost::property_tree::read_ini(), including the errors on duplicate sections and keys.
+extern void         read_ini_tree(const std::string &data, boost::property_tree::ptree &tree);
+
 enum OptionCategory : int
 {
     none,
@@ -2082,6 +2094,9 @@ public:
     void setenv_() const;
     ConfigSubstitutions load(const std::string &file, ForwardCompatibilitySubstitutionRule compatibility_rule);
     ConfigSubstitutions load_from_ini(const std::string &file, ForwardCompatibilitySubstitutionRule compatibility_rule);
+    // Load the key / value pairs of a flat ini file (without sections) already read into memory.
+    // Equivalent to boost::property_tree::read_ini() followed by load(ptree), but without building the property tree.
+    ConfigSubstitutions load_from_ini_string(const std::string &data, ForwardCompatibilitySubstitutionRule compatibility_rule);
     ConfigSubstitutions load_from_gcode_file(const std::string &file, ForwardCompatibilitySubstitutionRule compatibility_rule);
     // Returns number of key/value pairs extracted.
     size_t load_from_gcode_string(const char* str, ConfigSubstitutionContext& substitutions);
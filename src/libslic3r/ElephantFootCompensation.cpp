@@ -13,6 +13,8 @@
 #include <cmath>
 #include <cassert>
 
+#include <tbb/parallel_for.h>
+
 // #define CONTOUR_DISTANCE_DEBUG_SVG
 
 namespace Slic3r {
@@ -535,82 +537,108 @@ static bool validate_expoly_orientation(const ExPolygon &expoly)
 }
 #endif /* NDEBUG */
 
-ExPolygon elephant_foot_compensation(const ExPolygon &input_expoly, double min_contour_width, const double compensation)
+// Compensate a single ExPolygon by each of the compensations. The simplified and resampled contours and the EdgeGrid
+// over them do not depend on the compensation, therefore they are only built once.
+static std::vector<ExPolygon> elephant_foot_compensation_steps(const ExPolygon &input_expoly, double min_contour_width, const std::vector<double> &compensations)
 {
 	assert(validate_expoly_orientation(input_expoly));
 
-	coordf_t scaled_compensation = scale_d(compensation);
-	coordf_t scaled_min_contour_width = scale_d(min_contour_width);
-	coordf_t min_contour_width_compensated = scaled_min_contour_width + 2. * scaled_compensation;
-	// Make the search radius a bit larger for the averaging in contour_distance over a fan of rays to work.
-	coordf_t search_radius = min_contour_width_compensated + scaled_min_contour_width * 0.5;
-
+	coordf_t 	scaled_min_contour_width = scale_d(min_contour_width);
 	BoundingBox bbox = get_extents(input_expoly.contour);
 	Point 		bbox_size = bbox.size();
-	ExPolygon   out;
-	if (bbox_size.x() < min_contour_width_compensated + SCALED_EPSILON ||
-		bbox_size.y() < min_contour_width_compensated + SCALED_EPSILON )
-        //this is a hidden switch that will create strange behavior for the user. That's why i deactivate it.
-        //|| input_expoly.area() < min_contour_width_compensated * min_contour_width_compensated * 5.)
-	{
-		// The contour is tiny. Don't correct it.
-		out = input_expoly;
-	}
-	else
-	{
-		EdgeGrid::Grid grid;
-		ExPolygon simplified = input_expoly.simplify(SCALED_EPSILON).front();
-		assert(validate_expoly_orientation(simplified));
-		BoundingBox bbox = get_extents(simplified.contour);
-		bbox.offset(SCALED_EPSILON);
-		grid.set_bbox(bbox);
-		grid.create(simplified, coord_t(0.7 * search_radius));
-		std::vector<std::vector<float>> deltas;
-		deltas.reserve(simplified.holes.size() + 1);
-		ExPolygon resampled(simplified);
-		double resample_interval = scale_(0.5);
-		for (size_t idx_contour = 0; idx_contour <= simplified.holes.size(); ++ idx_contour) {
-			Polygon &poly = (idx_contour == 0) ? resampled.contour : resampled.holes[idx_contour - 1];
-			std::vector<ResampledPoint> resampled_point_parameters;
-			poly.points = resample_polygon(poly.points, resample_interval, resampled_point_parameters);
-			assert(poly.is_counter_clockwise() == (idx_contour == 0));
-			std::vector<float> dists = contour_distance2(grid, idx_contour, poly.points, resampled_point_parameters, scaled_compensation, search_radius);
-			for (float &d : dists) {
-	//			printf("Point %d, Distance: %lf\n", int(&d - dists.data()), unscale<double>(d));
-				// Convert contour width to available compensation distance.
-				if (d < scaled_min_contour_width)
-					d = 0.f;
-				else if (d > min_contour_width_compensated)
-					d = - float(scaled_compensation);
-				else
-					d = - (d - float(scaled_min_contour_width)) / 2.f;
-				assert(d >= - float(scaled_compensation) && d <= 0.f);
-			}
-	//		smooth_compensation(dists, 0.4f, 10);
-			smooth_compensation_banded(poly.points, float(0.8 * resample_interval), dists, 0.3f, 3);
-			deltas.emplace_back(dists);
+	double 		resample_interval = scale_(0.5);
+
+	// Compensation independent data, built on demand.
+	bool 		prepared = false;
+	EdgeGrid::Grid grid;
+	ExPolygon 	simplified;
+	ExPolygon 	resampled;
+	std::vector<std::vector<ResampledPoint>> resampled_point_parameters;
+
+	std::vector<ExPolygon> out_steps;
+	out_steps.reserve(compensations.size());
+	for (const double compensation : compensations) {
+		coordf_t scaled_compensation = scale_d(compensation);
+		coordf_t min_contour_width_compensated = scaled_min_contour_width + 2. * scaled_compensation;
+		// Make the search radius a bit larger for the averaging in contour_distance over a fan of rays to work.
+		coordf_t search_radius = min_contour_width_compensated + scaled_min_contour_width * 0.5;
+
+		ExPolygon   out;
+		if (bbox_size.x() < min_contour_width_compensated + SCALED_EPSILON ||
+			bbox_size.y() < min_contour_width_compensated + SCALED_EPSILON )
+	        //this is a hidden switch that will create strange behavior for the user. That's why i deactivate it.
+	        //|| input_expoly.area() < min_contour_width_compensated * min_contour_width_compensated * 5.)
+		{
+			// The contour is tiny. Don't correct it.
+			out = input_expoly;
 		}
+		else
+		{
+			if (! prepared) {
+				simplified = input_expoly.simplify(SCALED_EPSILON).front();
+				assert(validate_expoly_orientation(simplified));
+				BoundingBox bbox = get_extents(simplified.contour);
+				bbox.offset(SCALED_EPSILON);
+				grid.set_bbox(bbox);
+				// The grid resolution only affects the speed of the queries, not their result.
+				grid.create(simplified, coord_t(0.7 * search_radius));
+				resampled = simplified;
+				resampled_point_parameters.assign(simplified.holes.size() + 1, {});
+				for (size_t idx_contour = 0; idx_contour <= simplified.holes.size(); ++ idx_contour) {
+					Polygon &poly = (idx_contour == 0) ? resampled.contour : resampled.holes[idx_contour - 1];
+					poly.points = resample_polygon(poly.points, resample_interval, resampled_point_parameters[idx_contour]);
+					assert(poly.is_counter_clockwise() == (idx_contour == 0));
+				}
+				prepared = true;
+			}
+			std::vector<std::vector<float>> deltas;
+			deltas.reserve(simplified.holes.size() + 1);
+			for (size_t idx_contour = 0; idx_contour <= simplified.holes.size(); ++ idx_contour) {
+				const Polygon &poly = (idx_contour == 0) ? resampled.contour : resampled.holes[idx_contour - 1];
+				std::vector<float> dists = contour_distance2(grid, idx_contour, poly.points, resampled_point_parameters[idx_contour], scaled_compensation, search_radius);
+				for (float &d : dists) {
+		//			printf("Point %d, Distance: %lf\n", int(&d - dists.data()), unscale<double>(d));
+					// Convert contour width to available compensation distance.
+					if (d < scaled_min_contour_width)
+						d = 0.f;
+					else if (d > min_contour_width_compensated)
+						d = - float(scaled_compensation);
+					else
+						d = - (d - float(scaled_min_contour_width)) / 2.f;
+					assert(d >= - float(scaled_compensation) && d <= 0.f);
+				}
+		//		smooth_compensation(dists, 0.4f, 10);
+				smooth_compensation_banded(poly.points, float(0.8 * resample_interval), dists, 0.3f, 3);
+				deltas.emplace_back(dists);
+			}
 
-		ExPolygons out_vec = variable_offset_inner_ex(resampled, deltas, 2.);
-		if (out_vec.size() == 1)
-			out = std::move(out_vec.front());
-		else {
-			// Something went wrong, don't compensate.
-			out = input_expoly;
+			ExPolygons out_vec = variable_offset_inner_ex(resampled, deltas, 2.);
+			if (out_vec.size() == 1)
+				out = std::move(out_vec.front());
+			else {
+				// Something went wrong, don't compensate.
+				out = input_expoly;
 #ifdef TESTS_EXPORT_SVGS
-			if (out_vec.size() > 1) {
-				static int iRun = 0;
-				SVG::export_expolygons(debug_out_path("elephant_foot_compensation-many_contours-%d.svg", iRun ++).c_str(),
-					{ { { input_expoly },   { "gray", "black", "blue", coord_t(scale_(0.02)), 0.5f, "black", coord_t(scale_(0.05)) } },
-					  { { out_vec },		{ "gray", "black", "blue", coord_t(scale_(0.02)), 0.5f, "black", coord_t(scale_(0.05)) } } });
-			}
+				if (out_vec.size() > 1) {
+					static int iRun = 0;
+					SVG::export_expolygons(debug_out_path("elephant_foot_compensation-many_contours-%d.svg", iRun ++).c_str(),
+						{ { { input_expoly },   { "gray", "black", "blue", coord_t(scale_(0.02)), 0.5f, "black", coord_t(scale_(0.05)) } },
+						  { { out_vec },		{ "gray", "black", "blue", coord_t(scale_(0.02)), 0.5f, "black", coord_t(scale_(0.05)) } } });
+				}
 #endif /* TESTS_EXPORT_SVGS */
-			assert(out_vec.size() == 1);
+				assert(out_vec.size() == 1);
+			}
 		}
+
+		assert(validate_expoly_orientation(out));
+		out_steps.emplace_back(std::move(out));
 	}
-    
-	assert(validate_expoly_orientation(out));
-	return out;
+	return out_steps;
+}
+
+ExPolygon elephant_foot_compensation(const ExPolygon &input_expoly, double min_contour_width, const double compensation)
+{
+	return std::move(elephant_foot_compensation_steps(input_expoly, min_contour_width, { compensation }).front());
 }
 
 ExPolygon  elephant_foot_compensation(const ExPolygon  &input, const Flow &external_perimeter_flow, const double compensation)
@@ -622,19 +650,28 @@ ExPolygon  elephant_foot_compensation(const ExPolygon  &input, const Flow &exter
 
 ExPolygons elephant_foot_compensation(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation)
 {
-	ExPolygons out;
-	out.reserve(input.size());
-	for (const ExPolygon &expoly : input)
-		out.emplace_back(elephant_foot_compensation(expoly, external_perimeter_flow, compensation));
-	return out;
+    // The contour shall be wide enough to apply the external perimeter plus compensation on both sides.
+    double min_contour_width = double(external_perimeter_flow.width + external_perimeter_flow.spacing());
+    return elephant_foot_compensation(input, min_contour_width, compensation);
 }
 
 ExPolygons elephant_foot_compensation(const ExPolygons &input, double min_contour_width, const double compensation)
 {
-	ExPolygons out;
-	out.reserve(input.size());
-	for (const ExPolygon &expoly : input)
-		out.emplace_back(elephant_foot_compensation(expoly, min_contour_width, compensation));
+	return std::move(elephant_foot_compensation(input, min_contour_width, std::vector<double>{ compensation }).front());
+}
+
+std::vector<ExPolygons> elephant_foot_compensation(const ExPolygons &input, double min_contour_width, const std::vector<double> &compensations)
+{
+	std::vector<ExPolygons> out(compensations.size(), ExPolygons(input.size()));
+	// The ExPolygons are independent, they are compensated in parallel.
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, input.size()),
+		[&input, &out, min_contour_width, &compensations](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i) {
+			std::vector<ExPolygon> steps = elephant_foot_compensation_steps(input[i], min_contour_width, compensations);
+			for (size_t step = 0; step < steps.size(); ++ step)
+				out[step][i] = std::move(steps[step]);
+		}
+	});
 	return out;
 }
 
@@ -12,6 +12,9 @@ ExPolygon  elephant_foot_compensation(const ExPolygon  &input, double min_counto
 ExPolygons elephant_foot_compensation(const ExPolygons &input, double min_countour_width, const double compensation);
 ExPolygon  elephant_foot_compensation(const ExPolygon  &input, const Flow &external_perimeter_flow, const double compensation);
 ExPolygons elephant_foot_compensation(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation);
+// Compensate the same input by each of the compensations, for example for the successive first layers.
+// The resampled contours and their EdgeGrid are built once for all the compensations.
+std::vector<ExPolygons> elephant_foot_compensation(const ExPolygons &input, double min_countour_width, const std::vector<double> &compensations);
 
 } // Slic3r
 
@@ -27,6 +27,8 @@ public:
     virtual double retract(double length, double restart_extra);
     virtual double unretract();
     double E() const { return m_E; }
+    // Would unretract() move the extruder axis?
+    bool   is_retracted() const { return m_retracted != 0. || m_restart_extra != 0.; }
     void   reset_E() { m_E = 0.; }
     double e_per_mm(double mm3_per_mm) const { return mm3_per_mm * m_e_per_mm3; }
     double e_per_mm3() const { return m_e_per_mm3; }
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "FillGyroid.hpp"
 
@@ -28,24 +29,22 @@ static inline double f(double x, double z_sin, double z_cos, bool vertical, bool
     }
 }
 
+// Wave between x_begin and x_end made of the repeated one period template.
 static inline Polyline make_wave(
-    const std::vector<Vec2d>& one_period, double width, double height, double offset, double scaleFactor,
+    const std::vector<Vec2d>& one_period, double x_begin, double x_end, double height, double offset, double scaleFactor,
     double z_cos, double z_sin, bool vertical, bool flip)
 {
-    std::vector<Vec2d> points = one_period;
-    double period = points.back()(0);
-    if (width != period) // do not extend if already truncated
-    {
-        points.reserve(one_period.size() * size_t(floor(width / period)));
-        points.pop_back();
-
-        size_t n = points.size();
-        do {
-            points.emplace_back(points[points.size()-n].x() + period, points[points.size()-n].y());
-        } while (points.back()(0) < width - EPSILON);
+    const double period = one_period.back()(0);
 
-        points.emplace_back(Vec2d(width, f(width, z_sin, z_cos, vertical, flip)));
-    }
+    std::vector<Vec2d> points;
+    points.emplace_back(Vec2d(x_begin, f(x_begin, z_sin, z_cos, vertical, flip)));
+    for (double x0 = period * floor(x_begin / period); x0 < x_end - EPSILON; x0 += period)
+        for (size_t i = 0; i + 1 < one_period.size(); ++ i) {
+            double x = one_period[i](0) + x0;
+            if (x > x_begin + EPSILON && x < x_end - EPSILON)
+                points.emplace_back(Vec2d(x, one_period[i](1)));
+        }
+    points.emplace_back(Vec2d(x_end, f(x_end, z_sin, z_cos, vertical, flip)));
 
     // and construct the final polyline to return:
     Polyline polyline;
@@ -61,11 +60,11 @@ static inline Polyline make_wave(
     return polyline;
 }
 
-static std::vector<Vec2d> make_one_period(double width, double scaleFactor, double z_cos, double z_sin, bool vertical, bool flip, double tolerance)
+static std::vector<Vec2d> make_one_period(double z_cos, double z_sin, bool vertical, bool flip, double tolerance)
 {
     std::vector<Vec2d> points;
     double dx = M_PI_2; // exact coordinates on main inflexion lobes
-    double limit = std::min(2*M_PI, width);
+    double limit = 2*M_PI;
     points.reserve(size_t(ceil(limit / tolerance / 3)));
 
     for (double x = 0.; x < limit - EPSILON; x += dx) {
@@ -101,7 +100,80 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
-static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
+// Extent of the region along the waves, for horizontal bands of the wave
+// grid. The waves are only generated where they can hit the region.
+class WaveSpans {
+    static constexpr double BandHeight = M_PI;
+    std::vector<std::pair<double, double>> m_bands;
+
+public:
+    // The contour is expected in the wave grid units, with the waves running along X.
+    WaveSpans(const std::vector<Vec2d> &contour, double height)
+        : m_bands(size_t(std::max(0., ceil(height / BandHeight))) + 1,
+                  { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() })
+    {
+        for (size_t i = 0; i < contour.size(); ++ i) {
+            const Vec2d &a = contour[i];
+            const Vec2d &b = contour[(i + 1) % contour.size()];
+            double umin  = std::min(a.x(), b.x());
+            double umax  = std::max(a.x(), b.x());
+            size_t first = band_idx(std::min(a.y(), b.y()));
+            size_t last  = band_idx(std::max(a.y(), b.y()));
+            for (size_t band = first; band <= last; ++ band) {
+                m_bands[band].first  = std::min(m_bands[band].first, umin);
+                m_bands[band].second = std::max(m_bands[band].second, umax);
+            }
+        }
+    }
+
+    // Extent along the waves of the region between v_min and v_max.
+    // Returns an empty range (first > second) if the region is not there.
+    std::pair<double, double> span(double v_min, double v_max) const
+    {
+        std::pair<double, double> out = { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() };
+        for (size_t band = band_idx(v_min), last = band_idx(v_max); band <= last; ++ band) {
+            out.first  = std::min(out.first, m_bands[band].first);
+            out.second = std::max(out.second, m_bands[band].second);
+        }
+        return out;
+    }
+
+private:
+    size_t band_idx(double v) const
+    {
+        return size_t(std::clamp(floor(v / BandHeight), 0., double(m_bands.size() - 1)));
+    }
+};
+
+struct GyroidPeriods {
+    double gridZ, density_adjusted, line_spacing;
+    std::vector<Vec2d> odd, even;
+};
+
+// One period of the odd and even waves only depends on the Z phase and on the
+// spacing, thus it is shared by all the surfaces of a layer with the same
+// infill settings. Kept per thread, the surfaces are filled in parallel.
+static const GyroidPeriods& gyroid_periods(double gridZ, double density_adjusted, double line_spacing,
+                                           double z_cos, double z_sin, bool vertical, bool flip, double tolerance)
+{
+    static constexpr size_t CacheSize = 8;
+    thread_local std::vector<GyroidPeriods> cache;
+
+    for (const GyroidPeriods &p : cache)
+        if (p.gridZ == gridZ && p.density_adjusted == density_adjusted && p.line_spacing == line_spacing)
+            return p;
+
+    if (cache.size() == CacheSize)
+        cache.erase(cache.begin());
+
+    cache.push_back({ gridZ, density_adjusted, line_spacing,
+                      make_one_period(z_cos, z_sin, vertical, flip, tolerance),
+                      make_one_period(z_cos, z_sin, vertical, !flip, tolerance) });
+    return cache.back();
+}
+
+// Contour is expected relative to the grid origin in scaled coordinates.
+static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height, const Polygon &contour)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
 
@@ -126,18 +198,38 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period_odd = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance); // creates one period of the waves, so it doesn't have to be recalculated all the time
-    flip = !flip;                                                                   // even polylines are a bit shifted
-    std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+    // creates one period of the waves, so it doesn't have to be recalculated all the time
+    // even polylines are a bit shifted
+    const GyroidPeriods &periods = gyroid_periods(gridZ, density_adjusted, line_spacing, z_cos, z_sin, vertical, flip, tolerance);
+
+    // The contour in the wave grid units, waves along X.
+    std::vector<Vec2d> grid_contour;
+    grid_contour.reserve(contour.points.size());
+    for (const Point &pt : contour.points) {
+        grid_contour.emplace_back(pt.cast<double>() / scaleFactor);
+        if (vertical)
+            std::swap(grid_contour.back().x(), grid_contour.back().y());
+    }
+    WaveSpans spans(grid_contour, height);
+
     Polylines result;
+    auto add_wave = [&](const std::vector<Vec2d> &one_period, double y0, bool flip) {
+        // The wave stays within [-pi/2, 2pi] of its offset. The span is
+        // extended to the inflexion points, which are vertices of the period.
+        std::pair<double, double> span = spans.span(y0 - M_PI, y0 + 2 * M_PI);
+        double x_begin = std::max(0., M_PI_2 * floor(span.first / M_PI_2));
+        double x_end   = std::min(width, M_PI_2 * ceil(span.second / M_PI_2));
+        if (x_begin < x_end)
+            result.emplace_back(make_wave(one_period, x_begin, x_end, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+    };
 
     for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
         // creates odd polylines
-        result.emplace_back(make_wave(one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+        add_wave(periods.odd, y0, flip);
         // creates even polylines
         y0 += M_PI;
         if (y0 < upper_bound + EPSILON) {
-            result.emplace_back(make_wave(one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+            add_wave(periods.even, y0, !flip);
         }
     }
 
@@ -167,13 +259,16 @@ void FillGyroid::_fill_surface_single(
     // align bounding box to a multiple of our grid module
     bb.merge(_align_to_grid(bb.min, Point(2*M_PI*distance, 2*M_PI*distance)));
 
-    // generate pattern
+    // generate pattern, only where the waves cross the region
+    Polygon contour = expolygon.contour;
+    contour.translate(-bb.min);
     Polylines polylines = make_gyroid_waves(
         (double)scale_(this->z),
         density_adjusted,
         this->get_spacing(),
         ceil(bb.size()(0) / distance) + 1.,
-        ceil(bb.size()(1) / distance) + 1.);
+        ceil(bb.size()(1) / distance) + 1.,
+        contour);
 
     // shift the polyline to the grid origin
     for (Polyline &pl : polylines)
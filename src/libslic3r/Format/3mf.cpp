@@ -27,6 +27,8 @@
 #include <boost/foreach.hpp>
 namespace pt = boost::property_tree;
 
+#include <tbb/parallel_for.h>
+
 #include <expat.h>
 #include <Eigen/Dense>
 #include "miniz_extension.hpp"
@@ -518,7 +520,19 @@ namespace Slic3r {
         bool _handle_start_config_metadata(const char** attributes, unsigned int num_attributes);
         bool _handle_end_config_metadata();
 
-        bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions);
+        // Triangle meshes of the volumes of a single object, generated from the geometry before the volumes are created,
+        // so that the meshes of all the objects could be repaired and their convex hulls calculated in parallel.
+        struct ObjectVolumes
+        {
+            ModelObject*                        object   { nullptr };
+            const Geometry*                     geometry { nullptr };
+            ObjectMetadata::VolumeMetadataList  volumes;
+            std::vector<TriangleMesh>           meshes;
+            std::vector<TriangleMesh>           convex_hulls;
+        };
+
+        bool _generate_volume_meshes(ObjectVolumes& object_volumes);
+        bool _generate_volumes(ObjectVolumes& object_volumes, ConfigSubstitutionContext& config_substitutions);
 
         // callbacks to parse the .model file
         static void XMLCALL _handle_start_model_xml_element(void* userData, const char* name, const char** attributes);
@@ -726,6 +740,8 @@ namespace Slic3r {
 
         close_zip_reader(&archive);
 
+        std::vector<ObjectVolumes> objects_volumes;
+        objects_volumes.reserve(m_objects.size());
         for (const IdToModelObjectMap::value_type& object : m_objects) {
             if (object.second >= m_model->objects.size()) {
                 add_error("Unable to find object");
@@ -792,10 +808,33 @@ namespace Slic3r {
                 volumes_ptr = &volumes;
             }
 
-            if (!_generate_volumes(*model_object, obj_geometry->second, *volumes_ptr, config_substitutions))
+            ObjectVolumes& object_volumes = objects_volumes.emplace_back();
+            object_volumes.object   = model_object;
+            object_volumes.geometry = &obj_geometry->second;
+            object_volumes.volumes  = *volumes_ptr;
+            if (!_generate_volume_meshes(object_volumes))
                 return false;
         }
 
+        // Repairing the meshes and calculating their convex hulls are the most expensive steps of the import, run them in parallel.
+        std::vector<std::pair<size_t, size_t>> volume_ids;
+        for (size_t object_idx = 0; object_idx < objects_volumes.size(); ++ object_idx)
+            for (size_t volume_idx = 0; volume_idx < objects_volumes[object_idx].meshes.size(); ++ volume_idx)
+                volume_ids.emplace_back(object_idx, volume_idx);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, volume_ids.size()), [&objects_volumes, &volume_ids](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                ObjectVolumes& object_volumes = objects_volumes[volume_ids[i].first];
+                TriangleMesh&  mesh           = object_volumes.meshes[volume_ids[i].second];
+                mesh.repair();
+                if (mesh.stl.stats.number_of_facets > 1)
+                    object_volumes.convex_hulls[volume_ids[i].second] = mesh.convex_hull_3d();
+            }
+        });
+
+        for (ObjectVolumes& object_volumes : objects_volumes)
+            if (!_generate_volumes(object_volumes, config_substitutions))
+                return false;
+
 //        // fixes the min z of the model if negative
 //        model.adjust_min_z();
 
@@ -1900,17 +1939,13 @@ namespace Slic3r {
         return true;
     }
 
-    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions)
+    bool _3MF_Importer::_generate_volume_meshes(ObjectVolumes& object_volumes)
     {
-        if (!object.volumes.empty())
-        {
-            add_error("Found invalid volumes count");
-            return false;
-        }
+        const Geometry& geometry      = *object_volumes.geometry;
+        unsigned int    geo_tri_count = (unsigned int)geometry.triangles.size() / 3;
 
-        unsigned int geo_tri_count = (unsigned int)geometry.triangles.size() / 3;
-
-        for (const ObjectMetadata::VolumeMetadata& volume_data : volumes)
+        object_volumes.meshes.reserve(object_volumes.volumes.size());
+        for (const ObjectMetadata::VolumeMetadata& volume_data : object_volumes.volumes)
         {
             if ((geo_tri_count <= volume_data.first_triangle_id) || (geo_tri_count <= volume_data.last_triangle_id) || (volume_data.last_triangle_id < volume_data.first_triangle_id))
             {
@@ -1918,24 +1953,11 @@ namespace Slic3r {
                 return false;
             }
 
-            Transform3d volume_matrix_to_object = Transform3d::Identity();
-            bool        has_transform 		    = false;
-            // extract the volume transformation from the volume's metadata, if present
-            for (const Metadata& metadata : volume_data.metadata)
-            {
-                if (metadata.key == MATRIX_KEY)
-                {
-                    volume_matrix_to_object = Slic3r::Geometry::transform3d_from_string(metadata.value);
-                    has_transform 			= ! volume_matrix_to_object.isApprox(Transform3d::Identity(), 1e-10);
-                    break;
-                }
-            }
-
             // splits volume out of imported geometry
-			TriangleMesh triangle_mesh;
-            stl_file    &stl             = triangle_mesh.stl;
-			unsigned int triangles_count = volume_data.last_triangle_id - volume_data.first_triangle_id + 1;
-			stl.stats.type = inmemory;
+            TriangleMesh &triangle_mesh   = object_volumes.meshes.emplace_back();
+            stl_file     &stl             = triangle_mesh.stl;
+            unsigned int  triangles_count = volume_data.last_triangle_id - volume_data.first_triangle_id + 1;
+            stl.stats.type = inmemory;
             stl.stats.number_of_facets = (uint32_t)triangles_count;
             stl.stats.original_num_facets = (int)stl.stats.number_of_facets;
             stl_allocate(&stl);
@@ -1957,14 +1979,49 @@ namespace Slic3r {
                 }
             }
 
-			stl_get_size(&stl);
-			triangle_mesh.repair();
+            stl_get_size(&stl);
+        }
+        object_volumes.convex_hulls.assign(object_volumes.meshes.size(), TriangleMesh());
+
+        return true;
+    }
+
+    bool _3MF_Importer::_generate_volumes(ObjectVolumes& object_volumes, ConfigSubstitutionContext& config_substitutions)
+    {
+        ModelObject&    object   = *object_volumes.object;
+        const Geometry& geometry = *object_volumes.geometry;
+
+        if (!object.volumes.empty())
+        {
+            add_error("Found invalid volumes count");
+            return false;
+        }
+
+        for (size_t volume_idx = 0; volume_idx < object_volumes.volumes.size(); ++ volume_idx)
+        {
+            const ObjectMetadata::VolumeMetadata& volume_data = object_volumes.volumes[volume_idx];
+
+            Transform3d volume_matrix_to_object = Transform3d::Identity();
+            bool        has_transform           = false;
+            // extract the volume transformation from the volume's metadata, if present
+            for (const Metadata& metadata : volume_data.metadata)
+            {
+                if (metadata.key == MATRIX_KEY)
+                {
+                    volume_matrix_to_object = Slic3r::Geometry::transform3d_from_string(metadata.value);
+                    has_transform           = ! volume_matrix_to_object.isApprox(Transform3d::Identity(), 1e-10);
+                    break;
+                }
+            }
+
+            unsigned int triangles_count = volume_data.last_triangle_id - volume_data.first_triangle_id + 1;
+            unsigned int src_start_id    = volume_data.first_triangle_id * 3;
 
-			ModelVolume* volume = object.add_volume(std::move(triangle_mesh));
+            // The mesh has already been repaired and its convex hull calculated by _load_model_from_file().
+            ModelVolume* volume = object.add_volume(std::move(object_volumes.meshes[volume_idx]), std::move(object_volumes.convex_hulls[volume_idx]));
             // stores the volume matrix taken from the metadata, if present
             if (has_transform)
                 volume->source.transform = Slic3r::Geometry::Transformation(volume_matrix_to_object);
-            volume->calculate_convex_hull();
 
             // recreate custom supports and seam from previously loaded attribute
             for (unsigned i=0; i<triangles_count; ++i) {
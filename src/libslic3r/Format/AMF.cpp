@@ -27,6 +27,8 @@ namespace pt = boost::property_tree;
 #include <boost/nowide/fstream.hpp>
 #include "miniz_extension.hpp"
 
+#include <tbb/parallel_for.h>
+
 #if 0
 // Enable debugging and assert in this file.
 #define DEBUG
@@ -659,7 +661,7 @@ void AMFParserContext::endElement(const char * /* name */)
             // pass false if the mesh offset has been already taken from the data 
             m_volume->center_geometry_after_creation(m_volume->source.input_file.empty());
 
-        m_volume->calculate_convex_hull();
+        // The convex hulls of all the volumes are calculated in parallel by endDocument().
         m_volume_facets.clear();
         m_volume = nullptr;
         break;
@@ -834,6 +836,16 @@ void AMFParserContext::endElement(const char * /* name */)
 
 void AMFParserContext::endDocument()
 {
+    // Calculate the convex hulls of the volumes loaded, in parallel.
+    std::vector<ModelVolume*> volumes;
+    for (ModelObject *object : m_model.objects)
+        for (ModelVolume *volume : object->volumes)
+            if (! volume->get_convex_hull_shared_ptr())
+                volumes.emplace_back(volume);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&volumes](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            volumes[i]->calculate_convex_hull();
+    });
     for (const auto &object : m_object_instances_map) {
         if (object.second.idx == -1) {
             printf("Undefined object %s referenced in constellation\n", object.first.c_str());
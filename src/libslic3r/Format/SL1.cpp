@@ -428,13 +428,13 @@ void SL1Archive::export_print(Zipper& zipper,
         zipper << to_ini(slicerconf);
         
         size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+        for_each_encoded_layer(print, [&zipper, &project, &i](const sla::EncodedRaster &rst) {
 
             std::string imgname = project + string_printf("%.5d", i++) + "." +
                                   rst.extension();
             
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        });
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
         // Rethrow the exception
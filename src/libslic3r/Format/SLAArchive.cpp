@@ -53,7 +53,7 @@ uqptr<sla::RasterBase> SLAArchive::create_raster() const
 
 sla::RasterEncoder SLAArchive::get_encoder() const
 {
-    return sla::PNGRasterEncoder{};
+    return sla::FastPNGRasterEncoder{};
 }
 
 } // namespace Slic3r
@@ -35,7 +35,7 @@ public:
         auto diff = this->config().diff(cfg);
         if (!diff.empty()) {
             this->config().apply_only(cfg, diff);
-            m_layers = {};
+            clear_layers();
         }
     }
     
@@ -6,6 +6,8 @@ namespace Slic3r {
 class TriangleMesh;
 class ModelObject;
 
+// Load an STL file into a provided mesh and repair it.
+extern bool load_stl(const char *path, TriangleMesh *mesh);
 // Load an STL file into a provided model.
 extern bool load_stl(const char *path, Model *model, const char *object_name = nullptr);
 
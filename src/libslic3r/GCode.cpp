@@ -5,6 +5,7 @@
 #include "ExtrusionEntity.hpp"
 #include "EdgeGrid.hpp"
 #include "Geometry.hpp"
+#include "GCode/ArcFitter.hpp"
 #include "GCode/FanMover.hpp"
 #include "GCode/PrintExtents.hpp"
 #include "GCode/WipeTower.hpp"
@@ -668,23 +669,50 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessor::Result* re
     if (file == nullptr)
         throw Slic3r::RuntimeError(std::string("G-code export to ") + path + " failed.\nCannot open the file for writing.\n");
 
+    // If only the cooling settings changed since the last export, replay the cached layers through the cooling buffer.
+    GCodeExportCache &export_cache = print->m_gcode_export_cache;
+    bool              from_cache   = export_cache.matches(*print);
+    if (! from_cache)
+        export_cache.clear();
+
     try {
         m_placeholder_parser_failed_templates.clear();
-        this->_do_export(*print, file, thumbnail_cb);
+        if (from_cache) {
+            BOOST_LOG_TRIVIAL(info) << "Only the cooling settings or the custom G-codes changed, re-exporting the cached G-code layers";
+            this->_do_export_from_cache(*print, file, thumbnail_cb);
+        } else {
+            // The wipe tower tool changes depend on the fan state set by the cooling buffer,
+            // the sequential print resets the cooling buffer at the current position.
+            if (! print->config().complete_objects.value && ! print->has_wipe_tower())
+                m_export_cache = &export_cache;
+            this->_do_export(*print, file, thumbnail_cb);
+        }
         fflush(file);
         if (ferror(file)) {
             fclose(file);
             boost::nowide::remove(path_tmp.c_str());
             throw Slic3r::RuntimeError(std::string("G-code export to ") + path + " failed\nIs the disk full?\n");
         }
-    } catch (std::exception & /* ex */) {
+    } catch (std::exception &ex) {
         // Rethrow on any exception. std::runtime_exception and CanceledException are expected to be thrown.
         // Close and remove the file.
         fclose(file);
         boost::nowide::remove(path_tmp.c_str());
+        // Drop a partially recorded cache, or a cache which failed to be replayed.
+        if (m_export_cache != nullptr || (from_cache && dynamic_cast<CanceledException*>(&ex) == nullptr))
+            export_cache.clear();
+        m_export_cache = nullptr;
         throw;
     }
     fclose(file);
+    if (m_export_cache != nullptr) {
+        if (m_placeholder_parser_failed_templates.empty())
+            export_cache.snapshot(*print);
+        else
+            // Don't replay the error messages without reporting them.
+            export_cache.clear();
+        m_export_cache = nullptr;
+    }
 
     if (! m_placeholder_parser_failed_templates.empty()) {
         // G-code export proceeded, but some of the PlaceholderParser substitutions failed.
@@ -1153,6 +1181,8 @@ void GCode::_do_export(Print& print, FILE* file, ThumbnailsGeneratorCallback thu
     m_cooling_buffer = make_unique<CoolingBuffer>(*this);
     if (print.config().spiral_vase.value)
         m_spiral_vase = make_unique<SpiralVase>(print.config());
+    m_arc_fitting       = print.config().arc_fitting.value && ! print.config().spiral_vase.value;
+    m_arc_fitting_stats = ArcFittingStatistics();
 #ifdef HAS_PRESSURE_EQUALIZER
     if (print.config().max_volumetric_extrusion_rate_slope_positive.value > 0 ||
         print.config().max_volumetric_extrusion_rate_slope_negative.value > 0)
@@ -1162,16 +1192,21 @@ void GCode::_do_export(Print& print, FILE* file, ThumbnailsGeneratorCallback thu
     m_enable_extrusion_role_markers = false;
 #endif /* HAS_PRESSURE_EQUALIZER */
 
-    // Write information on the generator.
-    _write_format(file, "; %s\n\n", Slic3r::header_slic3r_generated().c_str());
-
+#ifdef HAS_PRESSURE_EQUALIZER
+    // The pressure equalizer is applied after the cooling buffer, it is not replayed from the cache.
+    if (m_pressure_equalizer && m_export_cache != nullptr) {
+        m_export_cache->clear();
+        m_export_cache = nullptr;
+    }
+#endif /* HAS_PRESSURE_EQUALIZER */
 
-    const ConfigOptionBool *thumbnails_with_bed = print.full_print_config().option<ConfigOptionBool>("thumbnails_with_bed");
-    DoExport::export_thumbnails_to_file(thumbnail_cb, 
-        print.full_print_config().option<ConfigOptionPoints>("thumbnails")->values,
-        thumbnails_with_bed==nullptr? false:thumbnails_with_bed->value,
-        [this, file](const char* sz) { this->_write(file, sz); }, 
-        [&print]() { print.throw_if_canceled(); });
+    // Write information on the generator and the thumbnails, regenerated when re-exporting from the cache.
+    {
+        GCodeExportCache *export_cache = std::exchange(m_export_cache, nullptr);
+        this->_write_header(print, file, thumbnail_cb);
+        if ((m_export_cache = export_cache) != nullptr)
+            this->_record_export_chunk(GCodeExportCache::ctHeader, std::string());
+    }
 
     // Write notes (content of the Print Settings tab -> Notes)
     {
@@ -1330,6 +1365,12 @@ void GCode::_do_export(Print& print, FILE* file, ThumbnailsGeneratorCallback thu
     print.throw_if_canceled();
 
     m_cooling_buffer->set_current_extruder(initial_extruder_id);
+    if (m_export_cache != nullptr) {
+        m_export_cache->extruders           = m_writer.extruder_ids();
+        for (const Mill &mill : m_writer.mills())
+            m_export_cache->mills.emplace_back(mill.mill_id());
+        m_export_cache->initial_extruder_id = initial_extruder_id;
+    }
 
     // Emit machine envelope limits for the Marlin firmware.
     this->print_machine_envelope(file, print);
@@ -1371,6 +1412,12 @@ void GCode::_do_export(Print& print, FILE* file, ThumbnailsGeneratorCallback thu
         m_placeholder_parser.set("first_layer_print_size", new ConfigOptionFloats({ bbox.size().x(), bbox.size().y() }));
     }
 
+    if (m_export_cache != nullptr)
+        // Keep the placeholders set above for the custom G-codes regenerated by the re-export.
+        for (const t_config_option_key &opt_key : m_placeholder_parser.config().keys())
+            if (print.placeholder_parser().option(opt_key) == nullptr)
+                m_export_cache->placeholders.set_key_value(opt_key, m_placeholder_parser.option(opt_key)->clone());
+
     std::string start_gcode = this->placeholder_parser_process("start_gcode", print.config().start_gcode.value, initial_extruder_id);
     // Set bed temperature if the start G-code does not contain any bed temp control G-codes.
     if((initial_extruder_id != (uint16_t)-1) && !this->config().start_gcode_manual && this->config().gcode_flavor != gcfKlipper && print.config().first_layer_bed_temperature.get_at(initial_extruder_id) != 0)
@@ -1607,35 +1654,29 @@ void GCode::_do_export(Print& print, FILE* file, ThumbnailsGeneratorCallback thu
         _add_object_change_labels(gcode);
         _write(file, gcode);
     }
-    _write(file, m_writer.set_fan(uint8_t(0)));
+    {
+        // The fan state at the end of the print depends on the cooling settings.
+        GCodeExportCache *export_cache = std::exchange(m_export_cache, nullptr);
+        _write(file, m_writer.set_fan(uint8_t(0)));
+        if ((m_export_cache = export_cache) != nullptr)
+            this->_record_export_chunk(GCodeExportCache::ctFanOff, std::string());
+    }
 
     // adds tag for processor
     _write_format(file, ";%s%s\n", GCodeProcessor::Extrusion_Role_Tag.c_str(), ExtrusionEntity::role_to_string(erCustom).c_str());
 
     // Process filament-specific gcode in extruder order.
     if (initial_extruder_id != (uint16_t)-1) {
-        DynamicConfig config;
-        config.set_key_value("layer_num", new ConfigOptionInt(m_layer_index));
-        config.set_key_value("layer_z", new ConfigOptionFloat(m_writer.get_position()(2) - m_config.z_offset.value));
-        config.set_key_value("max_layer_z", new ConfigOptionFloat(m_max_layer_z));
-        config.set_key_value("current_extruder_id", new ConfigOptionInt((int)m_writer.tool()->id()));
-        if (m_writer.tool_is_extruder()) {
-            if (print.config().single_extruder_multi_material) {
-                // Process the end_filament_gcode for the active filament only.
-                int extruder_id = m_writer.tool()->id();
-                config.set_key_value("filament_extruder_id", new ConfigOptionInt(extruder_id));
-                _writeln(file, this->placeholder_parser_process("end_filament_gcode", print.config().end_filament_gcode.get_at(extruder_id), extruder_id, &config));
-            } else {
-                for (const std::string& end_gcode : print.config().end_filament_gcode.values) {
-                    int extruder_id = (uint16_t)(&end_gcode - &print.config().end_filament_gcode.values.front());
-                    config.set_key_value("filament_extruder_id", new ConfigOptionInt(extruder_id));
-                    config.set_key_value("previous_extruder", new ConfigOptionInt(extruder_id));
-                    config.set_key_value("next_extruder", new ConfigOptionInt(0));
-                    _writeln(file, this->placeholder_parser_process("end_filament_gcode", end_gcode, extruder_id, &config));
-                }
-            }
-        }
-        _writeln(file, this->placeholder_parser_process("end_gcode", print.config().end_gcode, m_writer.tool()->id(), &config));
+        GCodeExportCache::Checkpoint checkpoint;
+        checkpoint.layer_index      = m_layer_index;
+        checkpoint.print_z          = m_writer.get_position()(2) - m_config.z_offset.value;
+        checkpoint.max_layer_z      = m_max_layer_z;
+        checkpoint.tool_id          = m_writer.tool()->id();
+        checkpoint.current_extruder = this->_current_extruder_placeholder();
+        GCodeExportCache *export_cache = std::exchange(m_export_cache, nullptr);
+        this->_write_end_gcode(file, print, checkpoint);
+        if ((m_export_cache = export_cache) != nullptr)
+            this->_record_export_chunk(GCodeExportCache::ctEnd, std::string(), false, 0, false, &checkpoint);
     }
     _write(file, m_writer.update_progress(m_layer_count, m_layer_count, true)); // 100%
     _write(file, m_writer.postamble());
@@ -1658,19 +1699,264 @@ void GCode::_do_export(Print& print, FILE* file, ThumbnailsGeneratorCallback thu
     _write_format(file, "; total filament cost = %.2lf\n", print.m_print_statistics.total_cost);
     if (print.m_print_statistics.total_toolchanges > 0)
     	_write_format(file, "; total toolchanges = %i\n", print.m_print_statistics.total_toolchanges);
+    if (m_arc_fitting && m_arc_fitting_stats.arcs > 0) {
+        const ArcFittingStatistics &stats = m_arc_fitting_stats;
+        _write_format(file, "; arc fitting: %zu moves replaced by %zu arcs (%.1lf%% fewer commands), %.1lf kB saved\n",
+            stats.moves_replaced, stats.arcs, 100. * double(stats.moves_replaced - stats.arcs) / double(stats.moves_replaced),
+            (double(stats.bytes_replaced) - double(stats.bytes_arcs)) / 1024.);
+        BOOST_LOG_TRIVIAL(info) << "Arc fitting replaced " << stats.moves_replaced << " G1 moves by " << stats.arcs << " arcs, "
+            << stats.bytes_replaced << " bytes of G-code by " << stats.bytes_arcs << " bytes";
+    }
     _writeln(file, GCodeProcessor::Estimated_Printing_Time_Placeholder_Tag);
 
     // Append full config.
     _write(file, "\n", true);
     {
-        std::string full_config;
-        append_full_config(print, full_config);
-        if (!full_config.empty())
-            _write(file, full_config, true);
+        GCodeExportCache *export_cache = std::exchange(m_export_cache, nullptr);
+        this->_write_full_config(print, file);
+        if ((m_export_cache = export_cache) != nullptr) {
+            this->_record_export_chunk(GCodeExportCache::ctFullConfig, std::string());
+            m_export_cache->print_statistics = print.m_print_statistics;
+        }
     }
     print.throw_if_canceled();
 }
 
+void GCode::_do_export_from_cache(Print& print, FILE* file, ThumbnailsGeneratorCallback thumbnail_cb)
+{
+    GCodeExportCache &export_cache = print.m_gcode_export_cache;
+    ++ export_cache.num_replayed;
+
+    m_last_status_update = std::chrono::system_clock::now();
+    DoExport::init_gcode_processor(print.config(), m_processor, m_silent_time_estimator_enabled);
+    m_fan_mover.release();
+
+    this->apply_print_config(print.config());
+    this->set_extruders(export_cache.extruders);
+    if (! export_cache.mills.empty())
+        m_writer.set_mills(export_cache.mills);
+    m_cooling_buffer = make_unique<CoolingBuffer>(*this);
+    m_cooling_buffer->set_current_extruder(export_cache.initial_extruder_id);
+
+    // The same placeholders as set by _do_export(), with the current values of the config options.
+    m_placeholder_parser = print.placeholder_parser();
+    m_placeholder_parser.update_timestamp();
+    print.update_object_placeholders(m_placeholder_parser.config_writable(), ".gcode");
+    for (const t_config_option_key &opt_key : export_cache.placeholders.keys())
+        if (m_placeholder_parser.option(opt_key) == nullptr)
+            m_placeholder_parser.set(opt_key, export_cache.placeholders.option(opt_key)->clone());
+
+    // Custom G-codes per print_z assigned to the layers.
+    ToolOrdering tool_ordering = print.tool_ordering();
+    tool_ordering.assign_custom_gcodes(print);
+
+    // The statistics are the same, except for the color changes, which are collected while regenerating the layers.
+    print.m_print_statistics = export_cache.print_statistics;
+    print.m_print_statistics.color_extruderid_to_used_filament.clear();
+    print.m_print_statistics.color_extruderid_to_used_weight.clear();
+
+    size_t num_layers = std::count_if(export_cache.chunks.begin(), export_cache.chunks.end(),
+        [](const GCodeExportCache::Chunk &chunk) { return chunk.type == GCodeExportCache::ctLayer; });
+    size_t idx_layer  = 0;
+    for (const GCodeExportCache::Chunk &chunk : export_cache.chunks) {
+        switch (chunk.type) {
+        case GCodeExportCache::ctText:
+            _write(file, export_cache.gcode(chunk), chunk.flush);
+            break;
+        case GCodeExportCache::ctLayer:
+        {
+            std::string gcode = this->_replay_layer(print, chunk.checkpoint, export_cache.gcode(chunk), tool_ordering, print.m_print_statistics);
+            // The cooling buffer emits the fan commands with the fan offset of the active tool.
+            if (chunk.tool_id >= 0)
+                m_writer.set_tool(uint16_t(chunk.tool_id));
+            _write(file, m_cooling_buffer->process_layer(gcode, chunk.layer_id, chunk.support_only));
+            ++ idx_layer;
+            print.throw_if_canceled();
+            if ((static_cast<std::chrono::duration<double>>(std::chrono::system_clock::now() - m_last_status_update)).count() > 0.2) {
+                m_last_status_update = std::chrono::system_clock::now();
+                print.set_status(int((idx_layer * 100) / num_layers), std::string(L("Generating G-code layer %s / %s")), std::vector<std::string>{ std::to_string(idx_layer), std::to_string(num_layers) }, PrintBase::SlicingStatus::DEFAULT);
+            }
+            break;
+        }
+        case GCodeExportCache::ctHeader:
+            this->_write_header(print, file, thumbnail_cb);
+            break;
+        case GCodeExportCache::ctFanOff:
+            _write(file, m_writer.set_fan(uint8_t(0)));
+            break;
+        case GCodeExportCache::ctEnd:
+            m_writer.set_tool(chunk.checkpoint.tool_id);
+            m_placeholder_parser.set("current_extruder", chunk.checkpoint.current_extruder);
+            this->_write_end_gcode(file, print, chunk.checkpoint);
+            break;
+        case GCodeExportCache::ctFullConfig:
+            this->_write_full_config(print, file);
+            break;
+        }
+    }
+    print.throw_if_canceled();
+}
+
+std::string GCode::_replay_layer(const Print &print, const GCodeExportCache::Checkpoint &checkpoint, const std::string &gcode, const ToolOrdering &tool_ordering, PrintStatistics &stats)
+{
+    // Restore the state the per-layer sections were generated with.
+    m_writer.set_tool(checkpoint.tool_id);
+    m_placeholder_parser.set("current_extruder", checkpoint.current_extruder);
+
+    std::string out;
+    out.reserve(gcode.size());
+    size_t      pos = 0;
+    for (int section = 0; section < int(GCodeExportCache::lsCount); ++ section) {
+        const std::pair<size_t, size_t> &range = checkpoint.sections[section];
+        assert(pos <= range.first && range.first <= range.second && range.second <= gcode.size());
+        out.append(gcode, pos, range.first - pos);
+        pos = range.second;
+        switch (GCodeExportCache::LayerSection(section)) {
+        case GCodeExportCache::lsBeforeLayerGCode:
+            out += this->_before_layer_gcode(print, checkpoint);
+            break;
+        case GCodeExportCache::lsLayerGCode:
+            out += this->_layer_gcode(print, checkpoint);
+            break;
+        case GCodeExportCache::lsTemperatures:
+            if (checkpoint.second_layer_temperatures) {
+                m_writer.set_temperature_state(checkpoint.temperatures);
+                out += this->_second_layer_temperatures(print, checkpoint.first_extruder_id);
+            }
+            break;
+        case GCodeExportCache::lsCustomGCode:
+        {
+            const CustomGCode::Item *custom_gcode = tool_ordering.tools_for_layer(checkpoint.print_z).custom_gcode;
+            if (custom_gcode != nullptr && custom_gcode->type == CustomGCode::ColorChange)
+                add_color_change_stats(stats, checkpoint.tool_id, checkpoint.extruded_weight, checkpoint.used_filament);
+            out += this->emit_custom_gcode_per_print_z(*this, custom_gcode, checkpoint.first_extruder_id, print, stats);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    out.append(gcode, pos, std::string::npos);
+    return out;
+}
+
+std::string GCode::_before_layer_gcode(const Print &print, const GCodeExportCache::Checkpoint &checkpoint)
+{
+    if (print.config().before_layer_gcode.value.empty())
+        return std::string();
+    DynamicConfig config;
+    config.set_key_value("previous_layer_z", new ConfigOptionFloat(checkpoint.previous_print_z));
+    config.set_key_value("layer_num", new ConfigOptionInt(checkpoint.layer_index + 1));
+    config.set_key_value("layer_z",     new ConfigOptionFloat(checkpoint.print_z));
+    config.set_key_value("max_layer_z", new ConfigOptionFloat(checkpoint.max_layer_z));
+    return this->placeholder_parser_process("before_layer_gcode",
+        print.config().before_layer_gcode.value, checkpoint.tool_id, &config)
+        + "\n";
+}
+
+std::string GCode::_layer_gcode(const Print &print, const GCodeExportCache::Checkpoint &checkpoint)
+{
+    if (print.config().layer_gcode.value.empty())
+        return std::string();
+    DynamicConfig config;
+    config.set_key_value("previous_layer_z", new ConfigOptionFloat(checkpoint.previous_print_z));
+    config.set_key_value("layer_num", new ConfigOptionInt(checkpoint.next_layer_index));
+    config.set_key_value("layer_z",   new ConfigOptionFloat(checkpoint.print_z));
+    return this->placeholder_parser_process("layer_gcode",
+        print.config().layer_gcode.value, checkpoint.tool_id, &config)
+        + "\n";
+}
+
+// Transition from 1st to 2nd layer. Adjust nozzle temperatures as prescribed by the nozzle dependent
+// first_layer_temperature vs. temperature settings.
+std::string GCode::_second_layer_temperatures(const Print &print, uint16_t first_extruder_id)
+{
+    std::string gcode;
+    for (const Extruder &extruder : m_writer.extruders()) {
+        if (print.config().single_extruder_multi_material.value && extruder.id() != m_writer.tool()->id())
+            // In single extruder multi material mode, set the temperature for the current extruder only.
+            continue;
+        int temperature = print.config().temperature.get_at(extruder.id());
+        if(temperature > 0) // don't set it if disabled
+            gcode += m_writer.set_temperature(temperature, false, extruder.id());
+    }
+    if(print.config().bed_temperature.get_at(first_extruder_id) > 0)  // don't set it if disabled
+        gcode += m_writer.set_bed_temperature(print.config().bed_temperature.get_at(first_extruder_id));
+    return gcode;
+}
+
+void GCode::_write_end_gcode(FILE *file, const Print &print, const GCodeExportCache::Checkpoint &checkpoint)
+{
+    DynamicConfig config;
+    config.set_key_value("layer_num", new ConfigOptionInt(checkpoint.layer_index));
+    config.set_key_value("layer_z", new ConfigOptionFloat(checkpoint.print_z));
+    config.set_key_value("max_layer_z", new ConfigOptionFloat(checkpoint.max_layer_z));
+    config.set_key_value("current_extruder_id", new ConfigOptionInt((int)checkpoint.tool_id));
+    if (m_writer.tool_is_extruder()) {
+        if (print.config().single_extruder_multi_material) {
+            // Process the end_filament_gcode for the active filament only.
+            int extruder_id = checkpoint.tool_id;
+            config.set_key_value("filament_extruder_id", new ConfigOptionInt(extruder_id));
+            _writeln(file, this->placeholder_parser_process("end_filament_gcode", print.config().end_filament_gcode.get_at(extruder_id), extruder_id, &config));
+        } else {
+            for (const std::string& end_gcode : print.config().end_filament_gcode.values) {
+                int extruder_id = (uint16_t)(&end_gcode - &print.config().end_filament_gcode.values.front());
+                config.set_key_value("filament_extruder_id", new ConfigOptionInt(extruder_id));
+                config.set_key_value("previous_extruder", new ConfigOptionInt(extruder_id));
+                config.set_key_value("next_extruder", new ConfigOptionInt(0));
+                _writeln(file, this->placeholder_parser_process("end_filament_gcode", end_gcode, extruder_id, &config));
+            }
+        }
+    }
+    _writeln(file, this->placeholder_parser_process("end_gcode", print.config().end_gcode, checkpoint.tool_id, &config));
+}
+
+int GCode::_current_extruder_placeholder() const
+{
+    const ConfigOptionInt *opt = m_placeholder_parser.config().option<ConfigOptionInt>("current_extruder");
+    return opt == nullptr ? 0 : opt->value;
+}
+
+void GCode::_write_header(Print& print, FILE* file, ThumbnailsGeneratorCallback thumbnail_cb)
+{
+    // Write information on the generator.
+    _write_format(file, "; %s\n\n", Slic3r::header_slic3r_generated().c_str());
+
+    const ConfigOptionBool *thumbnails_with_bed = print.full_print_config().option<ConfigOptionBool>("thumbnails_with_bed");
+    DoExport::export_thumbnails_to_file(thumbnail_cb, 
+        print.full_print_config().option<ConfigOptionPoints>("thumbnails")->values,
+        thumbnails_with_bed==nullptr? false:thumbnails_with_bed->value,
+        [this, file](const char* sz) { this->_write(file, sz); }, 
+        [&print]() { print.throw_if_canceled(); });
+}
+
+void GCode::_write_full_config(Print& print, FILE* file)
+{
+    std::string full_config;
+    append_full_config(print, full_config);
+    if (!full_config.empty())
+        _write(file, full_config, true);
+}
+
+void GCode::_record_export_chunk(GCodeExportCache::ChunkType type, std::string gcode, bool flush, size_t layer_id, bool support_only,
+                                 const GCodeExportCache::Checkpoint *checkpoint)
+{
+    assert(m_export_cache != nullptr);
+    GCodeExportCache::Chunk chunk;
+    chunk.type          = type;
+    chunk.flush         = flush;
+    chunk.support_only  = support_only;
+    chunk.layer_id      = layer_id;
+    chunk.tool_id       = m_writer.tool() == nullptr ? -1 : int(m_writer.tool()->id());
+    if (checkpoint != nullptr)
+        chunk.checkpoint = *checkpoint;
+    if (! m_export_cache->append(std::move(chunk), std::move(gcode))) {
+        // Could not spill the G-code into a file, stop recording.
+        m_export_cache->clear();
+        m_export_cache = nullptr;
+    }
+}
+
 std::string GCode::placeholder_parser_process(const std::string &name, const std::string &templ, uint16_t current_extruder_id, DynamicConfig *config_override)
 {
     DynamicConfig default_config;
@@ -1976,6 +2262,23 @@ std::vector<GCode::InstanceToPrint> GCode::sort_print_object_instances(
 	return out;
 }
 
+void GCode::add_color_change_stats(PrintStatistics &stats, uint16_t tool_id, double extruded_weight, double used_filament)
+{
+    //update stats : weight
+    double previously_extruded = 0;
+    for (const auto& tuple : stats.color_extruderid_to_used_weight)
+        if (tuple.first == tool_id)
+            previously_extruded += tuple.second;
+    stats.color_extruderid_to_used_weight.emplace_back(tool_id, extruded_weight - previously_extruded);
+
+    //update stats : length
+    previously_extruded = 0;
+    for (const auto& tuple : stats.color_extruderid_to_used_filament)
+        if (tuple.first == tool_id)
+            previously_extruded += tuple.second;
+    stats.color_extruderid_to_used_filament.emplace_back(tool_id, used_filament - previously_extruded);
+}
+
 std::string GCode::emit_custom_gcode_per_print_z(
     GCode                                                   &gcodegen,
     const CustomGCode::Item                                 *custom_gcode,
@@ -2004,22 +2307,7 @@ std::string GCode::emit_custom_gcode_per_print_z(
         else if (gcode_type == CustomGCode::PausePrint)
             pause_print_msg = custom_gcode->extra;
 
-        if (color_change) {
-            //update stats : weight
-            double previously_extruded = 0;
-            for (const auto& tuple : stats.color_extruderid_to_used_weight)
-                if (tuple.first == this->m_writer.tool()->id())
-                    previously_extruded += tuple.second;
-            double extruded = this->m_writer.tool()->filament_density() * this->m_writer.tool()->extruded_volume();
-            stats.color_extruderid_to_used_weight.emplace_back(this->m_writer.tool()->id(), extruded - previously_extruded);
-
-            //update stats : length
-            previously_extruded = 0;
-            for (const auto& tuple : stats.color_extruderid_to_used_filament)
-                if (tuple.first == this->m_writer.tool()->id())
-                    previously_extruded += tuple.second;
-            stats.color_extruderid_to_used_filament.emplace_back(this->m_writer.tool()->id(), this->m_writer.tool()->used_filament() - previously_extruded);
-        }
+        // The color change statistics are updated by the caller, see add_color_change_stats().
 
         // we should add or not colorprint_change in respect to nozzle_diameter count instead of really used extruders count
         if (color_change || tool_change)
@@ -2225,53 +2513,54 @@ void GCode::process_layer(
 
     // Set new layer - this will change Z and force a retraction if retract_layer_change is enabled.
     coordf_t previous_print_z = m_layer != nullptr ? m_layer->print_z : 0;
-    if (! print.config().before_layer_gcode.value.empty()) {
-        DynamicConfig config;
-        config.set_key_value("previous_layer_z", new ConfigOptionFloat(previous_print_z));
-        config.set_key_value("layer_num", new ConfigOptionInt(m_layer_index + 1));
-        config.set_key_value("layer_z",     new ConfigOptionFloat(print_z));
-        config.set_key_value("max_layer_z", new ConfigOptionFloat(m_max_layer_z));
-        gcode += this->placeholder_parser_process("before_layer_gcode",
-            print.config().before_layer_gcode.value, m_writer.tool()->id(), &config)
-            + "\n";
-    }
+    // State the per-layer sections are generated from, kept by the GCodeExportCache to regenerate them.
+    GCodeExportCache::Checkpoint checkpoint;
+    checkpoint.print_z           = print_z;
+    checkpoint.previous_print_z  = previous_print_z;
+    checkpoint.max_layer_z       = m_max_layer_z;
+    checkpoint.layer_index       = m_layer_index;
+    checkpoint.tool_id           = m_writer.tool() == nullptr ? first_extruder_id : m_writer.tool()->id();
+    checkpoint.current_extruder  = this->_current_extruder_placeholder();
+    checkpoint.first_extruder_id = first_extruder_id;
+    checkpoint.sections[GCodeExportCache::lsBeforeLayerGCode].first = gcode.size();
+    gcode += this->_before_layer_gcode(print, checkpoint);
+    checkpoint.sections[GCodeExportCache::lsBeforeLayerGCode].second = gcode.size();
     gcode += this->change_layer(print_z);  // this will increase m_layer_index
 	m_layer = &layer;
-    if (! print.config().layer_gcode.value.empty()) {
-        DynamicConfig config;
-        config.set_key_value("previous_layer_z", new ConfigOptionFloat(previous_print_z));
-        config.set_key_value("layer_num", new ConfigOptionInt(m_layer_index));
-        config.set_key_value("layer_z",   new ConfigOptionFloat(print_z));
-        gcode += this->placeholder_parser_process("layer_gcode",
-            print.config().layer_gcode.value, m_writer.tool()->id(), &config)
-            + "\n";
-        config.set_key_value("max_layer_z", new ConfigOptionFloat(m_max_layer_z));
-    }
+    checkpoint.next_layer_index  = m_layer_index;
+    checkpoint.sections[GCodeExportCache::lsLayerGCode].first = gcode.size();
+    gcode += this->_layer_gcode(print, checkpoint);
+    checkpoint.sections[GCodeExportCache::lsLayerGCode].second = gcode.size();
 
+    checkpoint.temperatures = m_writer.get_temperature_state();
+    checkpoint.sections[GCodeExportCache::lsTemperatures].first = gcode.size();
     if (! first_layer && ! m_second_layer_things_done) {
-        // Transition from 1st to 2nd layer. Adjust nozzle temperatures as prescribed by the nozzle dependent
-        // first_layer_temperature vs. temperature settings.
-        for (const Extruder &extruder : m_writer.extruders()) {
-            if (print.config().single_extruder_multi_material.value && extruder.id() != m_writer.tool()->id())
-                // In single extruder multi material mode, set the temperature for the current extruder only.
-                continue;
-            int temperature = print.config().temperature.get_at(extruder.id());
-            if(temperature > 0) // don't set it if disabled
-                gcode += m_writer.set_temperature(temperature, false, extruder.id());
-        }
-        if(print.config().bed_temperature.get_at(first_extruder_id) > 0)  // don't set it if disabled
-            gcode += m_writer.set_bed_temperature(print.config().bed_temperature.get_at(first_extruder_id));
+        gcode += this->_second_layer_temperatures(print, first_extruder_id);
         // Mark the temperature transition from 1st to 2nd layer to be finished.
         m_second_layer_things_done = true;
+        checkpoint.second_layer_temperatures = true;
     }
+    checkpoint.sections[GCodeExportCache::lsTemperatures].second = gcode.size();
 
     // Map from extruder ID to <begin, end> index of skirt loops to be extruded with that extruder.
     std::map<uint16_t, std::pair<size_t, size_t>> skirt_loops_per_extruder;
 
+    if (const Tool *tool = m_writer.tool(); tool != nullptr) {
+        checkpoint.retracted       = tool->is_retracted();
+        checkpoint.extruded_weight = tool->filament_density() * tool->extruded_volume();
+        checkpoint.used_filament   = tool->used_filament();
+    }
+    checkpoint.sections[GCodeExportCache::lsCustomGCode].first = gcode.size();
     if (single_object_instance_idx == size_t(-1)) {
         // Normal (non-sequential) print.
+        if (layer_tools.custom_gcode != nullptr && layer_tools.custom_gcode->type == CustomGCode::ColorChange)
+            add_color_change_stats(print_stat, checkpoint.tool_id, checkpoint.extruded_weight, checkpoint.used_filament);
         gcode += this->emit_custom_gcode_per_print_z(*this, layer_tools.custom_gcode, first_extruder_id, print, print_stat);
+        checkpoint.custom_gcode_unretracts = GCodeExportCache::custom_gcode_unretracts(layer_tools.custom_gcode);
     }
+    checkpoint.sections[GCodeExportCache::lsCustomGCode].second = gcode.size();
+    const GCodeWriter::TemperatureState temperatures_before_extrusions = m_writer.get_temperature_state();
+
     // Extrude skirt at the print_z of the raft layers and normal object layers
     // not at the print_z of the interlaced support material layers.
     skirt_loops_per_extruder = first_layer ?
@@ -2704,6 +2993,12 @@ void GCode::process_layer(
     }
 
 
+    // Keep the layer before the cooling is applied to re-export it, if only the cooling settings change.
+    if (m_export_cache != nullptr) {
+        checkpoint.body_sets_temperature = m_writer.get_temperature_state() != temperatures_before_extrusions;
+        this->_record_export_chunk(GCodeExportCache::ctLayer, gcode, false, layer.id(), (support_layer != nullptr && object_layer == nullptr), &checkpoint);
+    }
+
     // Apply cooling logic; this may alter speeds.
     if (m_cooling_buffer)
         gcode = m_cooling_buffer->process_layer(gcode, layer.id(), (support_layer != nullptr && object_layer == nullptr));
@@ -2716,7 +3011,11 @@ void GCode::process_layer(
     // printf("G-code after filter:\n%s\n", out.c_str());
 #endif /* HAS_PRESSURE_EQUALIZER */
 
-    _write(file, gcode);
+    {
+        GCodeExportCache *export_cache = std::exchange(m_export_cache, nullptr);
+        _write(file, gcode);
+        m_export_cache = export_cache;
+    }
     BOOST_LOG_TRIVIAL(trace) << "Exported layer " << layer.id() << " print_z " << print_z <<
         log_memory_info();
 
@@ -3577,6 +3876,8 @@ void GCode::_post_process(std::string& what, bool flush) {
 void GCode::_write(FILE* file, const char *what, bool flush /*=false*/)
 {
     if (what != nullptr) {
+        if (m_export_cache != nullptr)
+            this->_record_export_chunk(GCodeExportCache::ctText, what, flush);
         
         //const char * gcode_pp = _post_process(what).c_str();
         std::string str_preproc{ what };
@@ -3655,7 +3956,9 @@ std::string GCode::_extrude(const ExtrusionPath &path, const std::string &descri
         //get last direction //TODO: save it
         {
             std::string comment = m_config.gcode_comments ? descr : "";
-            if (path.role() != erExternalPerimeter || config().external_perimeter_cut_corners.value == 0) {
+            if (m_arc_fitting && (path.role() != erExternalPerimeter || config().external_perimeter_cut_corners.value == 0)) {
+                gcode += this->_extrude_arc_fitted(path, e_per_mm, comment);
+            } else if (path.role() != erExternalPerimeter || config().external_perimeter_cut_corners.value == 0) {
                 // normal & legacy pathcode
                 for (const Line& line : path.polyline.lines()) {
                     if (line.a == line.b) continue; //todo: investigate if it happens (it happens in perimeters)
@@ -3756,6 +4059,43 @@ std::string GCode::_extrude(const ExtrusionPath &path, const std::string &descri
     return gcode;
 }
 
+std::string GCode::_extrude_arc_fitted(const ExtrusionPath &path, double e_per_mm, const std::string &comment)
+{
+    std::string gcode;
+    const Points &points = path.polyline.points;
+    size_t        begin  = 0;
+    for (const ArcSegment &segment : arc_fit(points, scaled<double>(m_config.arc_fitting_tolerance.value))) {
+        if (! segment.is_arc()) {
+            if (points[segment.end_point_idx] != points[begin])
+                gcode += m_writer.extrude_to_xy(
+                    this->point_to_gcode(points[segment.end_point_idx]),
+                    e_per_mm * unscaled(segment.length),
+                    comment);
+        } else {
+            // Size of the G1 moves replaced by this arc, for the statistics.
+            const bool relative_e = m_config.use_relative_e_distances.value;
+            double     E          = relative_e ? 0. : m_writer.tool()->E();
+            for (size_t i = begin + 1; i <= segment.end_point_idx; ++ i) {
+                double dE = e_per_mm * unscaled((points[i] - points[i - 1]).cast<double>().norm());
+                E = relative_e ? dE : E + dE;
+                m_arc_fitting_stats.bytes_replaced += m_writer.extrude_to_xy_size(this->point_to_gcode(points[i]), dE != 0, E, comment);
+            }
+            std::string arc = m_writer.extrude_arc_to_xy(
+                this->point_to_gcode(points[segment.end_point_idx]),
+                unscaled(Vec2d(segment.center - points[begin].cast<double>())),
+                e_per_mm * unscaled(segment.length),
+                segment.orientation > 0,
+                comment);
+            m_arc_fitting_stats.moves_replaced += segment.end_point_idx - begin;
+            m_arc_fitting_stats.arcs           += 1;
+            m_arc_fitting_stats.bytes_arcs     += arc.size();
+            gcode += arc;
+        }
+        begin = segment.end_point_idx;
+    }
+    return gcode;
+}
+
 double_t GCode::_compute_speed_mm_per_sec(const ExtrusionPath& path, double speed) {
 
     // set speed
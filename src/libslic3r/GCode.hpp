@@ -185,6 +185,8 @@ public:
 
     // called by porcess_layer, do the color change / custom gcode
     std::string emit_custom_gcode_per_print_z(GCode& gcodegen, const CustomGCode::Item* custom_gcode, uint16_t first_extruder_id, const Print& print, PrintStatistics& stats);
+    // Filament used by a tool until a color change, extruded_weight and used_filament are totals of the tool since the start of the print.
+    static void add_color_change_stats(PrintStatistics &stats, uint16_t tool_id, double extruded_weight, double used_filament);
 
     // Object and support extrusions of the same PrintObject at the same print_z.
     // public, so that it could be accessed by free helper functions from GCode.cpp
@@ -200,6 +202,18 @@ public:
 
 private:
     void            _do_export(Print &print, FILE *file, ThumbnailsGeneratorCallback thumbnail_cb);
+    // Re-export the layers stored in Print::m_gcode_export_cache, applying the current cooling settings.
+    void            _do_export_from_cache(Print &print, FILE *file, ThumbnailsGeneratorCallback thumbnail_cb);
+    void            _write_header(Print &print, FILE *file, ThumbnailsGeneratorCallback thumbnail_cb);
+    void            _write_full_config(Print &print, FILE *file);
+    // Sections of process_layer() and of the end of the print regenerated from the checkpoints of the GCodeExportCache.
+    std::string     _before_layer_gcode(const Print &print, const GCodeExportCache::Checkpoint &checkpoint);
+    std::string     _layer_gcode(const Print &print, const GCodeExportCache::Checkpoint &checkpoint);
+    std::string     _second_layer_temperatures(const Print &print, uint16_t first_extruder_id);
+    void            _write_end_gcode(FILE *file, const Print &print, const GCodeExportCache::Checkpoint &checkpoint);
+    // Layer G-code from the GCodeExportCache with its per-layer sections regenerated.
+    std::string     _replay_layer(const Print &print, const GCodeExportCache::Checkpoint &checkpoint, const std::string &gcode, const ToolOrdering &tool_ordering, PrintStatistics &stats);
+    int             _current_extruder_placeholder() const;
 
     void            _init_multiextruders(FILE* file, Print& print, GCodeWriter& writer, ToolOrdering& tool_ordering, const std::string& custom_gcode);
 
@@ -384,6 +398,18 @@ private:
     // a previous extrusion path that is too small to be extruded, have to fusion it into the next call.
     ExtrusionPath                       m_last_too_small;
 
+    // Replace the curved extrusions by G2 / G3 arcs. Disabled for spiral vase, which only ramps the G1 moves.
+    bool                                m_arc_fitting { false };
+    // Reported at the end of the G-code.
+    struct ArcFittingStatistics {
+        // Number of G1 moves replaced by arcs and number of arcs emitted.
+        size_t moves_replaced { 0 };
+        size_t arcs           { 0 };
+        // Size of the G1 moves replaced and of the arcs emitted.
+        size_t bytes_replaced { 0 };
+        size_t bytes_arcs     { 0 };
+    }                                   m_arc_fitting_stats;
+
     std::unique_ptr<CoolingBuffer>      m_cooling_buffer;
     std::unique_ptr<SpiralVase>         m_spiral_vase;
 #ifdef HAS_PRESSURE_EQUALIZER
@@ -416,6 +442,11 @@ private:
     // Processor
     GCodeProcessor m_processor;
 
+    // Cache being filled with the G-code written by this export, nullptr if not recording.
+    GCodeExportCache *m_export_cache { nullptr };
+    void _record_export_chunk(GCodeExportCache::ChunkType type, std::string gcode, bool flush = false, size_t layer_id = 0, bool support_only = false,
+                              const GCodeExportCache::Checkpoint *checkpoint = nullptr);
+
     // Write a string into a file.
     void _write(FILE* file, const std::string& what, bool flush = false) { this->_write(file, what.c_str(), flush); }
     void _write(FILE* file, const char *what, bool flush = false);
@@ -433,6 +464,7 @@ private:
     void _post_process(std::string& what, bool flush = true);
 
     std::string _extrude(const ExtrusionPath &path, const std::string &description, double speed = -1);
+    std::string _extrude_arc_fitted(const ExtrusionPath &path, double e_per_mm, const std::string &comment);
     std::string _before_extrude(const ExtrusionPath &path, const std::string &description, double speed = -1);
     double_t    _compute_speed_mm_per_sec(const ExtrusionPath& path, double speed = -1);
     std::string _after_extrude(const ExtrusionPath &path);
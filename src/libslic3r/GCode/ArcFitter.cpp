@@ -0,0 +1,151 @@
+#include "ArcFitter.hpp"
+
+#include <cmath>
+
+namespace Slic3r {
+
+// Very large arcs are close to straight lines, their center is badly conditioned and the I / J offsets
+// written with a limited number of decimals would not reproduce the end point exactly.
+static constexpr double ARC_MAX_RADIUS_MM = 1000.;
+// Firmwares interpolate arcs with segments of a fixed length (Marlin: MM_PER_ARC_SEGMENT = 1mm),
+// tiny arcs would be flattened by the printer.
+static constexpr double ARC_MIN_RADIUS_MM = 0.5;
+
+// Bounds the number of points of a single arc. An arc is re-fitted through all its points when the next point
+// does not follow it, thus the number of points bounds the cost of fitting the next point.
+static constexpr size_t ARC_MAX_POINTS = 128;
+
+struct FittedArc
+{
+    Vec2d   center;
+    double  radius;
+    double  angle;
+    int     orientation;
+};
+
+// Verifies that the polyline segment from v_prev to v (both relative to the arc center) follows the arc
+// within the tolerance. Returns the angle the segment spans or a negative number if it does not follow the arc.
+static double arc_segment_angle(double radius, int orientation, const Vec2d &v_prev, const Vec2d &v, double tolerance)
+{
+    // The point has to be on the circle.
+    if (std::abs(v.norm() - radius) > tolerance)
+        return -1.;
+    // The polyline has to progress along the arc in a single direction.
+    const double c = cross2(v_prev, v);
+    if (c * orientation <= 0.)
+        return -1.;
+    // The arc between the two points must not bulge out of the chord by more than the tolerance.
+    const double half_chord_sqr = 0.25 * (v - v_prev).squaredNorm();
+    if (radius - std::sqrt(std::max(0., radius * radius - half_chord_sqr)) > tolerance)
+        return -1.;
+    return std::atan2(std::abs(c), v_prev.dot(v));
+}
+
+// A full circle is ambiguous with G2 / G3, keep some margin.
+static bool arc_angle_valid(double angle) { return angle <= 2. * PI - 0.1; }
+
+// Fits an arc through points[begin], points[(begin + end) / 2] and points[end], then verifies that all the points
+// in between and the chords connecting them are within the tolerance from the arc.
+static bool fit_arc(const Points &points, size_t begin, size_t end, double tolerance, FittedArc &out)
+{
+    // Work relative to the first point to keep the numbers small.
+    const Vec2d p0 = points[begin].cast<double>();
+    const Vec2d p1 = points[(begin + end) / 2].cast<double>() - p0;
+    const Vec2d p2 = points[end].cast<double>() - p0;
+    const double d = 2. * cross2(p1, p2);
+    if (std::abs(d) < EPSILON)
+        // Collinear.
+        return false;
+    const double l1 = p1.squaredNorm();
+    const double l2 = p2.squaredNorm();
+    const Vec2d  center((p2.y() * l1 - p1.y() * l2) / d, (p1.x() * l2 - p2.x() * l1) / d);
+    const double radius = center.norm();
+    if (radius > scaled<double>(ARC_MAX_RADIUS_MM) || radius < scaled<double>(ARC_MIN_RADIUS_MM))
+        return false;
+
+    const int orientation = d > 0. ? 1 : -1;
+    double    angle       = 0.;
+    Vec2d     v_prev      = - center;
+    for (size_t i = begin + 1; i <= end; ++ i) {
+        const Vec2d  v = points[i].cast<double>() - p0 - center;
+        const double a = arc_segment_angle(radius, orientation, v_prev, v, tolerance);
+        if (a < 0.)
+            return false;
+        angle += a;
+        v_prev = v;
+    }
+    if (! arc_angle_valid(angle))
+        return false;
+
+    out.center      = center + p0;
+    out.radius      = radius;
+    out.angle       = angle;
+    out.orientation = orientation;
+    return true;
+}
+
+// Extends the arc ending at points[end] by points[end + 1] without changing its center. Only the new point
+// and the new chord are verified, the preceding points already follow the arc.
+static bool extend_arc(const Points &points, size_t end, double tolerance, FittedArc &arc)
+{
+    const Vec2d  v_prev = points[end].cast<double>() - arc.center;
+    const Vec2d  v      = points[end + 1].cast<double>() - arc.center;
+    const double a      = arc_segment_angle(arc.radius, arc.orientation, v_prev, v, tolerance);
+    if (a < 0. || ! arc_angle_valid(arc.angle + a))
+        return false;
+    arc.angle += a;
+    return true;
+}
+
+std::vector<ArcSegment> arc_fit(const Points &points, double tolerance)
+{
+    std::vector<ArcSegment> out;
+    if (points.size() < 2)
+        return out;
+
+    for (size_t begin = 0; begin + 1 < points.size();) {
+        // Extend the arc greedily as long as it fits. The arc is re-fitted through all its points each time the number
+        // of its segments doubles, thus its center is estimated from distant points. Otherwise the next point
+        // is only tested against the current arc, the arc is re-fitted if the next point does not follow it.
+        FittedArc arc;
+        FittedArc arc_new;
+        size_t    end = begin + 1;
+        while (end + 1 < points.size() && end - begin < ARC_MAX_POINTS) {
+            const size_t num_segments = end + 1 - begin;
+            const bool   refit        = (num_segments & (num_segments - 1)) == 0;
+            if (end > begin + 1 && ! refit && extend_arc(points, end, tolerance, arc))
+                ++ end;
+            else if (fit_arc(points, begin, end + 1, tolerance, arc_new)) {
+                arc = arc_new;
+                ++ end;
+            } else if (end > begin + 1 && refit && extend_arc(points, end, tolerance, arc))
+                ++ end;
+            else
+                break;
+        }
+        ArcSegment &segment   = out.emplace_back();
+        segment.end_point_idx = end;
+        if (end > begin + 1) {
+            segment.orientation = arc.orientation;
+            segment.center      = arc.center;
+            segment.length      = arc.radius * arc.angle;
+        } else
+            segment.length      = (points[end] - points[begin]).cast<double>().norm();
+        begin = end;
+    }
+    return out;
+}
+
+double arc_length(const Vec2d &end_offset, const Vec2d &center_offset, bool ccw)
+{
+    const Vec2d v0    = - center_offset;
+    const Vec2d v1    = end_offset - center_offset;
+    double      angle = std::atan2(cross2(v0, v1), v0.dot(v1));
+    if (ccw && angle < 0.)
+        angle += 2. * PI;
+    else if (! ccw && angle > 0.)
+        angle -= 2. * PI;
+    return std::abs(angle) * v0.norm();
+}
+
+} // namespace Slic3r
@@ -0,0 +1,35 @@
+#ifndef slic3r_ArcFitter_hpp_
+#define slic3r_ArcFitter_hpp_
+
+#include "../libslic3r.h"
+#include "../Point.hpp"
+
+namespace Slic3r {
+
+// Piece of a polyline approximated either by a straight line or by a circular arc.
+struct ArcSegment
+{
+    // Index of the polyline point the segment ends at. The segment starts at the end of the previous segment,
+    // the first segment starts at the first point of the polyline.
+    size_t  end_point_idx { 0 };
+    // 1 for a counter-clockwise arc (G3), -1 for a clockwise arc (G2), 0 for a straight line.
+    int     orientation   { 0 };
+    // Arc center in scaled coordinates, only valid for arcs.
+    Vec2d   center        { Vec2d::Zero() };
+    // Length of the arc or of the line, scaled.
+    double  length        { 0. };
+
+    bool    is_arc() const { return orientation != 0; }
+};
+
+// Replaces runs of at least three points lying on a circle by arcs. Both the points and the chords between them
+// have to stay within the tolerance (scaled) from the arc, thus the arc does not deviate from the polyline
+// by more than the tolerance. The remaining points are returned as straight lines.
+std::vector<ArcSegment> arc_fit(const Points &points, double tolerance);
+
+// Length of a G2 / G3 arc given its end point and its center relative to the start point.
+double arc_length(const Vec2d &end_offset, const Vec2d &center_offset, bool ccw);
+
+} // namespace Slic3r
+
+#endif /* slic3r_ArcFitter_hpp_ */
@@ -1,4 +1,5 @@
 #include "../GCode.hpp"
+#include "ArcFitter.hpp"
 #include "CoolingBuffer.hpp"
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -52,6 +53,8 @@ struct CoolingLine
         TYPE_WIPE               = 1 << 13,
         TYPE_G4                 = 1 << 14,
         TYPE_G92                = 1 << 15,
+        // G2 / G3 arc emitted by the arc fitting, also marked as TYPE_G1.
+        TYPE_ARC                = 1 << 16,
     };
 
     CoolingLine(unsigned int type, size_t  line_start, size_t  line_end) :
@@ -382,12 +385,16 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             line.type = CoolingLine::TYPE_G0;
         else if (boost::starts_with(sline, "G1 "))
             line.type = CoolingLine::TYPE_G1;
+        else if (boost::starts_with(sline, "G2 ") || boost::starts_with(sline, "G3 "))
+            line.type = CoolingLine::TYPE_G1 | CoolingLine::TYPE_ARC;
         else if (boost::starts_with(sline, "G92 "))
             line.type = CoolingLine::TYPE_G92;
         if (line.type) {
             // G0, G1 or G92
             // Parse the G-code line.
             std::vector<float> new_pos(current_pos);
+            // Arc center relative to the start point.
+            Vec2f arc_center_offset = Vec2f::Zero();
             const char *c = sline.data() + 3;
             for (;;) {
                 // Skip whitespaces.
@@ -406,6 +413,9 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                             // This is G0 or G1 line and it sets the feedrate. This mark is used for reducing the duplicate F calls.
                             line.type |= CoolingLine::TYPE_HAS_F;
                     }
+                } else if ((line.type & CoolingLine::TYPE_ARC) && (*c == 'I' || *c == 'J')) {
+                    size_t coord = *c - 'I';
+                    arc_center_offset(coord) = float(atof(++c));
                 }
                 // Skip this word.
                 for (; *c != ' ' && *c != '\t' && *c != 0; ++ c);
@@ -429,6 +439,11 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 for (size_t i = 0; i < 4; ++ i)
                     dif[i] = new_pos[i] - current_pos[i];
                 float dxy2 = dif[0] * dif[0] + dif[1] * dif[1];
+                if (line.type & CoolingLine::TYPE_ARC) {
+                    // Replace the chord by the length of the arc.
+                    float length = float(arc_length(Vec2d(dif[0], dif[1]), arc_center_offset.cast<double>(), sline[1] == '3'));
+                    dxy2 = length * length;
+                }
                 float dxyz2 = dxy2 + dif[2] * dif[2];
                 if (dxyz2 > 0.f) {
                     // Movement in xyz, calculate time from the xyz Euclidian distance.
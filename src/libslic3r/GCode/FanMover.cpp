@@ -1,3 +1,4 @@
+#include "ArcFitter.hpp"
 #include "FanMover.hpp"
 
 #include "GCodeReader.hpp"
@@ -214,7 +215,7 @@ void FanMover::_remove_slow_fan(int16_t min_speed, float past_sec) {
 void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCodeLine& line)
 {
     // processes 'normal' gcode lines
-    std::string cmd(line.cmd());
+    const std::string_view cmd = line.cmd();
     double time = 0;
     int16_t fan_speed = -1;
     if (cmd.length() > 1) {
@@ -223,11 +224,22 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
         switch (::toupper(cmd[0])) {
         case 'G':
         {
-            if (::atoi(&cmd[1]) == 1 || ::atoi(&cmd[1]) == 0) {
+            int gcode_id = ::atoi(&cmd[1]);
+            if (gcode_id >= 0 && gcode_id <= 3) {
                 double distx = line.dist_X(reader);
                 double disty = line.dist_Y(reader);
                 double distz = line.dist_Z(reader);
                 double dist = distx * distx + disty * disty + distz * distz;
+                if (gcode_id >= 2) {
+                    // G2 / G3 arc from the arc fitting, with the center relative to the start point.
+                    float center_x = 0.f, center_y = 0.f;
+                    line.has_value('I', center_x);
+                    line.has_value('J', center_y);
+                    if (center_x != 0.f || center_y != 0.f) {
+                        double length = arc_length(Vec2d(distx, disty), Vec2d(center_x, center_y), gcode_id == 3);
+                        dist = length * length + distz * distz;
+                    }
+                }
                 if (dist > 0) {
                     dist = std::sqrt(dist);
                     time = dist / m_current_speed;
@@ -237,7 +249,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
         }
         case 'M':
         {
-            fan_speed = get_fan_speed(line.raw(), m_writer.config.gcode_flavor);
+            fan_speed = get_fan_speed(std::string(line.raw()), m_writer.config.gcode_flavor);
             if (fan_speed > 0 && !m_is_custom_gcode) {
                 if (nb_seconds_delay > 0 && (!only_overhangs || current_role != ExtrusionRole::erOverhangPerimeter)) {
                     // this M106 need to go in the past
@@ -247,10 +259,11 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
                         _remove_slow_fan(fan_speed, m_buffer_time_size + 1);
                         // then write the fan command
                         if (std::abs(m_buffer_time_size - nb_seconds_delay) < EPSILON) {
-                            _print_in_middle_G1(m_buffer.front(), m_buffer_time_size - nb_seconds_delay, line.raw());
+                            _print_in_middle_G1(m_buffer.front(), m_buffer_time_size - nb_seconds_delay, std::string(line.raw()));
                             remove_from_buffer(m_buffer.begin());
                         } else {
-                            m_process_output += line.raw() + "\n";
+                            m_process_output += line.raw();
+                            m_process_output += "\n";
                         }
                     } else {
                         //if kickstart
@@ -304,8 +317,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
         {
             if (line.raw().size() > 10 && line.raw().rfind(";TYPE:", 0) == 0) {
                 // get the type of the next extrusions
-                std::string extrusion_string = line.raw().substr(6, line.raw().size() - 6);
-                current_role = ExtrusionEntity::string_to_role(extrusion_string);
+                current_role = ExtrusionEntity::string_to_role(line.raw().substr(6));
             }
             if (line.raw().size() > 16 && line.raw().rfind("; custom gcode", 0) == 0) {
                 m_is_custom_gcode = line.raw().rfind("; custom gcode end", 0) != 0;
@@ -314,7 +326,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
     }
 
     if (time >= 0) {
-        BufferData& new_data = put_in_buffer(BufferData(line.raw(), time, fan_speed));
+        BufferData& new_data = put_in_buffer(BufferData(std::string(line.raw()), time, fan_speed));
         if (line.has(Axis::X)) {
             new_data.x = reader.x();
             new_data.dx = line.dist_X(reader);
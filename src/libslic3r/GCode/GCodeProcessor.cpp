@@ -1032,7 +1032,7 @@ std::string get_klipper_param(std::string key, std::string line) {
 void GCodeProcessor::process_klipper_ACTIVATE_EXTRUDER(const GCodeReader::GCodeLine& line) {
     uint8_t extruder_id = 0;
     //check the config
-    std::string raw_value = get_klipper_param(" EXTRUDER", line.raw());
+    std::string raw_value = get_klipper_param(" EXTRUDER", std::string(line.raw()));
     auto it = std::find(m_extruder_names.begin(), m_extruder_names.end(), raw_value);
     if ( it != m_extruder_names.end()) {
         process_T(uint8_t(it - m_extruder_names.begin()));
@@ -1127,7 +1127,7 @@ void GCodeProcessor::process_gcode_line(const GCodeReader::GCodeLine& line)
         default: { break; }
         }
     } else {
-        const std::string &comment = line.raw();
+        const std::string_view comment = line.raw();
         if (comment.length() > 2 && comment.front() == ';')
             // Process tags embedded into comments. Tag comments always start at the start of a line
             // with a comment and continue with a tag without any whitespace separator.
@@ -2372,9 +2372,9 @@ void GCodeProcessor::process_M108(const GCodeReader::GCodeLine& line)
     if (m_flavor != gcfSailfish)
         return;
 
-    std::string cmd = line.raw();
+    const std::string_view cmd = line.raw();
     size_t pos = cmd.find("T");
-    if (pos != std::string::npos)
+    if (pos != std::string_view::npos)
         process_T(cmd.substr(pos));
 }
 
@@ -2406,9 +2406,9 @@ void GCodeProcessor::process_M135(const GCodeReader::GCodeLine& line)
     if (m_flavor != gcfMakerWare)
         return;
 
-    std::string cmd = line.raw();
+    const std::string_view cmd = line.raw();
     size_t pos = cmd.find("T");
-    if (pos != std::string::npos)
+    if (pos != std::string_view::npos)
         process_T(cmd.substr(pos));
 }
 
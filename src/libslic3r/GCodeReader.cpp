@@ -6,6 +6,8 @@
 #include <iostream>
 #include <iomanip>
 
+#include <tbb/parallel_for.h>
+
 #include <Shiny/Shiny.h>
 
 namespace Slic3r {
@@ -22,18 +24,17 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
     m_extrusion_axis = m_config.get_extrusion_axis()[0];
 }
 
-const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline, std::pair<const char*, const char*> &command)
+const char* GCodeReader::tokenize_line(const char *ptr, GCodeLine &gline) const
 {
-    PROFILE_FUNC();
-    
     // command and args
     const char *c = ptr;
     {
-        PROFILE_BLOCK(command_and_args);
         // Skip the whitespaces.
-        command.first = skip_whitespaces(c);
+        const char *cmd = skip_whitespaces(c);
         // Skip the command.
-        c = command.second = skip_word(command.first);
+        c = skip_word(cmd);
+        gline.m_cmd_begin = uint32_t(cmd - ptr);
+        gline.m_cmd_end   = uint32_t(c - ptr);
         // Up to the end of line or comment.
 		while (! is_end_of_gcode_line(*c)) {
             // Skip whitespaces.
@@ -73,18 +74,14 @@ const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline,
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
+    // Either at the comment delimiter or at the end of line.
+    gline.m_comment = uint32_t(c - ptr);
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
-    // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr) {
-        PROFILE_BLOCK(copy_raw_string);
-        gline.m_raw.assign(ptr, c);
-    }
+    // Reference the raw string including the comment, without the trailing newlines.
+    gline.m_raw = std::string_view(ptr, c - ptr);
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -92,19 +89,31 @@ const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline,
 	if (*c == '\n')
 		++ c;
 
+    return c;
+}
+
+const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline)
+{
+    PROFILE_FUNC();
+
+    const char *c = this->tokenize_line(ptr, gline);
+
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
     if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
+        std::cout << gline.raw() << std::endl;
 
     return c;
 }
 
-void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command)
+void GCodeReader::update_coordinates(const GCodeLine &gline)
 {
     PROFILE_FUNC();
-    if (*command.first == 'G') {
-        int cmd_len = int(command.second - command.first);
-        if ((cmd_len == 2 && (command.first[1] == '0' || command.first[1] == '1')) ||
-            (cmd_len == 3 &&  command.first[1] == '9' && command.first[2] == '2')) {
+    const std::string_view cmd = gline.cmd();
+    if (! cmd.empty() && cmd[0] == 'G') {
+        if ((cmd.size() == 2 && cmd[1] >= '0' && cmd[1] <= '3') ||
+            (cmd.size() == 3 &&  cmd[1] == '9' && cmd[2] == '2')) {
             for (size_t i = 0; i < NUM_AXES; ++ i)
                 if (gline.has(Axis(i)))
                     m_position[i] = gline.value(Axis(i));
@@ -114,20 +123,97 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
 
 void GCodeReader::parse_file(const std::string &file, callback_t callback)
 {
-    boost::nowide::ifstream f(file);
-    std::string line;
+    // The file is read in blocks ending at a line boundary. Each block is split into chunks of whole lines,
+    // the chunks are tokenized in parallel, then the callback is called sequentially in the file order.
+    // The first block is small, so that a caller quitting early (e.g. after detecting the producer) does not pay for a full block.
+    static constexpr size_t chunk_size     = 64 * 1024;
+    static constexpr size_t max_block_size = 4 * 1024 * 1024;
+
+    boost::nowide::ifstream f(file, std::ios::binary);
+    std::string block;
+    std::string tail;
+    std::vector<std::pair<size_t, size_t>>     chunks;
+    std::vector<std::vector<GCodeLine>>        lines;
+    size_t                                     block_size = chunk_size;
     m_parsing_file = true;
-    while (m_parsing_file && std::getline(f, line))
-        this->parse_line(line, callback);
+    while (m_parsing_file && f.good()) {
+        // Read the next block, prepended with the incomplete line left over from the previous block.
+        block.swap(tail);
+        size_t old_size = block.size();
+        block.resize(old_size + block_size);
+        f.read(&block[old_size], std::streamsize(block_size));
+        block.resize(old_size + size_t(f.gcount()));
+        block_size = std::min(2 * block_size, max_block_size);
+        tail.clear();
+        if (f.good()) {
+            size_t last_eol = block.rfind('\n');
+            if (last_eol == std::string::npos) {
+                // A single line longer than the block, keep on reading.
+                tail.swap(block);
+                continue;
+            }
+            tail.assign(block, last_eol + 1, std::string::npos);
+            block.resize(last_eol + 1);
+        }
+        if (block.empty())
+            break;
+
+        // Split the block into chunks of whole lines.
+        chunks.clear();
+        for (size_t begin = 0; begin < block.size();) {
+            size_t end = begin + chunk_size;
+            end = (end >= block.size()) ? block.size() : std::min(block.find('\n', end), block.size() - 1) + 1;
+            chunks.emplace_back(begin, end);
+            begin = end;
+        }
+        if (lines.size() < chunks.size())
+            lines.resize(chunks.size());
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), [this, &block, &chunks, &lines](const tbb::blocked_range<size_t> &range) {
+            for (size_t ichunk = range.begin(); ichunk < range.end(); ++ ichunk) {
+                std::vector<GCodeLine> &chunk_lines = lines[ichunk];
+                chunk_lines.clear();
+                const char *ptr = block.data() + chunks[ichunk].first;
+                const char *end = block.data() + chunks[ichunk].second;
+                while (ptr < end) {
+                    // Lines are delimited by '\n' only, the tokenizer ignores anything following '\r' or '\0' the same way
+                    // as when parsing a line extracted by std::getline().
+                    const char *eol = static_cast<const char*>(memchr(ptr, '\n', end - ptr));
+                    this->tokenize_line(ptr, chunk_lines.emplace_back());
+                    ptr = (eol == nullptr) ? end : eol + 1;
+                }
+            }
+        });
+
+        for (size_t ichunk = 0; ichunk < chunks.size() && m_parsing_file; ++ ichunk)
+            for (const GCodeLine &gline : lines[ichunk]) {
+                if (! m_parsing_file)
+                    break;
+                if (gline.has(E) && m_config.use_relative_e_distances)
+                    m_position[E] = 0;
+                if (m_verbose)
+                    std::cout << gline.raw() << std::endl;
+                callback(*this, gline);
+                update_coordinates(gline);
+            }
+    }
+}
+
+void GCodeReader::GCodeLine::update_offsets()
+{
+    const std::string_view raw = this->raw();
+    const char *cmd = skip_whitespaces(raw.data());
+    m_cmd_begin = uint32_t(cmd - raw.data());
+    m_cmd_end   = uint32_t(skip_word(cmd) - raw.data());
+    size_t comment = raw.find(';');
+    m_comment   = uint32_t((comment == std::string_view::npos) ? raw.size() : comment);
 }
 
+// The raw string is always followed by an end of line character or by the terminating zero in the buffer, which stops the scanning.
 bool GCodeReader::GCodeLine::has(char axis) const
 {
-    const char *c = m_raw.c_str();
-    // Skip the whitespaces.
-    c = skip_whitespaces(c);
     // Skip the command.
-    c = skip_word(c);
+    const char *c = this->raw().data() + m_cmd_end;
     // Up to the end of line or comment.
     while (! is_end_of_gcode_line(*c)) {
         // Skip whitespaces.
@@ -145,11 +231,8 @@ bool GCodeReader::GCodeLine::has(char axis) const
 
 bool GCodeReader::GCodeLine::has_value(char axis, float &value) const
 {
-    const char *c = m_raw.c_str();
-    // Skip the whitespaces.
-    c = skip_whitespaces(c);
     // Skip the command.
-    c = skip_word(c);
+    const char *c = this->raw().data() + m_cmd_end;
     // Up to the end of line or comment.
     while (! is_end_of_gcode_line(*c)) {
         // Skip whitespaces.
@@ -188,17 +271,21 @@ void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, con
         match[1] = reader.extrusion_axis();
     }
 
+    std::string raw(this->raw());
     if (this->has(axis)) {
-        size_t pos = m_raw.find(match)+2;
-        size_t end = m_raw.find(' ', pos+1);
-        m_raw = m_raw.replace(pos, end-pos, ss.str());
+        size_t pos = raw.find(match)+2;
+        size_t end = raw.find(' ', pos+1);
+        raw = raw.replace(pos, end-pos, ss.str());
     } else {
-        size_t pos = m_raw.find(' ');
+        size_t pos = raw.find(' ');
         if (pos == std::string::npos)
-            m_raw += std::string(match) + ss.str();
+            raw += std::string(match) + ss.str();
         else
-            m_raw = m_raw.replace(pos, 0, std::string(match) + ss.str());
+            raw = raw.replace(pos, 0, std::string(match) + ss.str());
     }
+    m_raw_owned = std::move(raw);
+    m_owned     = true;
+    this->update_offsets();
     m_axis[axis] = new_value;
     m_mask |= 1 << int(axis);
 }
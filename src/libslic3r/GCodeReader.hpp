@@ -16,15 +16,14 @@ public:
     class GCodeLine {
     public:
         GCodeLine() { reset(); }
-        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw.clear(); }
+        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw = std::string_view(""); m_raw_owned.clear(); m_owned = false; m_cmd_begin = m_cmd_end = m_comment = 0; }
 
-        const std::string&      raw() const { return m_raw; }
-        const std::string_view  cmd() const { 
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
-            return std::string_view(cmd, GCodeReader::skip_word(cmd) - cmd);
-        }
+        // Raw line without the trailing newline. Unless modified by set(), it points into the buffer being parsed,
+        // thus it is only valid during the parser callback.
+        std::string_view        raw() const { return m_owned ? std::string_view(m_raw_owned) : m_raw; }
+        const std::string_view  cmd() const { return this->raw().substr(m_cmd_begin, m_cmd_end - m_cmd_begin); }
         const std::string_view  comment() const
-            { size_t pos = m_raw.find(';'); return (pos == std::string::npos) ? std::string_view() : std::string_view(m_raw).substr(pos + 1); }
+            { std::string_view raw = this->raw(); return (m_comment < raw.size()) ? raw.substr(m_comment + 1) : std::string_view(); }
 
         bool  has(Axis axis) const { return (m_mask & (1 << int(axis))) != 0; }
         float value(Axis axis) const { return m_axis[axis]; }
@@ -44,11 +43,7 @@ public:
             float y = this->has(Y) ? (this->y() - reader.y()) : 0;
             return sqrt(x*x + y*y);
         }
-        bool cmd_is(const char *cmd_test) const {
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
-            size_t len = strlen(cmd_test); 
-            return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
-        }
+        bool cmd_is(const char *cmd_test) const { return this->cmd() == cmd_test; }
         bool extruding(const GCodeReader &reader)  const { return this->cmd_is("G1") && this->dist_E(reader) > 0; }
         bool retracting(const GCodeReader &reader) const { return this->cmd_is("G1") && this->dist_E(reader) < 0; }
         bool travel()     const { return this->cmd_is("G1") && ! this->has(E); }
@@ -67,7 +62,17 @@ public:
         float f() const { return m_axis[F]; }
 
     private:
-        std::string      m_raw;
+        // Updates the command and comment offsets after the raw string was modified.
+        void update_offsets();
+
+        std::string_view m_raw;
+        // Storage of a line modified by set().
+        std::string      m_raw_owned;
+        bool             m_owned;
+        // Offsets of the command and of the comment delimiter into the raw string, decoded once by the tokenizer.
+        uint32_t         m_cmd_begin;
+        uint32_t         m_cmd_end;
+        uint32_t         m_comment;
         float            m_axis[NUM_AXES];
         uint32_t         m_mask;
         friend class GCodeReader;
@@ -104,10 +109,9 @@ public:
     template<typename Callback>
     const char* parse_line(const char *ptr, GCodeLine &gline, Callback &callback)
     {
-        std::pair<const char*, const char*> cmd;
-        const char *end = parse_line_internal(ptr, gline, cmd);
+        const char *end = parse_line_internal(ptr, gline);
         callback(*this, gline);
-        update_coordinates(gline, cmd);
+        update_coordinates(gline);
         return end;
     }
 
@@ -133,8 +137,10 @@ public:
     void   set_extrusion_axis(char axis) { m_extrusion_axis = axis; }
 
 private:
-    const char* parse_line_internal(const char *ptr, GCodeLine &gline, std::pair<const char*, const char*> &command);
-    void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Tokenizes a single line without touching the state of the reader, thus it may be called from multiple threads.
+    const char* tokenize_line(const char *ptr, GCodeLine &gline) const;
+    const char* parse_line_internal(const char *ptr, GCodeLine &gline);
+    void        update_coordinates(const GCodeLine &gline);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
     static bool         is_end_of_line(char c)          { return c == '\r' || c == '\n' || c == 0; }
@@ -592,6 +592,38 @@ std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std
     return gcode.str();
 }
 
+std::string GCodeWriter::extrude_arc_to_xy(const Vec2d &point, const Vec2d &center_offset, double dE, bool ccw, const std::string &comment)
+{
+    assert(dE == dE);
+    m_pos.x() = point.x();
+    m_pos.y() = point.y();
+    bool is_extrude = m_tool->extrude(dE) != 0;
+
+    std::ostringstream gcode;
+    gcode << write_acceleration();
+    gcode << (ccw ? "G3 X" : "G2 X") << XYZ_NUM(point.x())
+        << " Y" << XYZ_NUM(point.y())
+        << " I" << XYZ_NUM(center_offset.x())
+        << " J" << XYZ_NUM(center_offset.y());
+    if (is_extrude)
+        gcode << " " << m_extrusion_axis << E_NUM(m_tool->E());
+    COMMENT(comment);
+    gcode << "\n";
+    return gcode.str();
+}
+
+size_t GCodeWriter::extrude_to_xy_size(const Vec2d &point, bool extrude, double E, const std::string &comment) const
+{
+    std::ostringstream gcode;
+    gcode << "G1 X" << XYZ_NUM(point.x())
+        << " Y" << XYZ_NUM(point.y());
+    if (extrude)
+        gcode << " " << m_extrusion_axis << E_NUM(E);
+    COMMENT(comment);
+    gcode << "\n";
+    return size_t(gcode.tellp());
+}
+
 std::string GCodeWriter::retract(bool before_wipe)
 {
     double factor = before_wipe ? m_tool->retract_before_wipe() : 1.;
@@ -22,6 +22,7 @@ public:
         multiple_extruders(false), m_extrusion_axis("E"), m_tool(nullptr),
         m_single_extruder_multi_material(false),
         m_last_acceleration(0), m_max_acceleration(0), m_last_fan_speed(0), 
+        m_last_temperature(0), m_last_temperature_with_offset(0),
         m_last_bed_temperature(0), m_last_bed_temperature_reached(true), 
         m_lifted(0)
         {}
@@ -46,6 +47,24 @@ public:
     std::string postamble() const;
     std::string set_temperature(int16_t temperature, bool wait = false, int tool = -1);
     std::string set_bed_temperature(uint32_t temperature, bool wait = false);
+    // Temperatures set last, saved and restored to re-emit the temperature changes of a layer exported from the GCodeExportCache.
+    struct TemperatureState {
+        int16_t temperature             { 0 };
+        int16_t temperature_with_offset { 0 };
+        int16_t bed_temperature         { 0 };
+        bool    bed_temperature_reached { true };
+        bool operator==(const TemperatureState &rhs) const { return temperature == rhs.temperature && temperature_with_offset == rhs.temperature_with_offset &&
+            bed_temperature == rhs.bed_temperature && bed_temperature_reached == rhs.bed_temperature_reached; }
+        bool operator!=(const TemperatureState &rhs) const { return ! (*this == rhs); }
+    };
+    TemperatureState get_temperature_state() const 
+        { return { m_last_temperature, m_last_temperature_with_offset, m_last_bed_temperature, m_last_bed_temperature_reached }; }
+    void        set_temperature_state(const TemperatureState &state) {
+        m_last_temperature              = state.temperature;
+        m_last_temperature_with_offset  = state.temperature_with_offset;
+        m_last_bed_temperature          = state.bed_temperature;
+        m_last_bed_temperature_reached  = state.bed_temperature_reached;
+    }
     uint8_t get_fan() { return m_last_fan_speed; }
     /// set fan at speed. Save it as current fan speed if !dont_save, and use tool default_tool if the internal m_tool is null (no toolchange done yet).
     std::string set_fan(uint8_t speed, bool dont_save = false, uint16_t default_tool = 0);
@@ -70,6 +89,11 @@ public:
     bool        will_move_z(double z) const;
     std::string extrude_to_xy(const Vec2d &point, double dE, const std::string &comment = std::string());
     std::string extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment = std::string());
+    // G2 (clockwise) or G3 (counter-clockwise) arc ending at point, center_offset is the arc center relative to the current position.
+    std::string extrude_arc_to_xy(const Vec2d &point, const Vec2d &center_offset, double dE, bool ccw, const std::string &comment = std::string());
+    // Size of the line extrude_to_xy() would emit with the resulting E value, without modifying the writer.
+    // Used to report the G-code size saved by the arc fitting.
+    size_t      extrude_to_xy_size(const Vec2d &point, bool extrude, double E, const std::string &comment = std::string()) const;
     std::string retract(bool before_wipe = false);
     std::string retract_for_toolchange(bool before_wipe = false);
     std::string unretract();
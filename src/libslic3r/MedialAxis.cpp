@@ -28,12 +28,16 @@ MedialAxis::build(Polylines &polylines)
 void
 MedialAxis::polyline_from_voronoi(const Lines& voronoi_edges, ThickPolylines* polylines)
 {
-    std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> > thickness;
     Lines lines = voronoi_edges;
-    VD vd;
+    // The diagram is rebuilt for each call, keep its memory for the next call on the same thread.
+    static thread_local VD vd;
+    vd.clear();
     construct_voronoi(lines.begin(), lines.end(), &vd);
 
     typedef const VD::edge_type   edge_t;
+    // Per-edge data are stored in flat arrays indexed by edge_idx().
+    const size_t num_edges = vd.edges().size();
+    std::vector<std::pair<coordf_t, coordf_t>> thickness(num_edges, std::make_pair(0., 0.));
     
     // DEBUG: dump all Voronoi edges
     //{
@@ -59,36 +63,41 @@ MedialAxis::polyline_from_voronoi(const Lines& voronoi_edges, ThickPolylines* po
     
     // collect valid edges (i.e. prune those not belonging to MAT)
     // note: this keeps twins, so it inserts twice the number of the valid edges
-    std::set<const VD::edge_type*> valid_edges;
+    std::vector<bool> valid_edges(num_edges, false);
     {
-        std::set<const edge_t*> seen_edges;
+        std::vector<bool> seen_edges(num_edges, false);
         for (VD::const_edge_iterator edge = vd.edges().begin(); edge != vd.edges().end(); ++edge) {
             // if we only process segments representing closed loops, none if the
             // infinite edges (if any) would be part of our MAT anyway
             if (edge->is_secondary() || edge->is_infinite()) continue;
         
             // don't re-validate twins
-            if (seen_edges.find(&*edge) != seen_edges.end()) continue;  // TODO: is this needed?
-            seen_edges.insert(&*edge);
-            seen_edges.insert(edge->twin());
+            if (seen_edges[edge_idx(vd, &*edge)]) continue;  // TODO: is this needed?
+            seen_edges[edge_idx(vd, &*edge)] = true;
+            seen_edges[edge_idx(vd, edge->twin())] = true;
             
-            if (!this->validate_edge(&*edge, lines, thickness)) continue;
-            valid_edges.insert(&*edge);
-            valid_edges.insert(edge->twin());
+            if (!this->validate_edge(vd, &*edge, lines, thickness)) continue;
+            valid_edges[edge_idx(vd, &*edge)] = true;
+            valid_edges[edge_idx(vd, edge->twin())] = true;
         }
     }
-    std::set<const VD::edge_type*> edges = valid_edges;
+    // edges not yet added to a polyline
+    std::vector<bool> edges = valid_edges;
     
-    // iterate through the valid edges to build polylines
-    while (!edges.empty()) {
-        const edge_t* edge = *edges.begin();
-        if (thickness[edge].first > this->max_width*1.001) {
+    // iterate through the valid edges to build polylines, in the order of the edges in the diagram
+    for (size_t next_edge_idx = 0;; ) {
+        while (next_edge_idx < num_edges && ! edges[next_edge_idx])
+            ++ next_edge_idx;
+        if (next_edge_idx == num_edges)
+            break;
+        const edge_t* edge = &vd.edges()[next_edge_idx];
+        if (thickness[next_edge_idx].first > this->max_width*1.001) {
             //std::cerr << "Error, edge.first has a thickness of " << unscaled(this->thickness[edge].first) << " > " << unscaled(this->max_width) << "\n";
             //(void)this->edges.erase(edge);
             //(void)this->edges.erase(edge->twin());
             //continue;
         }
-        if (thickness[edge].second > this->max_width*1.001) {
+        if (thickness[next_edge_idx].second > this->max_width*1.001) {
             //std::cerr << "Error, edge.second has a thickness of " << unscaled(this->thickness[edge].second) << " > " << unscaled(this->max_width) << "\n";
             //(void)this->edges.erase(edge);
             //(void)this->edges.erase(edge->twin());
@@ -99,20 +108,20 @@ MedialAxis::polyline_from_voronoi(const Lines& voronoi_edges, ThickPolylines* po
         ThickPolyline polyline;
         polyline.points.push_back(Point( edge->vertex0()->x(), edge->vertex0()->y() ));
         polyline.points.push_back(Point( edge->vertex1()->x(), edge->vertex1()->y() ));
-        polyline.width.push_back(thickness[edge].first);
-        polyline.width.push_back(thickness[edge].second);
+        polyline.width.push_back(thickness[next_edge_idx].first);
+        polyline.width.push_back(thickness[next_edge_idx].second);
         
         // remove this edge and its twin from the available edges
-        (void)edges.erase(edge);
-        (void)edges.erase(edge->twin());
+        edges[next_edge_idx] = false;
+        edges[edge_idx(vd, edge->twin())] = false;
         
         // get next points
-        this->process_edge_neighbors(edge, &polyline, edges, valid_edges, thickness);
+        this->process_edge_neighbors(vd, edge, &polyline, edges, valid_edges, thickness);
         
         // get previous points
         {
             ThickPolyline rpolyline;
-            this->process_edge_neighbors(edge->twin(), &rpolyline, edges, valid_edges, thickness);
+            this->process_edge_neighbors(vd, edge->twin(), &rpolyline, edges, valid_edges, thickness);
             polyline.points.insert(polyline.points.begin(), rpolyline.points.rbegin(), rpolyline.points.rend());
             polyline.width.insert(polyline.width.begin(), rpolyline.width.rbegin(), rpolyline.width.rend());
             polyline.endpoints.first = rpolyline.endpoints.second;
@@ -148,7 +157,7 @@ MedialAxis::polyline_from_voronoi(const Lines& voronoi_edges, ThickPolylines* po
 }
 
 void
-MedialAxis::process_edge_neighbors(const VD::edge_type* edge, ThickPolyline* polyline, std::set<const VD::edge_type*> &edges, std::set<const VD::edge_type*> &valid_edges, std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> > &thickness)
+MedialAxis::process_edge_neighbors(const VD &vd, const VD::edge_type* edge, ThickPolyline* polyline, std::vector<bool> &edges, const std::vector<bool> &valid_edges, const std::vector<std::pair<coordf_t, coordf_t>> &thickness)
 {
     while (true) {
         // Since rot_next() works on the edge starting point but we want
@@ -160,7 +169,7 @@ MedialAxis::process_edge_neighbors(const VD::edge_type* edge, ThickPolyline* pol
         std::vector<const VD::edge_type*> neighbors;
         for (const VD::edge_type* neighbor = twin->rot_next(); neighbor != twin;
             neighbor = neighbor->rot_next()) {
-            if (valid_edges.count(neighbor) > 0) neighbors.push_back(neighbor);
+            if (valid_edges[edge_idx(vd, neighbor)]) neighbors.push_back(neighbor);
         }
     
         // if we have a single neighbor then we can continue recursively
@@ -168,14 +177,14 @@ MedialAxis::process_edge_neighbors(const VD::edge_type* edge, ThickPolyline* pol
             const VD::edge_type* neighbor = neighbors.front();
             
             // break if this is a closed loop
-            if (edges.count(neighbor) == 0) return;
+            if (! edges[edge_idx(vd, neighbor)]) return;
             
             Point new_point(neighbor->vertex1()->x(), neighbor->vertex1()->y());
             polyline->points.push_back(new_point);
-            polyline->width.push_back(thickness[neighbor].second);
+            polyline->width.push_back(thickness[edge_idx(vd, neighbor)].second);
             
-            (void)edges.erase(neighbor);
-            (void)edges.erase(neighbor->twin());
+            edges[edge_idx(vd, neighbor)] = false;
+            edges[edge_idx(vd, neighbor->twin())] = false;
             edge = neighbor;
         } else if (neighbors.size() == 0) {
             polyline->endpoints.second = true;
@@ -188,7 +197,7 @@ MedialAxis::process_edge_neighbors(const VD::edge_type* edge, ThickPolyline* pol
 }
 
 bool
-MedialAxis::validate_edge(const VD::edge_type* edge, Lines &lines, std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> > &thickness)
+MedialAxis::validate_edge(const VD &vd, const VD::edge_type* edge, Lines &lines, std::vector<std::pair<coordf_t, coordf_t>> &thickness)
 {
     // prevent overflows and detect almost-infinite edges
     if (std::abs(edge->vertex0()->x()) > double(CLIPPER_MAX_COORD_UNSCALED) ||
@@ -301,8 +310,8 @@ MedialAxis::validate_edge(const VD::edge_type* edge, Lines &lines, std::map<cons
     if (w0 > this->max_width*1.05 && w1 > this->max_width*1.05)
         return false;
     
-    thickness[edge]         = std::make_pair(w0, w1);
-    thickness[edge->twin()] = std::make_pair(w1, w0);
+    thickness[edge_idx(vd, edge)]         = std::make_pair(w0, w1);
+    thickness[edge_idx(vd, edge->twin())] = std::make_pair(w1, w0);
     
     return true;
 }
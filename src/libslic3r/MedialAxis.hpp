@@ -74,8 +74,10 @@ class MedialAxis {
             typedef boost::polygon::segment_data<coordinate_type>   segment_type;
             typedef boost::polygon::rectangle_data<coordinate_type> rect_type;
         };
-        void process_edge_neighbors(const VD::edge_type* edge, ThickPolyline* polyline, std::set<const VD::edge_type*> &edges, std::set<const VD::edge_type*> &valid_edges, std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> > &thickness);
-        bool validate_edge(const VD::edge_type* edge, Lines &lines, std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> > &thickness);
+        /// index of the edge in vd.edges(), used to store the per-edge data in flat arrays instead of maps keyed by the edge pointer
+        static size_t edge_idx(const VD &vd, const VD::edge_type* edge) { return size_t(edge - vd.edges().data()); }
+        void process_edge_neighbors(const VD &vd, const VD::edge_type* edge, ThickPolyline* polyline, std::vector<bool> &edges, const std::vector<bool> &valid_edges, const std::vector<std::pair<coordf_t, coordf_t>> &thickness);
+        bool validate_edge(const VD &vd, const VD::edge_type* edge, Lines &lines, std::vector<std::pair<coordf_t, coordf_t>> &thickness);
         const Line& retrieve_segment(const VD::cell_type* cell, Lines& lines) const;
         const Point& retrieve_endpoint(const VD::cell_type* cell, Lines& lines) const;
         void polyline_from_voronoi(const Lines& voronoi_edges, ThickPolylines* polylines_out);
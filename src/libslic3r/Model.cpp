@@ -15,6 +15,7 @@
 #include "Format/3mf.hpp"
 
 #include <float.h>
+#include <atomic>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -246,6 +247,21 @@ ModelObject* Model::add_object(const char *name, const char *path, TriangleMesh
     return new_object;
 }
 
+ModelObject* Model::add_object(const char *name, const char *path, TriangleMesh &&mesh, TriangleMesh &&convex_hull)
+{
+    ModelObject* new_object = new ModelObject(this);
+    this->objects.push_back(new_object);
+    new_object->name = name;
+    new_object->input_file = path;
+    ModelVolume *new_volume = new_object->add_volume(std::move(mesh), std::move(convex_hull));
+    new_volume->name = name;
+    new_volume->source.input_file = path;
+    new_volume->source.object_idx = (int)this->objects.size() - 1;
+    new_volume->source.volume_idx = (int)new_object->volumes.size() - 1;
+    new_object->invalidate_bounding_box();
+    return new_object;
+}
+
 ModelObject* Model::add_object(const ModelObject &other)
 {
 	ModelObject* new_object = ModelObject::new_clone(other);
@@ -254,6 +270,15 @@ ModelObject* Model::add_object(const ModelObject &other)
     return new_object;
 }
 
+ModelObject* Model::add_object_copy(const ModelObject &other)
+{
+    assert(std::find_if(this->objects.begin(), this->objects.end(), [&other](const ModelObject *o) { return o->id() == other.id(); }) == this->objects.end());
+    ModelObject* new_object = ModelObject::new_copy(other);
+    new_object->set_model(this);
+    this->objects.push_back(new_object);
+    return new_object;
+}
+
 void Model::delete_object(size_t idx)
 {
     ModelObjectPtrs::iterator i = this->objects.begin() + idx;
@@ -700,6 +725,15 @@ ModelVolume* ModelObject::add_volume(TriangleMesh &&mesh, bool centered)
     return v;
 }
 
+ModelVolume* ModelObject::add_volume(TriangleMesh &&mesh, TriangleMesh &&convex_hull, bool centered)
+{
+    ModelVolume* v = new ModelVolume(this, std::move(mesh), std::move(convex_hull));
+    this->volumes.push_back(v);
+    if(centered) v->center_geometry_after_creation();
+    this->invalidate_bounding_box();
+    return v;
+}
+
 ModelVolume* ModelObject::add_volume(const ModelVolume &other, bool centered)
 {
     ModelVolume* v = new ModelVolume(this, other);
@@ -887,6 +921,20 @@ TriangleMesh ModelObject::full_raw_mesh() const
     return mesh;
 }
 
+// The convex hull of a volume contains all the extreme vertices of its mesh, therefore the transformed bounding box
+// and the 2D convex hull of the projection are the same whether calculated from the convex hull or from the mesh,
+// while the convex hull has a small fraction of the mesh vertices.
+// The mesh is returned if the convex hull is not available or if it does not match the mesh.
+static const TriangleMesh& volume_hull_or_mesh(const ModelVolume &volume)
+{
+    const TriangleMesh                  &mesh = volume.mesh();
+    std::shared_ptr<const TriangleMesh>  hull = volume.get_convex_hull_shared_ptr();
+    if (hull && ! hull->empty() && hull->has_shared_vertices() && 
+        hull->stl.stats.min == mesh.stl.stats.min && hull->stl.stats.max == mesh.stl.stats.max)
+        return *hull;
+    return mesh;
+}
+
 const BoundingBoxf3& ModelObject::raw_mesh_bounding_box() const
 {
     if (! m_raw_mesh_bounding_box_valid) {
@@ -894,7 +942,7 @@ const BoundingBoxf3& ModelObject::raw_mesh_bounding_box() const
         m_raw_mesh_bounding_box.reset();
         for (const ModelVolume *v : this->volumes)
             if (v->is_model_part())
-                m_raw_mesh_bounding_box.merge(v->mesh().transformed_bounding_box(v->get_matrix()));
+                m_raw_mesh_bounding_box.merge(volume_hull_or_mesh(*v).transformed_bounding_box(v->get_matrix()));
     }
     return m_raw_mesh_bounding_box;
 }
@@ -903,7 +951,7 @@ BoundingBoxf3 ModelObject::full_raw_mesh_bounding_box() const
 {
 	BoundingBoxf3 bb;
 	for (const ModelVolume *v : this->volumes)
-		bb.merge(v->mesh().transformed_bounding_box(v->get_matrix()));
+		bb.merge(volume_hull_or_mesh(*v).transformed_bounding_box(v->get_matrix()));
 	return bb;
 }
 
@@ -921,7 +969,7 @@ const BoundingBoxf3& ModelObject::raw_bounding_box() const
         for (const ModelVolume *v : this->volumes)
         {
             if (v->is_model_part())
-                m_raw_bounding_box.merge(v->mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
+                m_raw_bounding_box.merge(volume_hull_or_mesh(*v).transformed_bounding_box(inst_matrix * v->get_matrix()));
         }
     }
 	return m_raw_bounding_box;
@@ -930,14 +978,36 @@ const BoundingBoxf3& ModelObject::raw_bounding_box() const
 // This returns an accurate snug bounding box of the transformed object instance, without the translation applied.
 BoundingBoxf3 ModelObject::instance_bounding_box(size_t instance_idx, bool dont_translate) const
 {
-    BoundingBoxf3 bb;
-    const Transform3d& inst_matrix = this->instances[instance_idx]->get_transformation().get_matrix(dont_translate);
-    for (ModelVolume *v : this->volumes)
-    {
-        if (v->is_model_part())
-            bb.merge(v->mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
-        }
-    return bb;
+    const ModelInstance &instance    = *this->instances[instance_idx];
+    const Transform3d   &inst_matrix = instance.get_transformation().get_matrix(dont_translate);
+    ModelInstance::BoundingBoxMemo &memo = instance.m_bounding_box_memo[dont_translate ? 1 : 0];
+    // Is the memoized bounding box still valid?
+    bool valid = memo.valid && memo.trafo.matrix() == inst_matrix.matrix();
+    if (valid) {
+        auto it_memo = memo.volumes.begin();
+        for (const ModelVolume *v : this->volumes)
+            if (v->is_model_part()) {
+                if (it_memo == memo.volumes.end() || it_memo->id != v->id() || it_memo->mesh_revision != v->mesh_revision() || 
+                    it_memo->trafo.matrix() != v->get_matrix().matrix()) {
+                    valid = false;
+                    break;
+                }
+                ++ it_memo;
+            }
+        valid &= it_memo == memo.volumes.end();
+    }
+    if (! valid) {
+        memo.valid = true;
+        memo.trafo = inst_matrix;
+        memo.volumes.clear();
+        memo.bbox.reset();
+        for (const ModelVolume *v : this->volumes)
+            if (v->is_model_part()) {
+                memo.volumes.push_back({ v->id(), v->mesh_revision(), v->get_matrix() });
+                memo.bbox.merge(volume_hull_or_mesh(*v).transformed_bounding_box(inst_matrix * v->get_matrix()));
+            }
+    }
+    return memo.bbox;
 }
 
 // Calculate 2D convex hull of of a projection of the transformed printable volumes into the XY plane.
@@ -949,10 +1019,11 @@ Polygon ModelObject::convex_hull_2d(const Transform3d &trafo_instance) const
     for (const ModelVolume *v : this->volumes)
         if (v->is_model_part()) {
             Transform3d trafo = trafo_instance * v->get_matrix();
-			const indexed_triangle_set &its = v->mesh().its;
+            const TriangleMesh         &mesh = volume_hull_or_mesh(*v);
+			const indexed_triangle_set &its  = mesh.its;
 			if (its.vertices.empty()) {
                 // Using the STL faces.
-				const stl_file& stl = v->mesh().stl;
+				const stl_file& stl = mesh.stl;
 				for (const stl_facet &facet : stl.facet_start)
                     for (size_t j = 0; j < 3; ++ j) {
                         Vec3d p = trafo * facet.vertex[j].cast<double>();
@@ -1679,6 +1750,9 @@ void ModelVolume::center_geometry_after_creation(bool update_source_offset)
         	const_cast<TriangleMesh*>(m_mesh.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
         if (m_convex_hull)
 			const_cast<TriangleMesh*>(m_convex_hull.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
+        m_mesh_revision = next_mesh_revision();
+        // Translating the mesh restored its STL facets.
+        this->release_mesh_facets();
         translate(shift);
     }
 
@@ -1686,6 +1760,12 @@ void ModelVolume::center_geometry_after_creation(bool update_source_offset)
         source.mesh_offset = shift;
 }
 
+uint64_t ModelVolume::next_mesh_revision()
+{
+    static std::atomic<uint64_t> last_revision { 0 };
+    return ++ last_revision;
+}
+
 void ModelVolume::calculate_convex_hull()
 {
     m_convex_hull = std::make_shared<TriangleMesh>(this->mesh().convex_hull_3d());
@@ -1851,15 +1931,18 @@ void ModelVolume::scale_geometry_after_creation(const Vec3d& versor)
 {
 	const_cast<TriangleMesh*>(m_mesh.get())->scale(versor);
 	const_cast<TriangleMesh*>(m_convex_hull.get())->scale(versor);
+    m_mesh_revision = next_mesh_revision();
+    // Scaling the mesh restored its STL facets.
+    this->release_mesh_facets();
 }
 
 void ModelVolume::transform_this_mesh(const Transform3d &mesh_trafo, bool fix_left_handed)
 {
 	TriangleMesh mesh = this->mesh();
 	mesh.transform(mesh_trafo, fix_left_handed);
-	this->set_mesh(std::move(mesh));
     TriangleMesh convex_hull = this->get_convex_hull();
     convex_hull.transform(mesh_trafo, fix_left_handed);
+	this->set_mesh(std::move(mesh));
     this->m_convex_hull = std::make_shared<TriangleMesh>(std::move(convex_hull));
     // Let the rest of the application know that the geometry changed, so the meshes have to be reloaded.
     this->set_new_unique_id();
@@ -1869,9 +1952,9 @@ void ModelVolume::transform_this_mesh(const Matrix3d &matrix, bool fix_left_hand
 {
 	TriangleMesh mesh = this->mesh();
 	mesh.transform(matrix, fix_left_handed);
-	this->set_mesh(std::move(mesh));
     TriangleMesh convex_hull = this->get_convex_hull();
     convex_hull.transform(matrix, fix_left_handed);
+	this->set_mesh(std::move(mesh));
     this->m_convex_hull = std::make_shared<TriangleMesh>(std::move(convex_hull));
     // Let the rest of the application know that the geometry changed, so the meshes have to be reloaded.
     this->set_new_unique_id();
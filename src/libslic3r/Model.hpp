@@ -271,6 +271,8 @@ public:
 
     ModelVolume*            add_volume(const TriangleMesh &mesh, bool centered = true);
     ModelVolume*            add_volume(TriangleMesh &&mesh, bool centered = true);
+    // Add a volume with an already calculated convex hull of the mesh, for example calculated in parallel by a file importer.
+    ModelVolume*            add_volume(TriangleMesh &&mesh, TriangleMesh &&convex_hull, bool centered = true);
     ModelVolume*            add_volume(const ModelVolume &volume, bool centered = true);
     ModelVolume*            add_volume(const ModelVolume &volume, TriangleMesh &&mesh, bool centered = true);
     void                    delete_volume(size_t idx);
@@ -575,12 +577,15 @@ public:
     Source              source;
 
     // The triangular model.
+    // Replacing the mesh releases the convex hull, which no longer matches the mesh. Call calculate_convex_hull() to recalculate it.
     const TriangleMesh& mesh() const { return *m_mesh.get(); }
-    void                set_mesh(const TriangleMesh &mesh) { m_mesh = std::make_shared<const TriangleMesh>(mesh); }
-    void                set_mesh(TriangleMesh &&mesh) { m_mesh = std::make_shared<const TriangleMesh>(std::move(mesh)); }
-    void                set_mesh(std::shared_ptr<const TriangleMesh> &mesh) { m_mesh = mesh; }
-    void                set_mesh(std::unique_ptr<const TriangleMesh> &&mesh) { m_mesh = std::move(mesh); }
-	void				reset_mesh() { m_mesh = std::make_shared<const TriangleMesh>(); }
+    void                set_mesh(const TriangleMesh &mesh) { m_mesh = std::make_shared<const TriangleMesh>(mesh); this->mesh_replaced(); }
+    void                set_mesh(TriangleMesh &&mesh) { m_mesh = std::make_shared<const TriangleMesh>(std::move(mesh)); this->mesh_replaced(); }
+    void                set_mesh(std::shared_ptr<const TriangleMesh> &mesh) { m_mesh = mesh; this->mesh_replaced(); }
+    void                set_mesh(std::unique_ptr<const TriangleMesh> &&mesh) { m_mesh = std::move(mesh); this->mesh_replaced(); }
+	void				reset_mesh() { m_mesh = std::make_shared<const TriangleMesh>(); this->mesh_replaced(); }
+    // Unique number of the current state of the mesh, changes whenever the mesh is replaced or modified in place.
+    uint64_t            mesh_revision() const { return m_mesh_revision; }
     // Configuration parameters specific to an object model geometry or a modifier volume, 
     // overriding the global Slic3r settings and the ModelObject settings.
     ModelConfigObject	config;
@@ -706,6 +711,14 @@ private:
     // The convex hull of this model's mesh.
     std::shared_ptr<const TriangleMesh> m_convex_hull;
     Geometry::Transformation        	m_transformation;
+    // Revision of m_mesh, unique over all the volumes, see mesh_revision().
+    uint64_t                            m_mesh_revision { next_mesh_revision() };
+
+    static uint64_t next_mesh_revision();
+    void            mesh_replaced() { m_convex_hull.reset(); m_mesh_revision = next_mesh_revision(); this->release_mesh_facets(); }
+    // A repaired mesh of a volume keeps just its indexed triangle set, the STL facets are rebuilt on demand
+    // by TriangleMesh::restore_facets(). Only a mesh not shared with anyone else is modified.
+    void            release_mesh_facets() { if (m_mesh && m_mesh.use_count() == 1) const_cast<TriangleMesh*>(m_mesh.get())->release_facets(); }
 
     // flag to optimize the checking if the volume is splittable
     //     -1   ->   is unknown value (before first cheking)
@@ -724,6 +737,7 @@ private:
         assert(this->id() != this->seam_facets.id());
         if (mesh.stl.stats.number_of_facets > 1)
             calculate_convex_hull();
+        this->release_mesh_facets();
     }
     ModelVolume(ModelObject *object, TriangleMesh &&mesh, TriangleMesh &&convex_hull) :
 		m_mesh(new TriangleMesh(std::move(mesh))), m_convex_hull(new TriangleMesh(std::move(convex_hull))), m_type(ModelVolumeType::MODEL_PART), object(object) {
@@ -734,6 +748,7 @@ private:
         assert(this->id() != this->config.id());
         assert(this->id() != this->supported_facets.id());
         assert(this->id() != this->seam_facets.id());
+        this->release_mesh_facets();
 	}
 
     // Copying an existing volume, therefore this volume will get a copy of the ID assigned.
@@ -773,6 +788,7 @@ private:
         this->config.set_new_unique_id();
         if (mesh.stl.stats.number_of_facets > 1)
             calculate_convex_hull();
+        this->release_mesh_facets();
 		assert(this->config.id().valid()); 
         assert(this->config.id() != other.config.id()); 
         assert(this->supported_facets.id() != other.supported_facets.id());
@@ -800,6 +816,7 @@ private:
         cereal::load_by_value(ar, seam_facets);
         cereal::load_by_value(ar, config);
 		assert(m_mesh);
+		m_mesh_revision = next_mesh_revision();
 		if (has_convex_hull) {
 			cereal::load_optional(ar, m_convex_hull);
 			if (! m_convex_hull && ! m_mesh->empty())
@@ -916,6 +933,22 @@ private:
     // Parent object, owning this instance.
     ModelObject* object;
 
+    // Memoized result of ModelObject::instance_bounding_box(), one for dont_translate == false, one for dont_translate == true.
+    // The memo is validated against the instance transformation and the IDs, meshes and transformations of the model parts
+    // it was calculated from, thus it does not need to be invalidated explicitly.
+    struct BoundingBoxMemo {
+        struct Volume {
+            ObjectID            id;
+            uint64_t            mesh_revision;
+            Transform3d         trafo;
+        };
+        bool                    valid { false };
+        Transform3d             trafo;
+        std::vector<Volume>     volumes;
+        BoundingBoxf3           bbox;
+    };
+    mutable BoundingBoxMemo m_bounding_box_memo[2];
+
     // Constructor, which assigns a new unique ID.
     explicit ModelInstance(ModelObject* object) : print_volume_state(ModelInstancePVS_Inside), printable(true), object(object) { assert(this->id().valid()); }
     // Constructor, which assigns a new unique ID.
@@ -1018,7 +1051,12 @@ public:
     ModelObject* add_object();
     ModelObject* add_object(const char *name, const char *path, const TriangleMesh &mesh);
     ModelObject* add_object(const char *name, const char *path, TriangleMesh &&mesh);
+    // Add an object with an already calculated convex hull of the mesh, for example calculated in parallel when loading multiple files.
+    ModelObject* add_object(const char *name, const char *path, TriangleMesh &&mesh, TriangleMesh &&convex_hull);
     ModelObject* add_object(const ModelObject &other);
+    // Copy the object keeping its ID and the IDs of its volumes and instances, so that a Print
+    // the object was applied to before recognizes it. The IDs must not be present in this model yet.
+    ModelObject* add_object_copy(const ModelObject &other);
     void         delete_object(size_t idx);
     bool         delete_object(ObjectID id);
     bool         delete_object(ModelObject* object);
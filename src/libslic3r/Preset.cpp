@@ -39,6 +39,8 @@
 #include <boost/locale.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include "libslic3r.h"
 #include "Utils.hpp"
 #include "PlaceholderParser.hpp"
@@ -84,8 +86,12 @@ ConfigFileType guess_config_file_type(const ptree &tree)
 VendorProfile VendorProfile::from_ini(const boost::filesystem::path &path, bool load_all)
 {
     ptree tree;
-    boost::filesystem::ifstream ifs(path);
-    boost::property_tree::read_ini(ifs, tree);
+    std::string data;
+    {
+        boost::filesystem::ifstream ifs(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    read_ini_tree(data, tree);
     return VendorProfile::from_ini(tree, path, load_all);
 }
 
@@ -599,7 +605,7 @@ const std::vector<std::string>& Preset::print_options()
         "hole_to_polyhole",
         "hole_to_polyhole_threshold",
         "hole_to_polyhole_twisted",
-        "threads",
+        "slicing_threads",
         // wipe tower
         "wipe_tower", "wipe_tower_x", "wipe_tower_y", "wipe_tower_width", "wipe_tower_rotation_angle", "wipe_tower_bridging",
         "wipe_tower_brim",
@@ -729,6 +735,8 @@ const std::vector<std::string>& Preset::printer_options()
             "gcode_flavor",
             "gcode_precision_xyz",
             "gcode_precision_e",
+            "arc_fitting",
+            "arc_fitting_tolerance",
             "use_relative_e_distances",
             "use_firmware_retraction", "use_volumetric_e", "variable_layer_height",
             "min_length",
@@ -823,6 +831,7 @@ const std::vector<std::string>& Preset::sla_print_options()
             "hollowing_quality",
             "hollowing_closing_distance",
             "output_filename_format",
+            "slicing_threads",
             "default_sla_print_profile",
             "compatible_printers",
             "compatible_printers_condition",
@@ -954,15 +963,21 @@ void PresetCollection::load_presets(
                 BOOST_LOG_TRIVIAL(warning) << "Preset already present, not loading: " << name;
                 continue;
             }
+            Preset &preset = presets_loaded.emplace_back(m_type, name, false);
+            preset.file = dir_entry.path().string();
+        }
+    // Parse the preset files in parallel. The results are collected in the order of the directory listing.
+    std::vector<ConfigSubstitutions> presets_substitutions(presets_loaded.size());
+    std::vector<std::string>         presets_errors(presets_loaded.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, presets_loaded.size()),
+        [this, &presets_loaded, &presets_substitutions, &presets_errors, substitution_rule](const tbb::blocked_range<size_t> &range) {
+        for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+            Preset &preset = presets_loaded[idx];
             try {
-                Preset preset(m_type, name, false);
-                preset.file = dir_entry.path().string();
                 // Load the preset file, apply preset values on top of defaults.
                 try {
                     DynamicPrintConfig config;
-                    ConfigSubstitutions config_substitutions = config.load_from_ini(preset.file, substitution_rule);
-                    if (! config_substitutions.empty())
-                        substitutions.push_back({ preset.name, m_type, PresetConfigSubstitutions::Source::UserFile, preset.file, std::move(config_substitutions) });
+                    presets_substitutions[idx] = config.load_from_ini(preset.file, substitution_rule);
                     // Find a default preset for the config. The PrintPresetCollection provides different default preset based on the "printer_technology" field.
                     const Preset &default_preset = this->default_preset_for(config);
                     preset.config = default_preset.config;
@@ -979,12 +994,22 @@ void PresetCollection::load_presets(
                 } catch (const std::runtime_error &err) {
                     throw Slic3r::RuntimeError(std::string("Failed loading the preset file: ") + preset.file + "\n\tReason: " + err.what());
                 }
-                presets_loaded.emplace_back(preset);
             } catch (const std::runtime_error &err) {
-                errors_cummulative += err.what();
-                errors_cummulative += "\n";
+                presets_errors[idx] = err.what();
             }
         }
+    });
+    for (size_t idx = 0; idx < presets_loaded.size(); ++ idx) {
+        const Preset &preset = presets_loaded[idx];
+        if (! presets_substitutions[idx].empty())
+            substitutions.push_back({ preset.name, m_type, PresetConfigSubstitutions::Source::UserFile, preset.file, std::move(presets_substitutions[idx]) });
+        if (! presets_errors[idx].empty()) {
+            errors_cummulative += presets_errors[idx];
+            errors_cummulative += "\n";
+        }
+    }
+    // Drop the presets, which failed to load.
+    presets_loaded.erase(std::remove_if(presets_loaded.begin(), presets_loaded.end(), [](const Preset &preset) { return ! preset.loaded; }), presets_loaded.end());
     m_presets.insert(m_presets.end(), std::make_move_iterator(presets_loaded.begin()), std::make_move_iterator(presets_loaded.end()));
     std::sort(m_presets.begin() + m_num_default_presets, m_presets.end());
     if(this->type() == Preset::Type::TYPE_PRINTER)
@@ -2,11 +2,14 @@
 
 #include "PresetBundle.hpp"
 #include "libslic3r.h"
+#include "libslic3r_version.h"
 #include "Utils.hpp"
 #include "Model.hpp"
 #include "format.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <set>
 #include <fstream>
 #include <unordered_set>
@@ -22,6 +25,8 @@
 #include <boost/locale.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/parallel_for.h>
+
 
 // Store the print/filament/printer presets into a "presets" subdirectory of the Slic3r config dir.
 // This breaks compatibility with the upstream Slic3r if the --datadir is used to switch between the two versions.
@@ -167,7 +172,9 @@ PresetsConfigSubstitutions PresetBundle::load_presets(AppConfig &config, Forward
     // First load the vendor specific system presets.
     PresetsConfigSubstitutions substitutions;
     std::string errors_cummulative;
+    auto time_start = std::chrono::steady_clock::now();
     std::tie(substitutions, errors_cummulative) = this->load_system_presets(substitution_rule);
+    auto time_system_presets = std::chrono::steady_clock::now();
 
     const std::string dir_user_presets = data_dir()
 #ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
@@ -208,6 +215,10 @@ PresetsConfigSubstitutions PresetBundle::load_presets(AppConfig &config, Forward
     } catch (const std::runtime_error &err) {
         errors_cummulative += err.what();
     }
+    auto time_user_presets = std::chrono::steady_clock::now();
+    BOOST_LOG_TRIVIAL(info) << "Presets loaded: system presets in " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(time_system_presets - time_start).count() << "ms, user presets in " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(time_user_presets - time_system_presets).count() << "ms";
     this->update_multi_material_filament_presets();
     this->update_compatible(PresetSelectCompatibleType::Never);
     if (! errors_cummulative.empty())
@@ -234,37 +245,70 @@ std::pair<PresetsConfigSubstitutions, std::string> PresetBundle::load_system_pre
     PresetsConfigSubstitutions  substitutions;
     std::string                 errors_cummulative;
     bool                        first = true;
+    std::vector<boost::filesystem::path> paths;
     for (auto &dir_entry : boost::filesystem::directory_iterator(dir))
-        if (Slic3r::is_ini_file(dir_entry)) {
-            std::string name = dir_entry.path().filename().string();
-            // Remove the .ini suffix.
-            name.erase(name.size() - 4);
+        if (Slic3r::is_ini_file(dir_entry))
+            paths.emplace_back(dir_entry.path());
+
+    // Load and flatten the config bundles in parallel, each into its own PresetBundle. The first one is loaded into this PresetBundle,
+    // which resets it. The other vendor configs are then merged with this PresetBundle in the order of the directory listing.
+    struct BundleLoaded {
+        std::unique_ptr<PresetBundle> bundle;
+        PresetsConfigSubstitutions    substitutions;
+        std::string                   error;
+    };
+    std::vector<BundleLoaded> bundles(paths.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size()), [this, &paths, &bundles, compatibility_rule](const tbb::blocked_range<size_t> &range) {
+        for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+            BundleLoaded &loaded = bundles[idx];
             try {
-                // Load the config bundle, flatten it.
-                if (first) {
-                    // Reset this PresetBundle and load the first vendor config.
-                    append(substitutions, this->load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
-                    first = false;
-                } else {
-                    // Load the other vendor configs, merge them with this PresetBundle.
-                    // Report duplicate profiles.
-                    PresetBundle other;
-                    append(substitutions, other.load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
-                    std::vector<std::string> duplicates = this->merge_presets(std::move(other));
-                    if (! duplicates.empty()) {
-                        errors_cummulative += "Vendor configuration file " + name + " contains the following presets with names used by other vendors: ";
-                        for (size_t i = 0; i < duplicates.size(); ++ i) {
-                            if (i > 0)
-                                errors_cummulative += ", ";
-                            errors_cummulative += duplicates[i];
-                        }
-                    }
+                PresetBundle *bundle = this;
+                if (idx > 0) {
+                    loaded.bundle = std::make_unique<PresetBundle>();
+                    bundle = loaded.bundle.get();
                 }
+                loaded.substitutions = bundle->load_configbundle(paths[idx].string(), PresetBundle::LoadSystem, compatibility_rule).first;
             } catch (const std::runtime_error &err) {
-                errors_cummulative += err.what();
-                errors_cummulative += "\n";
+                loaded.error = err.what();
+                // Don't merge a partially loaded bundle.
+                loaded.bundle.reset();
             }
         }
+    });
+
+    for (size_t idx = 0; idx < paths.size(); ++ idx) {
+        BundleLoaded &loaded = bundles[idx];
+        std::string name = paths[idx].filename().string();
+        // Remove the .ini suffix.
+        name.erase(name.size() - 4);
+        append(substitutions, std::move(loaded.substitutions));
+        if (! loaded.error.empty()) {
+            errors_cummulative += loaded.error;
+            errors_cummulative += "\n";
+        }
+        if (idx == 0) {
+            // The first vendor config has been loaded into this PresetBundle.
+            if (loaded.error.empty())
+                first = false;
+        } else if (loaded.bundle) {
+            if (first) {
+                // Loading the first vendor config failed, reset this PresetBundle.
+                this->reset(false);
+                first = false;
+            }
+            // Merge the other vendor configs with this PresetBundle.
+            // Report duplicate profiles.
+            std::vector<std::string> duplicates = this->merge_presets(std::move(*loaded.bundle));
+            if (! duplicates.empty()) {
+                errors_cummulative += "Vendor configuration file " + name + " contains the following presets with names used by other vendors: ";
+                for (size_t i = 0; i < duplicates.size(); ++ i) {
+                    if (i > 0)
+                        errors_cummulative += ", ";
+                    errors_cummulative += duplicates[i];
+                }
+            }
+        }
+    }
     if (first) {
 		// No config bundle loaded, reset.
 		this->reset(false);
@@ -1059,6 +1103,145 @@ static void flatten_configbundle_hierarchy(boost::property_tree::ptree &tree, co
     flatten_configbundle_hierarchy(tree, "printer",         preset_bundle ? preset_bundle->printers.system_preset_names()      : std::vector<std::string>());
 }
 
+// Binary cache of the flattened system config bundles, one file per bundle in the "cache/bundles" directory
+// of the local configuration directory. A cache file is only used if it was written by the same build
+// from a bundle file of the same size and hash, otherwise it is rewritten.
+static const char configbundle_cache_magic[] = "SLIC3R_CONFIGBUNDLE_CACHE 1";
+
+static boost::filesystem::path configbundle_cache_path(const std::string &path)
+{
+    return (boost::filesystem::path(data_dir()) / "cache" / "bundles" / (boost::filesystem::path(path).stem().string() + ".bin")).make_preferred();
+}
+
+static uint64_t configbundle_hash(const std::string &data)
+{
+    return uint64_t(std::hash<std::string_view>()(std::string_view(data)));
+}
+
+static void configbundle_cache_append(std::string &out, uint64_t value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void configbundle_cache_append(std::string &out, const std::string &str)
+{
+    configbundle_cache_append(out, uint64_t(str.size()));
+    out += str;
+}
+
+static void configbundle_cache_append(std::string &out, const boost::property_tree::ptree &tree)
+{
+    configbundle_cache_append(out, tree.data());
+    configbundle_cache_append(out, uint64_t(tree.size()));
+    for (const auto &child : tree) {
+        configbundle_cache_append(out, child.first);
+        configbundle_cache_append(out, child.second);
+    }
+}
+
+// Reads the cache file content written by configbundle_cache_append(), returns false if truncated.
+class ConfigBundleCacheReader
+{
+public:
+    ConfigBundleCacheReader(const std::string &data) : m_ptr(data.data()), m_end(data.data() + data.size()) {}
+
+    bool read(uint64_t &value) {
+        if (size_t(m_end - m_ptr) < sizeof(value))
+            return false;
+        std::memcpy(&value, m_ptr, sizeof(value));
+        m_ptr += sizeof(value);
+        return true;
+    }
+    bool read(std::string &str) {
+        uint64_t len;
+        if (! this->read(len) || uint64_t(m_end - m_ptr) < len)
+            return false;
+        str.assign(m_ptr, size_t(len));
+        m_ptr += len;
+        return true;
+    }
+    bool read(boost::property_tree::ptree &tree) {
+        std::string data;
+        uint64_t    num_children;
+        if (! this->read(data) || ! this->read(num_children))
+            return false;
+        tree.put_value(std::move(data));
+        for (uint64_t i = 0; i < num_children; ++ i) {
+            std::string key;
+            if (! this->read(key))
+                return false;
+            if (! this->read(tree.push_back(std::make_pair(std::move(key), boost::property_tree::ptree()))->second))
+                return false;
+        }
+        return true;
+    }
+    bool at_end() const { return m_ptr == m_end; }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+// Load the flattened tree of a config bundle from the cache, if the cache is valid for the bundle data.
+static bool load_configbundle_cache(const std::string &path, const std::string &data, boost::property_tree::ptree &tree)
+{
+    boost::filesystem::path cache_path = configbundle_cache_path(path);
+    boost::system::error_code ec;
+    if (! boost::filesystem::is_regular_file(cache_path, ec))
+        return false;
+    std::string cache;
+    {
+        boost::nowide::ifstream ifs(cache_path.string(), std::ios::binary);
+        cache.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    ConfigBundleCacheReader reader(cache);
+    std::string magic, build_id;
+    uint64_t    size, hash;
+    boost::property_tree::ptree cached;
+    if (! reader.read(magic) || magic != configbundle_cache_magic ||
+        ! reader.read(build_id) || build_id != SLIC3R_BUILD_ID ||
+        ! reader.read(size) || size != data.size() ||
+        ! reader.read(hash) || hash != configbundle_hash(data) ||
+        ! reader.read(cached) || ! reader.at_end())
+        return false;
+    tree.swap(cached);
+    BOOST_LOG_TRIVIAL(debug) << "Loaded the config bundle \"" << path << "\" from the cache " << cache_path.string();
+    return true;
+}
+
+// Store the flattened tree of a config bundle into the cache. Failing to write the cache is not an error.
+static void save_configbundle_cache(const std::string &path, const std::string &data, const boost::property_tree::ptree &tree)
+{
+    std::string cache;
+    configbundle_cache_append(cache, std::string(configbundle_cache_magic));
+    configbundle_cache_append(cache, std::string(SLIC3R_BUILD_ID));
+    configbundle_cache_append(cache, uint64_t(data.size()));
+    configbundle_cache_append(cache, configbundle_hash(data));
+    configbundle_cache_append(cache, tree);
+
+    boost::filesystem::path cache_path = configbundle_cache_path(path);
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(cache_path.parent_path(), ec);
+    // Write a temporary file first, so that a concurrent reader never sees a partially written cache.
+    boost::filesystem::path tmp_path = cache_path;
+    tmp_path += boost::filesystem::unique_path(".%%%%-%%%%.tmp");
+    {
+        boost::nowide::ofstream ofs(tmp_path.string(), std::ios::binary | std::ios::trunc);
+        ofs.write(cache.data(), std::streamsize(cache.size()));
+        if (! ofs.good()) {
+            ofs.close();
+            boost::filesystem::remove(tmp_path, ec);
+            BOOST_LOG_TRIVIAL(warning) << "Failed writing the config bundle cache " << cache_path.string();
+            return;
+        }
+    }
+    boost::filesystem::rename(tmp_path, cache_path, ec);
+    if (ec) {
+        boost::filesystem::remove(tmp_path, ec);
+        BOOST_LOG_TRIVIAL(warning) << "Failed writing the config bundle cache " << cache_path.string();
+    }
+}
+
 // Load a config bundle file, into presets and store the loaded presets into separate files
 // of the local configuration directory.
 std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
@@ -1074,12 +1257,21 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 
     // 1) Read the complete config file into a boost::property_tree.
     namespace pt = boost::property_tree;
-    pt::ptree tree;
-    boost::nowide::ifstream ifs(path);
-    try {
-        pt::read_ini(ifs, tree);
-    } catch (const boost::property_tree::ini_parser::ini_parser_error &err) {
-        throw Slic3r::RuntimeError(format("Failed loading config bundle \"%1%\"\nError: \"%2%\" at line %3%", path, err.message(), err.line()).c_str());
+    pt::ptree   tree;
+    std::string data;
+    {
+        boost::nowide::ifstream ifs(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    // A system bundle is flattened independently of the other presets, thus the flattened tree may be cached.
+    bool use_cache = flags.has(LoadConfigBundleAttribute::LoadSystem);
+    bool flattened = use_cache && load_configbundle_cache(path, data, tree);
+    if (! flattened) {
+        try {
+            read_ini_tree(data, tree);
+        } catch (const ConfigurationError &err) {
+            throw Slic3r::RuntimeError(format("Failed loading config bundle \"%1%\"\nError: \"%2%\"", path, err.what()).c_str());
+        }
     }
 
     const VendorProfile *vendor_profile = nullptr;
@@ -1100,7 +1292,11 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 
     // 1.5) Flatten the config bundle by applying the inheritance rules. Internal profiles (with names starting with '*') are removed.
     // If loading a user config bundle, do not flatten with the system profiles, but keep the "inherits" flag intact.
-    flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+    if (! flattened) {
+        flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+        if (use_cache)
+            save_configbundle_cache(path, data, tree);
+    }
 
     // 2) Parse the property_tree, extract the active preset names and the profiles, save them into local config files.
     // Parse the obsolete preset names, to be deleted when upgrading from the old configuration structure.
@@ -23,9 +23,11 @@
 #include <algorithm>
 #include <limits>
 #include <unordered_set>
+#include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdio.hpp>
 
 // Mark string for localization and translate.
 #define L(s) Slic3r::I18N::translate(s)
@@ -47,6 +49,7 @@ void Print::clear()
         delete region;
     m_regions.clear();
     m_model.clear_objects();
+    m_gcode_export_cache.clear();
 }
 
 //PrintRegion* Print::add_region()
@@ -71,6 +74,8 @@ bool Print::invalidate_state_by_config_options(const std::vector<t_config_option
     // Cache the plenty of parameters, which influence the G-code generator only,
     // or they are only notes not influencing the generated G-code.
     static std::unordered_set<std::string> steps_gcode = {
+        "arc_fitting",
+        "arc_fitting_tolerance",
         "avoid_crossing_perimeters",
         "avoid_crossing_perimeters_max_detour",
         "avoid_crossing_not_first_layer",
@@ -175,7 +180,6 @@ bool Print::invalidate_state_by_config_options(const std::vector<t_config_option
         "tool_name",
         "toolchange_gcode",
         "top_fan_speed",
-        "threads",
         "travel_acceleration",
         "travel_speed",
         "travel_speed_z",
@@ -188,7 +192,10 @@ bool Print::invalidate_state_by_config_options(const std::vector<t_config_option
         "wipe_extra_perimeter"
     };
 
-    static std::unordered_set<std::string> steps_ignore;
+    static std::unordered_set<std::string> steps_ignore = {
+        // Applied to the task arena of the print, see PrintBase::set_num_threads().
+        "slicing_threads"
+    };
 
     std::vector<PrintStep> steps;
     std::vector<PrintObjectStep> osteps;
@@ -703,6 +710,8 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 	tbb::mutex::scoped_lock lock(this->state_mutex());
 
     // The following call may stop the background processing.
+    if (const ConfigOptionInt *opt_threads = new_full_config.option<ConfigOptionInt>("slicing_threads"); opt_threads != nullptr)
+        this->set_num_threads(opt_threads->value);
     if (! print_diff.empty())
         update_apply_status(this->invalidate_state_by_config_options(print_diff));
 
@@ -1782,6 +1791,11 @@ void Print::auto_assign_extruders(ModelObject* model_object) const
 
 // Slicing process, running at a background thread.
 void Print::process()
+{
+    this->execute_in_arena([this]() { this->_process(); });
+}
+
+void Print::_process()
 {
     name_tbb_thread_pool_threads();
 
@@ -1947,10 +1961,231 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
 
     // The following line may die for multiple reasons.
     GCode gcode;
-    gcode.do_export(this, path.c_str(), result, thumbnail_cb);
+    this->execute_in_arena([this, &gcode, &path, result, thumbnail_cb]() { gcode.do_export(this, path.c_str(), result, thumbnail_cb); });
     return path.c_str();
 }
 
+void GCodeExportCache::clear()
+{
+    chunks.clear();
+    chunks.shrink_to_fit();
+    size = 0;
+    extruders.clear();
+    mills.clear();
+    initial_extruder_id = 0;
+    print_statistics.clear();
+    placeholders.clear();
+    m_full_config.clear();
+    m_print_state.clear();
+    if (m_spill_file != nullptr) {
+        fclose(m_spill_file);
+        m_spill_file = nullptr;
+        boost::system::error_code ec;
+        boost::filesystem::remove(m_spill_path, ec);
+        m_spill_path.clear();
+    }
+    m_spill_size = 0;
+}
+
+bool GCodeExportCache::append(Chunk &&chunk, std::string &&gcode)
+{
+    if (size + gcode.size() <= max_size()) {
+        size += gcode.size();
+        chunk.gcode = std::move(gcode);
+    } else if (! gcode.empty()) {
+        if (m_spill_file == nullptr) {
+            m_spill_path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("slic3r_gcode_cache_%%%%-%%%%-%%%%-%%%%.gcode")).string();
+            if ((m_spill_file = boost::nowide::fopen(m_spill_path.c_str(), "w+b")) == nullptr) {
+                BOOST_LOG_TRIVIAL(warning) << "Failed to create the G-code export cache file " << m_spill_path;
+                m_spill_path.clear();
+                return false;
+            }
+        }
+        // The file is only appended to, reading a chunk back seeks to its offset.
+        if (fseek(m_spill_file, 0, SEEK_END) != 0 || fwrite(gcode.data(), 1, gcode.size(), m_spill_file) != gcode.size()) {
+            BOOST_LOG_TRIVIAL(warning) << "Failed to write the G-code export cache file " << m_spill_path;
+            return false;
+        }
+        chunk.spill_offset = m_spill_size;
+        chunk.spill_size   = gcode.size();
+        m_spill_size      += gcode.size();
+    }
+    chunks.emplace_back(std::move(chunk));
+    return true;
+}
+
+// The spill file may grow over 2GB, which fseek() can't address on Windows.
+static int fseek_set64(FILE *file, size_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, __int64(offset), SEEK_SET);
+#else
+    return fseeko(file, off_t(offset), SEEK_SET);
+#endif
+}
+
+std::string GCodeExportCache::gcode(const Chunk &chunk) const
+{
+    if (chunk.spill_offset == size_t(-1))
+        return chunk.gcode;
+    assert(m_spill_file != nullptr);
+    std::string out(chunk.spill_size, '\0');
+    if (fseek_set64(m_spill_file, chunk.spill_offset) != 0 || fread(out.data(), 1, out.size(), m_spill_file) != out.size())
+        throw Slic3r::RuntimeError(std::string("Failed to read the G-code export cache file ") + m_spill_path);
+    return out;
+}
+
+// Everything the layers of the G-code depend on, except for the print config, which is compared key by key.
+// The steps get a new timestamp whenever they are invalidated or recalculated. The tool ordering and the skirt are compared
+// by their content, as the temperatures invalidate them, though they don't change without a wipe tower.
+static std::string gcode_export_print_state(const Print &print)
+{
+    std::string out = std::to_string(print.step_state_with_timestamp(psBrim).timestamp) + ";";
+    for (const LayerTools &layer_tools : print.tool_ordering()) {
+        out += std::to_string(layer_tools.print_z) + ":";
+        for (uint16_t extruder_id : layer_tools.extruders)
+            out += std::to_string(extruder_id) + ",";
+        out += std::to_string(layer_tools.extruder_override) + (layer_tools.has_object ? "o" : "") + (layer_tools.has_support ? "s" : "") + ";";
+    }
+    auto append_skirt = [&out](const ExtrusionEntityCollection &skirt) {
+        out += "\nskirt:";
+        for (const Polyline &polyline : skirt.as_polylines()) {
+            for (const Point &pt : polyline.points)
+                out += std::to_string(pt.x()) + "," + std::to_string(pt.y()) + ";";
+            out += "|";
+        }
+    };
+    append_skirt(print.skirt());
+    if (print.skirt_first_layer())
+        append_skirt(*print.skirt_first_layer());
+    for (const PrintObject *object : print.objects()) {
+        out += "\nobject " + std::to_string(object->id().id) + ":";
+        for (int step = 0; step < int(posCount); ++ step)
+            out += std::to_string(object->step_state_with_timestamp(PrintObjectStep(step)).timestamp) + ";";
+        for (const PrintInstance &instance : object->instances())
+            out += std::to_string(instance.shift.x()) + "," + std::to_string(instance.shift.y()) + ";";
+        for (const t_config_option_key &opt_key : object->config().keys())
+            out += opt_key + "=" + object->config().opt_serialize(opt_key) + ";";
+    }
+    for (const PrintRegion *region : print.regions()) {
+        out += "\nregion:";
+        for (const t_config_option_key &opt_key : region->config().keys())
+            out += opt_key + "=" + region->config().opt_serialize(opt_key) + ";";
+    }
+    return out;
+}
+
+void GCodeExportCache::snapshot(const Print &print)
+{
+    m_full_config = print.full_print_config();
+    m_print_state = gcode_export_print_state(print);
+}
+
+bool GCodeExportCache::matches(const Print &print) const
+{
+    if (this->empty() || m_full_config.keys().size() != print.full_print_config().keys().size())
+        return false;
+    const DynamicPrintConfig &config = print.full_print_config();
+    bool temperatures_changed = false;
+    for (const t_config_option_key &opt_key : m_full_config.diff(config)) {
+        if (opt_key == "temperature" || opt_key == "bed_temperature")
+            temperatures_changed = true;
+        else if (! is_cooling_option(opt_key) && ! is_regenerated_template(opt_key))
+            return false;
+        if (is_referenced_by_custom_gcode(config, opt_key))
+            return false;
+    }
+    if (m_print_state != gcode_export_print_state(print))
+        return false;
+    // The temperatures are only re-emitted by the transition to the second layer. They are re-emitted if the extrusions
+    // never set the temperature, thus the temperature of the layers above the first one was set by the transition only.
+    // The start G-code and the multi-extruder tool changes use the temperature as well.
+    if (temperatures_changed && (this->extruders.size() != 1 || print.config().gcode_flavor.value == gcfRepRap ||
+            print.config().first_layer_temperature.get_at(this->extruders.front()) <= 0))
+        return false;
+    ToolOrdering tool_ordering;
+    bool         custom_gcodes = ! print.model().custom_gcode_per_print_z.gcodes.empty();
+    if (custom_gcodes) {
+        tool_ordering = print.tool_ordering();
+        tool_ordering.assign_custom_gcodes(print);
+    }
+    for (const Chunk &chunk : chunks)
+        if (chunk.type == ctLayer) {
+            if (temperatures_changed && chunk.checkpoint.body_sets_temperature)
+                return false;
+            // A color change unretracts the tool, adding or removing it at a retracted layer changes the extrusions of the layer.
+            bool unretracts = custom_gcodes && custom_gcode_unretracts(tool_ordering.tools_for_layer(chunk.checkpoint.print_z).custom_gcode);
+            if (unretracts != chunk.checkpoint.custom_gcode_unretracts && chunk.checkpoint.retracted)
+                return false;
+        }
+    return true;
+}
+
+bool GCodeExportCache::is_cooling_option(const t_config_option_key &opt_key)
+{
+    // disable_fan_first_layers is not listed, it is used by the start of the G-code as well.
+    static const std::vector<t_config_option_key> cooling_options {
+        "bridge_fan_speed",
+        "bridge_internal_fan_speed",
+        "cooling",
+        "external_perimeter_fan_speed",
+        "fan_always_on",
+        "fan_below_layer_time",
+        "fan_kickstart",
+        "fan_speedup_overhangs",
+        "fan_speedup_time",
+        "full_fan_speed_layer",
+        "max_fan_speed",
+        "max_speed_reduction",
+        "min_fan_speed",
+        "min_print_speed",
+        "slowdown_below_layer_time",
+        "top_fan_speed",
+    };
+    assert(std::is_sorted(cooling_options.begin(), cooling_options.end()));
+    return std::binary_search(cooling_options.begin(), cooling_options.end(), opt_key);
+}
+
+bool GCodeExportCache::is_regenerated_template(const t_config_option_key &opt_key)
+{
+    static const std::vector<t_config_option_key> regenerated_templates {
+        "before_layer_gcode",
+        "color_change_gcode",
+        "end_filament_gcode",
+        "end_gcode",
+        "layer_gcode",
+        "pause_print_gcode",
+        "template_custom_gcode",
+    };
+    assert(std::is_sorted(regenerated_templates.begin(), regenerated_templates.end()));
+    return std::binary_search(regenerated_templates.begin(), regenerated_templates.end(), opt_key);
+}
+
+bool GCodeExportCache::is_referenced_by_custom_gcode(const DynamicPrintConfig &config, const t_config_option_key &opt_key)
+{
+    auto is_identifier_char = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; };
+    for (const t_config_option_key &templ_key : config.keys())
+        if (boost::ends_with(templ_key, "_gcode") && ! is_regenerated_template(templ_key)) {
+            // The templates are not parsed, any occurence of the option name as an identifier is considered a reference.
+            const std::string templ = config.opt_serialize(templ_key);
+            for (size_t pos = templ.find(opt_key); pos != std::string::npos; pos = templ.find(opt_key, pos + 1))
+                if ((pos == 0 || ! is_identifier_char(templ[pos - 1])) &&
+                    (pos + opt_key.size() == templ.size() || ! is_identifier_char(templ[pos + opt_key.size()])))
+                    return true;
+        }
+    return false;
+}
+
+size_t GCodeExportCache::max_size()
+{
+    static const size_t size = [] {
+        size_t limit = 64 * 1024 * 1024;
+        size_t total = total_physical_memory();
+        return total == 0 ? limit : std::min(limit, total / 64);
+    }();
+    return size;
+}
+
 void Print::_make_skirt(const PrintObjectPtrs &objects, ExtrusionEntityCollection &out, std::optional<ExtrusionEntityCollection>& out_first_layer)
 {
     // First off we need to decide how tall the skirt must be.
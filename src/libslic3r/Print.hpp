@@ -13,6 +13,7 @@
 #include "GCode/WipeTower.hpp"
 #include "GCode/ThumbnailData.hpp"
 #include "GCode/GCodeProcessor.hpp"
+#include "GCodeWriter.hpp"
 
 #include "libslic3r.h"
 
@@ -207,6 +208,10 @@ public:
     const ExtrusionEntityCollection& skirt() const { return m_skirt; }
     const ExtrusionEntityCollection& brim() const { return m_brim; }
 
+    // Octrees of the adaptive cubic and support cubic infill, null if not used.
+    std::shared_ptr<const FillAdaptive::Octree> adaptive_fill_octree() const { return m_adaptive_fill_octree; }
+    std::shared_ptr<const FillAdaptive::Octree> support_fill_octree() const { return m_support_fill_octree; }
+
 protected:
     // to be called from Print only.
     friend class Print;
@@ -254,7 +259,7 @@ private:
     void discover_horizontal_shells();
     void combine_infill();
     void _generate_support_material();
-    std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> prepare_adaptive_infill_data();
+    std::pair<FillAdaptive::Octree*, FillAdaptive::Octree*> prepare_adaptive_infill_data();
 
     // XYZ in scaled coordinates
     Vec3crd									m_size;
@@ -281,6 +286,27 @@ private:
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                                    m_typed_slices = false;
 
+    // Input of FillAdaptive::build_octree().
+    struct AdaptiveFillOctreeKey {
+        // Mesh revision and transformation of each model part.
+        std::vector<std::pair<uint64_t, Transform3d>> volumes;
+        // Transformation of the object into the coordinate system of the octree.
+        Transform3d                                   trafo { Transform3d::Identity() };
+        // Triangulated internal bridges, shared by the keys of both octrees.
+        std::shared_ptr<const std::vector<Vec3d>>     overhangs;
+        double                                        line_spacing { 0. };
+
+        bool operator==(const AdaptiveFillOctreeKey &rhs) const;
+        bool operator!=(const AdaptiveFillOctreeKey &rhs) const { return ! (*this == rhs); }
+    };
+
+    // Octrees of the adaptive cubic and support cubic infill. They are kept when posInfill is invalidated
+    // and only rebuilt if their key does not match the current input exactly.
+    std::shared_ptr<FillAdaptive::Octree>   m_adaptive_fill_octree;
+    std::shared_ptr<FillAdaptive::Octree>   m_support_fill_octree;
+    AdaptiveFillOctreeKey                   m_adaptive_fill_octree_key;
+    AdaptiveFillOctreeKey                   m_support_fill_octree_key;
+
     std::vector<ExPolygons> slice_region(size_t region_id, const std::vector<float> &z, SlicingMode mode, size_t slicing_mode_normal_below_layer, SlicingMode mode_below) const;
     std::vector<ExPolygons> slice_region(size_t region_id, const std::vector<float> &z, SlicingMode mode) const
         { return this->slice_region(region_id, z, mode, 0, mode); }
@@ -368,6 +394,131 @@ struct PrintStatistics
     }
 };
 
+// G-code of the last export of a Print, split into the layers as they were generated before the cooling buffer
+// was applied. If only the cooling / fan settings, the per-layer custom G-code, the end G-code, the temperatures
+// of the layers or the color changes changed since, the export replays the cached layers through the cooling buffer,
+// regenerating the per-layer sections from the checkpoints stored with the layers, instead of regenerating all the extrusions.
+// The G-code is kept in memory up to max_size(), the rest is spilled into a temporary file.
+// Only filled in for non-sequential prints without a wipe tower, as the wipe tower tool changes depend on the fan state.
+struct GCodeExportCache
+{
+    enum ChunkType : uint8_t {
+        // G-code passed to GCode::_write() unmodified.
+        ctText,
+        // Layer G-code before the cooling buffer was applied.
+        ctLayer,
+        // Sections regenerated at each export: the header with the thumbnails,
+        // the fan switched off by the end G-code, the end G-codes and the full config.
+        ctHeader,
+        ctFanOff,
+        ctEnd,
+        ctFullConfig,
+    };
+    // Sections of a layer regenerated at each export, in the order they appear in the layer.
+    enum LayerSection : uint8_t {
+        lsBeforeLayerGCode,
+        lsLayerGCode,
+        lsTemperatures,
+        lsCustomGCode,
+        lsCount
+    };
+    // State of the G-code generator at the start of a layer or of the end G-code,
+    // from which the per-layer sections and the end G-codes are regenerated.
+    struct Checkpoint {
+        coordf_t    print_z                     { 0. };
+        coordf_t    previous_print_z            { 0. };
+        float       max_layer_z                 { 0.f };
+        // GCode::m_layer_index before and after the layer change.
+        int         layer_index                 { -1 };
+        int         next_layer_index            { -1 };
+        // Active tool and the value of the "current_extruder" placeholder.
+        uint16_t    tool_id                     { 0 };
+        int         current_extruder            { 0 };
+        // First extruder printing the layer.
+        uint16_t    first_extruder_id           { 0 };
+        // The layer sets the temperatures of the layers above the first one, starting from these writer temperatures.
+        bool        second_layer_temperatures   { false };
+        GCodeWriter::TemperatureState temperatures;
+        // The extrusions of the layer changed the temperatures set by the writer.
+        bool        body_sets_temperature       { false };
+        // The active tool was retracted when the custom G-code was emitted. A color change unretracts the tool,
+        // thus adding or removing a color change at such a layer changes the rest of the layer.
+        bool        retracted                   { false };
+        // The custom G-code emitted at this layer unretracted the tool.
+        bool        custom_gcode_unretracts     { false };
+        // Filament used by the active tool before this layer, for the color change statistics.
+        double      extruded_weight             { 0. };
+        double      used_filament               { 0. };
+        // Begin and end of the regenerated sections in the G-code of the layer.
+        std::array<std::pair<size_t, size_t>, lsCount> sections;
+    };
+    struct Chunk {
+        ChunkType   type;
+        bool        flush { false };
+        bool        support_only { false };
+        size_t      layer_id { 0 };
+        // Tool active in the GCodeWriter when the layer was passed to the cooling buffer, -1 if none.
+        int         tool_id { -1 };
+        // Only valid for ctLayer and ctEnd.
+        Checkpoint  checkpoint;
+        // G-code kept in memory, or its position in the spill file.
+        std::string gcode;
+        size_t      spill_offset { size_t(-1) };
+        size_t      spill_size { 0 };
+    };
+    // G-code kept in memory: at most 64MB and at most 1/64 of the physical memory.
+    static size_t max_size();
+
+    GCodeExportCache() = default;
+    GCodeExportCache(const GCodeExportCache &) = delete;
+    GCodeExportCache& operator=(const GCodeExportCache &) = delete;
+    ~GCodeExportCache() { this->clear(); }
+
+    std::vector<Chunk>      chunks;
+    // Size of the G-code kept in memory.
+    size_t                  size { 0 };
+    std::vector<uint16_t>   extruders;
+    std::vector<uint16_t>   mills;
+    uint16_t                initial_extruder_id { 0 };
+    PrintStatistics         print_statistics;
+    // Placeholders set by the G-code export, not provided by Print::placeholder_parser().
+    DynamicConfig           placeholders;
+    // Number of exports replayed from the cache, not reset by clear().
+    size_t                  num_replayed { 0 };
+
+    bool        empty() const { return chunks.empty(); }
+    void        clear();
+    // Store a chunk, its G-code is kept in memory up to max_size(), then it is spilled into a temporary file.
+    // Returns false if the G-code could not be spilled.
+    bool        append(Chunk &&chunk, std::string &&gcode);
+    // G-code of a chunk, read back from the spill file if it was spilled. Throws on a read error.
+    std::string gcode(const Chunk &chunk) const;
+    size_t      spilled() const { return m_spill_size; }
+    // Record the state of the print the chunks were generated from.
+    void        snapshot(const Print &print);
+    // Can the chunks be replayed to export the current state of the print?
+    bool        matches(const Print &print) const;
+    // Options only consumed by the CoolingBuffer and by the FanMover.
+    static bool is_cooling_option(const t_config_option_key &opt_key);
+    // Custom G-code templates regenerated from the checkpoints.
+    static bool is_regenerated_template(const t_config_option_key &opt_key);
+    // Is the option referenced by a placeholder of a custom G-code template, which is not regenerated,
+    // thus its value may be baked into the cached layers?
+    static bool is_referenced_by_custom_gcode(const DynamicPrintConfig &config, const t_config_option_key &opt_key);
+    // Does the custom G-code emitted for a layer unretract the tool?
+    static bool custom_gcode_unretracts(const CustomGCode::Item *custom_gcode)
+        { return custom_gcode != nullptr && (custom_gcode->type == CustomGCode::ColorChange || custom_gcode->type == CustomGCode::ToolChange); }
+
+private:
+    DynamicPrintConfig      m_full_config;
+    // Timestamps of the print and object steps, the tool ordering, the skirt, object configs and instance shifts.
+    std::string             m_print_state;
+    // Temporary file the G-code above max_size() is spilled into.
+    FILE                   *m_spill_file { nullptr };
+    std::string             m_spill_path;
+    size_t                  m_spill_size { 0 };
+};
+
 class BrimLoop {
 public:
     BrimLoop(const Polygon& p) : lines(Polylines{ p.split_at_first_point() }), is_loop(true) {}
@@ -477,6 +628,7 @@ public:
 
     const PrintStatistics&      print_statistics() const { return m_print_statistics; }
     PrintStatistics&            print_statistics() { return m_print_statistics; }
+    const GCodeExportCache&     gcode_export_cache() const { return m_gcode_export_cache; }
 
     // Wipe tower support.
     bool                        has_wipe_tower() const;
@@ -507,6 +659,8 @@ private:
 		t_config_option_keys &full_config_diff, 
 		DynamicPrintConfig &filament_overrides) const;
 
+    // Body of process(), executed in the task arena of this print.
+    void                _process();
     void                _make_skirt(const PrintObjectPtrs &objects, ExtrusionEntityCollection &out, std::optional<ExtrusionEntityCollection> &out_first_layer);
     void                _make_brim(const Flow &flow, const PrintObjectPtrs &objects, ExPolygons &unbrimmable, ExtrusionEntityCollection &out);
     void                _make_brim_ears(const Flow &flow, const PrintObjectPtrs &objects, ExPolygons &unbrimmable, ExtrusionEntityCollection &out);
@@ -548,6 +702,8 @@ private:
 
     // Estimated print time, filament consumed.
     PrintStatistics                         m_print_statistics;
+    // Output of the last G-code export, reused if only the cooling settings changed.
+    GCodeExportCache                        m_gcode_export_cache;
 
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCode;
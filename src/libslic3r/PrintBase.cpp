@@ -139,6 +139,20 @@ void PrintBase::status_update_warnings(ObjectID object_id, int step, PrintStateB
     	printf("%s warning: %s\n", (object_id == this->id()) ? "print" : "print object", message.c_str());
 }
 
+void PrintBase::set_num_threads(int num_threads)
+{
+    num_threads = std::max(0, num_threads);
+    if (num_threads == m_num_threads)
+        return;
+    // The arena may be in use by the background processing.
+    m_cancel_callback();
+    m_num_threads = num_threads;
+    if (num_threads == 0)
+        m_task_arena.reset();
+    else
+        m_task_arena = std::make_unique<tbb::task_arena>(num_threads);
+}
+
 tbb::mutex& PrintObjectBase::state_mutex(PrintBase *print)
 { 
 	return print->state_mutex();
@@ -2,6 +2,7 @@
 #define slic3r_PrintBase_hpp_
 
 #include "libslic3r.h"
+#include <memory>
 #include <set>
 #include <vector>
 #include <string>
@@ -12,6 +13,7 @@
     #define NOMINMAX
 #endif
 #include "tbb/mutex.h"
+#include "tbb/task_arena.h"
 
 #include "ObjectID.hpp"
 #include "Model.hpp"
@@ -388,6 +390,15 @@ public:
     // The adjustments on the Print / PrintObject data due to set_task() are to be reverted here.
     virtual void            finalize() {}
 
+    // Limit the number of threads used by process() and by the export of this print, 0 for all available threads.
+    // Changing the limit stops the background processing.
+    void                    set_num_threads(int num_threads);
+    int                     num_threads() const { return m_num_threads; }
+    // Execute fn in the task arena of this print: the TBB parallel loops started by fn are limited to num_threads(),
+    // so that several prints or the GUI jobs running next to the background processing share the host predictably.
+    template<typename Fn>
+    void                    execute_in_arena(Fn &&fn) { if (m_task_arena) m_task_arena->execute(fn); else fn(); }
+
     struct SlicingStatus {
         SlicingStatus(int percent, const std::string& text, unsigned int flags = 0) : percent(percent), main_text(text), flags(flags) {}
         SlicingStatus(int percent, const std::string& text, const std::vector<std::string>& args, unsigned int flags = 0) 
@@ -501,6 +512,10 @@ private:
     // Callback to be evoked to stop the background processing before a state is updated.
     cancel_callback_type                    m_cancel_callback = [](){};
 
+    // Task arena limiting the number of worker threads, nullptr if not limited.
+    std::unique_ptr<tbb::task_arena>        m_task_arena;
+    int                                     m_num_threads { 0 };
+
     // Mutex used for synchronization of the worker thread with the UI thread:
     // The mutex will be used to guard the worker thread against entering a stage
     // while the data influencing the stage is modified.
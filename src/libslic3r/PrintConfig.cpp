@@ -220,6 +220,25 @@ void PrintConfigDef::init_fff_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("arc_fitting", coBool);
+    def->label = L("Arc fitting");
+    def->category = OptionCategory::output;
+    def->tooltip = L("Replace the runs of short G1 moves following a circle (curved perimeters, holes, fillets) by G2/G3 arcs."
+        " It reduces the size of the G-code and the number of commands the firmware has to plan."
+        "\nYour firmware must support the G2/G3 commands with the I and J parameters. It is not used for spiral vase.");
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionBool(false));
+
+    def = this->add("arc_fitting_tolerance", coFloat);
+    def->label = L("Arc fitting tolerance");
+    def->category = OptionCategory::output;
+    def->tooltip = L("Maximum distance between the arc and the extrusion path it replaces.");
+    def->sidetext = L("mm");
+    def->min = 0.001;
+    def->precision = 6;
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionFloat(0.02));
+
     def = this->add("avoid_crossing_perimeters", coBool);
     def->label = L("Avoid crossing perimeters");
     def->category = OptionCategory::perimeter;
@@ -3489,6 +3508,16 @@ void PrintConfigDef::init_fff_params()
     def->mode = comSimple;
     def->set_default_value(new ConfigOptionInt(1));
 
+    def = this->add("slicing_threads", coInt);
+    def->label = L("Threads");
+    def->tooltip = L("Threads are used to parallelize long-running tasks. This limits the number of threads "
+                   "used to slice and export a print, so that several prints can share the computer. "
+                   "Set zero to use all the available cores/processors.");
+    def->cli = "threads=i";
+    def->min = 0;
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionInt(0));
+
     def = this->add("slowdown_below_layer_time", coInts);
     def->label = L("Slow down if layer print time is below");
     def->category = OptionCategory::cooling;
@@ -4183,18 +4212,6 @@ void PrintConfigDef::init_fff_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionFloat(30));
 
-    def = this->add("threads", coInt);
-    def->label = L("Threads");
-    def->tooltip = L("Threads are used to parallelize long-running tasks. Optimal threads number "
-                   "is slightly above the number of available cores/processors.");
-    def->readonly = true;
-    def->min = 1;
-    {
-        int threads = (unsigned int)boost::thread::hardware_concurrency();
-        def->set_default_value(new ConfigOptionInt(threads > 0 ? threads : 2));
-        def->cli = ConfigOptionDef::nocli;
-    }
-
     def = this->add("time_estimation_compensation", coPercent);
     def->label = L("Time estimation compensation");
     def->category = OptionCategory::firmware;
@@ -5630,6 +5647,8 @@ void PrintConfigDef::handle_legacy(t_config_option_key &opt_key, std::string &va
 
 std::unordered_set<std::string> prusa_export_to_remove_keys = {
 "allow_empty_layers",
+"arc_fitting",
+"arc_fitting_tolerance",
 "avoid_crossing_not_first_layer",
 "bridge_internal_fan_speed",
 "bridge_overlap",
@@ -6653,6 +6672,21 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->cli = "slice|s";
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("server", coBool);
+    def->label = L("Slicing server");
+    def->tooltip = L("Keep running and process slicing jobs read from the standard input, one job per line. "
+                     "A job is written with the command line syntax (options followed by the input files) and "
+                     "its options override the ones supplied when starting the server. "
+                     "The result of each job is reported on the standard output.");
+    def->set_default_value(new ConfigOptionBool(false));
+
+    def = this->add("batch", coBool);
+    def->label = L("Batch slicing");
+    def->tooltip = L("Slice each input file separately into its own output file. The files are sliced concurrently "
+                     "(see --jobs), a new job is started only if its estimated memory consumption fits into the available memory. "
+                     "The slicing log of each job is saved next to its output file. --output has to be a directory, if supplied.");
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("help", coBool);
     def->label = L("Help");
     def->tooltip = L("Show this help.");
@@ -6819,6 +6853,15 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->label = L("Data directory");
     def->tooltip = L("Load and store settings at the given directory. This is useful for maintaining different profiles or including configurations from a network storage.");
 
+    def = this->add("jobs", coInt);
+    def->label = L("Concurrent jobs");
+    def->tooltip = L("Maximum number of slicing jobs processed at the same time in the --server and --batch modes. "
+                     "Each running job keeps its own print in memory, therefore this value bounds the memory consumption. "
+                     "Set zero to use the number of CPU cores.");
+    def->cli = "jobs|j";
+    def->min = 0;
+    def->set_default_value(new ConfigOptionInt(0));
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
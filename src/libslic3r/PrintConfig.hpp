@@ -1043,6 +1043,8 @@ class GCodeConfig : public StaticPrintConfig
 {
     STATIC_PRINT_CONFIG_CACHE(GCodeConfig)
 public:
+    ConfigOptionBool                arc_fitting;
+    ConfigOptionFloat               arc_fitting_tolerance;
     ConfigOptionString              before_layer_gcode;
     ConfigOptionString              between_objects_gcode;
     ConfigOptionFloats              deretract_speed;
@@ -1159,6 +1161,8 @@ public:
 protected:
     void initialize(StaticCacheBase &cache, const char *base_ptr)
     {
+        OPT_PTR(arc_fitting);
+        OPT_PTR(arc_fitting_tolerance);
         OPT_PTR(before_layer_gcode);
         OPT_PTR(between_objects_gcode);
         OPT_PTR(deretract_speed);
@@ -1346,11 +1350,11 @@ public:
     ConfigOptionFloatOrPercent      skirt_extrusion_width;
     ConfigOptionBool                draft_shield;
     ConfigOptionInt                 skirts;
+    ConfigOptionInt                 slicing_threads;
     ConfigOptionInts                slowdown_below_layer_time;
     ConfigOptionBool                spiral_vase;
     ConfigOptionInt                 standby_temperature_delta;
     ConfigOptionInts                temperature;
-    ConfigOptionInt                 threads;
     ConfigOptionPoints              thumbnails;
     ConfigOptionString              thumbnails_color;
     ConfigOptionBool                thumbnails_custom_color;
@@ -1447,11 +1451,11 @@ protected:
         OPT_PTR(skirt_height);
         OPT_PTR(draft_shield);
         OPT_PTR(skirts);
+        OPT_PTR(slicing_threads);
         OPT_PTR(slowdown_below_layer_time);
         OPT_PTR(spiral_vase);
         OPT_PTR(standby_temperature_delta);
         OPT_PTR(temperature);
-        OPT_PTR(threads);
         OPT_PTR(thumbnails);
         OPT_PTR(thumbnails_color);
         OPT_PTR(thumbnails_custom_color);
@@ -1504,11 +1508,13 @@ class SLAPrintConfig : public StaticPrintConfig
     STATIC_PRINT_CONFIG_CACHE(SLAPrintConfig)
 public:
     ConfigOptionString     output_filename_format;
+    ConfigOptionInt        slicing_threads;
 
 protected:
     void initialize(StaticCacheBase &cache, const char *base_ptr)
     {
         OPT_PTR(output_filename_format);
+        OPT_PTR(slicing_threads);
     }
 };
 
@@ -573,11 +573,11 @@ namespace Slic3r {
             BOOST_LOG_TRIVIAL(debug) << "Filling layers in parallel - start";
             tbb::parallel_for(
                 tbb::blocked_range<size_t>(0, m_layers.size()),
-                [this, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree, &atomic_count , &last_update, nb_layers_update](const tbb::blocked_range<size_t>& range) {
+                [this, adaptive_fill_octree = adaptive_fill_octree, support_fill_octree = support_fill_octree, &atomic_count , &last_update, nb_layers_update](const tbb::blocked_range<size_t>& range) {
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
                     std::chrono::time_point<std::chrono::system_clock> start_make_fill = std::chrono::system_clock::now();
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get());
+                    m_layers[layer_idx]->make_fills(adaptive_fill_octree, support_fill_octree);
 
                     // updating progress
                     int nb_layers_done = (++atomic_count);
@@ -645,13 +645,32 @@ namespace Slic3r {
         }
     }
 
-    std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> PrintObject::prepare_adaptive_infill_data()
+    bool PrintObject::AdaptiveFillOctreeKey::operator==(const AdaptiveFillOctreeKey &rhs) const
+    {
+        if (this->line_spacing != rhs.line_spacing || this->trafo.matrix() != rhs.trafo.matrix() || this->volumes.size() != rhs.volumes.size())
+            return false;
+        for (size_t i = 0; i < this->volumes.size(); ++ i)
+            if (this->volumes[i].first != rhs.volumes[i].first || this->volumes[i].second.matrix() != rhs.volumes[i].second.matrix())
+                return false;
+        return this->overhangs == rhs.overhangs ||
+            (this->overhangs && rhs.overhangs && *this->overhangs == *rhs.overhangs);
+    }
+
+    std::pair<FillAdaptive::Octree*, FillAdaptive::Octree*> PrintObject::prepare_adaptive_infill_data()
     {
         using namespace FillAdaptive;
 
         auto [adaptive_line_spacing, support_line_spacing] = adaptive_fill_line_spacing(*this);
+        if (adaptive_line_spacing == 0.) {
+            m_adaptive_fill_octree.reset();
+            m_adaptive_fill_octree_key = AdaptiveFillOctreeKey();
+        }
+        if (support_line_spacing == 0.) {
+            m_support_fill_octree.reset();
+            m_support_fill_octree_key = AdaptiveFillOctreeKey();
+        }
         if ((adaptive_line_spacing == 0. && support_line_spacing == 0.) || this->layers().empty())
-            return std::make_pair(OctreePtr(), OctreePtr());
+            return std::make_pair(nullptr, nullptr);
 
         indexed_triangle_set mesh = this->model_object()->raw_indexed_triangle_set();
         // Rotate mesh and build octree on it with axis-aligned (standart base) cubes.
@@ -660,6 +679,12 @@ namespace Slic3r {
         auto to_octree = transform_to_octree().toRotationMatrix();
         its_transform(mesh, to_octree * m, true);
 
+        AdaptiveFillOctreeKey key;
+        for (const ModelVolume *volume : this->model_object()->volumes)
+            if (volume->is_model_part())
+                key.volumes.emplace_back(volume->mesh_revision(), volume->get_matrix());
+        key.trafo = to_octree * m;
+
         // Triangulate internal bridging surfaces.
         std::vector<std::vector<Vec3d>> overhangs(this->layers().size());
         tbb::parallel_for(
@@ -681,9 +706,23 @@ namespace Slic3r {
         for (size_t i = 1; i < overhangs.size(); ++i)
             append(overhangs.front(), std::move(overhangs[i]));
 
-        return std::make_pair(
-            adaptive_line_spacing ? build_octree(mesh, overhangs.front(), adaptive_line_spacing, false) : OctreePtr(),
-            support_line_spacing ? build_octree(mesh, overhangs.front(), support_line_spacing, true) : OctreePtr());
+        key.overhangs = std::make_shared<const std::vector<Vec3d>>(std::move(overhangs.front()));
+
+        // Reuse the octrees built for the same input, for example if only the infill settings changed.
+        auto update_octree = [&mesh, &key](std::shared_ptr<Octree> &octree, AdaptiveFillOctreeKey &octree_key, double line_spacing, bool support_overhangs_only) {
+            if (line_spacing == 0.)
+                return;
+            key.line_spacing = line_spacing;
+            if (! octree || key != octree_key) {
+                octree     = build_octree(mesh, *key.overhangs, line_spacing, support_overhangs_only);
+                octree_key = key;
+            } else
+                BOOST_LOG_TRIVIAL(debug) << "Reusing the " << (support_overhangs_only ? "support" : "adaptive") << " cubic infill octree";
+        };
+        update_octree(m_adaptive_fill_octree, m_adaptive_fill_octree_key, adaptive_line_spacing, false);
+        update_octree(m_support_fill_octree, m_support_fill_octree_key, support_line_spacing, true);
+
+        return std::make_pair(m_adaptive_fill_octree.get(), m_support_fill_octree.get());
     }
 
     void PrintObject::clear_layers()
@@ -3094,6 +3133,8 @@ static void fix_mesh_connectivity(TriangleMesh &mesh)
                 auto callback = TriangleMeshSlicer::throw_on_cancel_callback_type([print]() {print->throw_if_canceled(); });
                 // TriangleMeshSlicer needs shared vertices, also this calls the repair() function.
                 mesh.require_shared_vertices();
+                // The slicer reads the indexed triangle set only, drop the STL facets to lower the peak memory.
+                mesh.release_facets();
                 TriangleMeshSlicer mslicer(float(m_config.slice_closing_radius.value), float(m_config.model_precision.value));
                 mslicer.init(&mesh, callback);
                 mslicer.slice(z, mode, slicing_mode_normal_below_layer, mode_below, &layers, callback);
@@ -3123,6 +3164,7 @@ static void fix_mesh_connectivity(TriangleMesh &mesh)
                 auto callback = TriangleMeshSlicer::throw_on_cancel_callback_type([print]() {print->throw_if_canceled(); });
                 // TriangleMeshSlicer needs the shared vertices.
                 mesh.require_shared_vertices();
+                mesh.release_facets();
                 mslicer.init(&mesh, callback);
                 mslicer.slice(z, mode, &layers, callback);
                 m_print->throw_if_canceled();
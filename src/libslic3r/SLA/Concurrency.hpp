@@ -5,9 +5,11 @@
 #include <tbb/mutex.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_reduce.h>
+#include <tbb/pipeline.h>
 
 #include <algorithm>
 #include <numeric>
+#include <type_traits>
 
 #include <libslic3r/libslic3r.h>
 
@@ -76,6 +78,28 @@ template<> struct _ccr<true>
             from, to, init, std::forward<MergeFn>(mergefn),
             [](typename I::value_type &i) { return i; }, granularity);
     }
+
+    // Compute fn(i) for the indices [from, to) in parallel and pass the
+    // results to outfn in the order of the indices. At most max_live results
+    // are computed in advance, so the memory held does not depend on the
+    // number of indices.
+    template<class I, class Fn, class OutFn>
+    static void ordered_stream(I from, I to, size_t max_live, Fn &&fn, OutFn &&outfn)
+    {
+        using T = std::invoke_result_t<Fn, I>;
+        
+        I next = from;
+        tbb::parallel_pipeline(std::max(max_live, size_t(1)),
+            tbb::make_filter<void, I>(tbb::filter::serial_in_order,
+                [&next, to](tbb::flow_control &fc) -> I {
+                    if (next >= to) { fc.stop(); return to; }
+                    return next ++;
+                }) &
+            tbb::make_filter<I, T>(tbb::filter::parallel,
+                [&fn](I i) { return fn(i); }) &
+            tbb::make_filter<T, void>(tbb::filter::serial_in_order,
+                [&outfn](T result) { outfn(std::move(result)); }));
+    }
 };
 
 template<> struct _ccr<false>
@@ -133,6 +157,12 @@ public:
         return reduce(from, to, init, std::forward<MergeFn>(mergefn),
                       [](typename I::value_type &i) { return i; });
     }
+
+    template<class I, class Fn, class OutFn>
+    static void ordered_stream(I from, I to, size_t /* max_live */, Fn &&fn, OutFn &&outfn)
+    {
+        for (I i = from; i < to; ++i) outfn(fn(i));
+    }
 };
 
 using ccr = _ccr<USE_FULL_CONCURRENCY>;
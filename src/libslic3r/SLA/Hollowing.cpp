@@ -1,4 +1,6 @@
 #include <functional>
+#include <limits>
+#include <map>
 
 #include <libslic3r/OpenVDBUtils.hpp>
 #include <libslic3r/TriangleMesh.hpp>
@@ -7,6 +9,10 @@
 #include <libslic3r/ClipperUtils.hpp>
 #include <libslic3r/SimplifyMesh.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
+#include <libslic3r/SLA/Concurrency.hpp>
+#include <libslic3r/MarchingSquares.hpp>
+
+#include <openvdb/tools/Interpolation.h>
 
 #include <boost/log/trivial.hpp>
 
@@ -26,11 +32,25 @@ inline void _scale(S s, TriangleMesh &m) { m.scale(float(s)); }
 template<class S, class = FloatingOnly<S>>
 inline void _scale(S s, Contour3D &m) { for (auto &p : m.points) p *= s; }
 
-static TriangleMesh _generate_interior(const TriangleMesh  &mesh,
-                                       const JobController &ctl,
-                                       double               min_thickness,
-                                       double               voxel_scale,
-                                       double               closing_dist)
+struct Interior {
+    // Signed distance field of the model scaled up by voxel_scale, one voxel
+    // is one unit of the grid index space.
+    openvdb::FloatGrid::Ptr gridptr;
+    // The interior is the part of the grid with values below iso_surface.
+    double iso_surface = 0.;
+    double voxel_scale = 1.;
+};
+
+void InteriorDeleter::operator()(Interior *p)
+{
+    delete p;
+}
+
+static InteriorPtr _generate_interior(const TriangleMesh  &mesh,
+                                      const JobController &ctl,
+                                      double               min_thickness,
+                                      double               voxel_scale,
+                                      double               closing_dist)
 {
     TriangleMesh imesh{mesh};
     
@@ -65,21 +85,17 @@ static TriangleMesh _generate_interior(const TriangleMesh  &mesh,
     if (ctl.stopcondition()) return {};
     else ctl.statuscb(70, L("Hollowing"));
     
-    double iso_surface = D;
-    double adaptivity = 0.;
-    auto omesh = grid_to_mesh(*gridptr, iso_surface, adaptivity);
-    
-    _scale(1. / voxel_scale, omesh);
-    
-    if (ctl.stopcondition()) return {};
-    else ctl.statuscb(100, L("Hollowing"));
+    InteriorPtr interior{new Interior{}};
+    interior->gridptr     = std::move(gridptr);
+    interior->iso_surface = D;
+    interior->voxel_scale = voxel_scale;
     
-    return omesh;
+    return interior;
 }
 
-std::unique_ptr<TriangleMesh> generate_interior(const TriangleMesh &   mesh,
-                                                const HollowingConfig &hc,
-                                                const JobController &  ctl)
+InteriorPtr generate_interior_grid(const TriangleMesh &   mesh,
+                                   const HollowingConfig &hc,
+                                   const JobController &  ctl)
 {
     static const double MIN_OVERSAMPL = 3.;
     static const double MAX_OVERSAMPL = 8.;
@@ -92,15 +108,22 @@ std::unique_ptr<TriangleMesh> generate_interior(const TriangleMesh &   mesh,
     //
     // max 8x upscale, min is native voxel size
     auto voxel_scale = MIN_OVERSAMPL + (MAX_OVERSAMPL - MIN_OVERSAMPL) * hc.quality;
-    auto meshptr = std::make_unique<TriangleMesh>(
-        _generate_interior(mesh, ctl, hc.min_thickness, voxel_scale,
-                           hc.closing_distance));
+    return _generate_interior(mesh, ctl, hc.min_thickness, voxel_scale,
+                              hc.closing_distance);
+}
+
+TriangleMesh get_interior_mesh(const Interior &interior)
+{
+    double adaptivity = 0.;
+    auto omesh = grid_to_mesh(*interior.gridptr, interior.iso_surface, adaptivity);
+    
+    _scale(1. / interior.voxel_scale, omesh);
     
-    if (meshptr && !meshptr->empty()) {
+    if (! omesh.empty()) {
         
         // This flips the normals to be outward facing...
-        meshptr->require_shared_vertices();
-        indexed_triangle_set its = std::move(meshptr->its);
+        omesh.require_shared_vertices();
+        indexed_triangle_set its = std::move(omesh.its);
         
         Slic3r::simplify_mesh(its);
         
@@ -108,12 +131,157 @@ std::unique_ptr<TriangleMesh> generate_interior(const TriangleMesh &   mesh,
         for (stl_triangle_vertex_indices &ind : its.indices)
             std::swap(ind(0), ind(2));
         
-        *meshptr = Slic3r::TriangleMesh{its};
+        omesh = Slic3r::TriangleMesh{its};
+    }
+    
+    return omesh;
+}
+
+std::unique_ptr<TriangleMesh> generate_interior(const TriangleMesh &   mesh,
+                                                const HollowingConfig &hc,
+                                                const JobController &  ctl)
+{
+    InteriorPtr interior = generate_interior_grid(mesh, hc, ctl);
+    
+    auto meshptr = std::make_unique<TriangleMesh>();
+    if (interior && ! ctl.stopcondition()) {
+        *meshptr = get_interior_mesh(*interior);
+        ctl.statuscb(100, L("Hollowing"));
     }
     
     return meshptr;
 }
 
+// One horizontal cut through the distance field of an Interior, sampled
+// as a raster for the marching squares. Pixels have half the voxel size.
+struct InteriorSliceRaster {
+    static constexpr double PixelSize = 0.5;
+    
+    openvdb::FloatGrid::ConstAccessor accessor;
+    // Index space coordinates of the pixel at row 0, column 0.
+    double x0, y0, z;
+    size_t rows, cols;
+    float  iso;
+    
+    InteriorSliceRaster(const openvdb::FloatGrid &grid, float iso_surface)
+        : accessor(grid.getConstAccessor()), iso(iso_surface)
+    {}
+    
+    // Positive inside the interior, negative outside.
+    float get(size_t row, size_t col) const
+    {
+        openvdb::Vec3d p(x0 + col * PixelSize, y0 + row * PixelSize, z);
+        openvdb::Coord ijk = openvdb::Coord::round(p);
+        // Inactive voxels only carry the sign of the distance, their value
+        // would distort the interpolation at the border of the narrow band.
+        if (! accessor.isValueOn(ijk))
+            return accessor.getValue(ijk) < 0.f ?
+                       std::numeric_limits<float>::max() :
+                       std::numeric_limits<float>::lowest();
+        
+        return iso - openvdb::tools::BoxSampler::sample(accessor, p);
+    }
+};
+
+}} // namespace Slic3r::sla
+
+namespace marchsq {
+
+template<> struct _RasterTraits<Slic3r::sla::InteriorSliceRaster> {
+    using Rst = Slic3r::sla::InteriorSliceRaster;
+    
+    // The type of pixel cell in the raster
+    using ValueType = float;
+    
+    // Value at a given position
+    static float get(const Rst &rst, size_t row, size_t col) { return rst.get(row, col); }
+    
+    // Number of rows and cols of the raster
+    static size_t rows(const Rst &rst) { return rst.rows; }
+    static size_t cols(const Rst &rst) { return rst.cols; }
+};
+
+} // namespace marchsq
+
+namespace Slic3r { namespace sla {
+
+std::vector<ExPolygons> slice_interior(const Interior &          interior,
+                                       const std::vector<float> &slice_grid,
+                                       std::function<void(void)> thr)
+{
+    using LeafNode = openvdb::FloatGrid::TreeType::LeafNodeType;
+    
+    const openvdb::FloatGrid &grid = *interior.gridptr;
+    
+    // The interior contour of a slice lies within the narrow band of the
+    // distance field. Collect the XY extents of the narrow band leaf nodes
+    // per each row of leaf nodes, to sample only that part of a slice.
+    std::map<int, openvdb::CoordBBox> leaf_rows;
+    for (auto leaf = grid.tree().cbeginLeaf(); leaf; ++leaf) {
+        openvdb::CoordBBox bb = leaf->getNodeBoundingBox();
+        auto it = leaf_rows.find(bb.min().z());
+        if (it == leaf_rows.end())
+            leaf_rows.emplace(bb.min().z(), bb);
+        else
+            it->second.expand(bb);
+    }
+    
+    auto leaf_row_origin = [](int z) {
+        return z - (z & int(LeafNode::DIM - 1));
+    };
+    
+    std::vector<ExPolygons> slices(slice_grid.size());
+    
+    sla::ccr::for_each(size_t(0), slice_grid.size(), [&](size_t i) {
+        thr();
+        
+        double z  = double(slice_grid[i]) * interior.voxel_scale;
+        int    zi = int(std::floor(z));
+        
+        // The box sampler reads the voxels at zi and zi + 1.
+        openvdb::CoordBBox bb;
+        for (int zz : {zi, zi + 1}) {
+            auto it = leaf_rows.find(leaf_row_origin(zz));
+            if (it != leaf_rows.end())
+                bb.expand(it->second);
+        }
+        
+        if (bb.empty())
+            return;
+        
+        InteriorSliceRaster rst(grid, float(interior.iso_surface));
+        rst.x0   = bb.min().x();
+        rst.y0   = bb.min().y();
+        rst.z    = z;
+        rst.cols = size_t((bb.max().x() - bb.min().x()) / InteriorSliceRaster::PixelSize) + 1;
+        rst.rows = size_t((bb.max().y() - bb.min().y()) / InteriorSliceRaster::PixelSize) + 1;
+        
+        // One marching square spans a voxel, its edges are refined to the
+        // pixel size.
+        std::vector<marchsq::Ring> rings = marchsq::execute(rst, 0.f, {2, 2});
+        
+        Polygons polys;
+        polys.reserve(rings.size());
+        
+        double px = InteriorSliceRaster::PixelSize / interior.voxel_scale;
+        double ox = rst.x0 / interior.voxel_scale;
+        double oy = rst.y0 / interior.voxel_scale;
+        for (const marchsq::Ring &ring : rings) {
+            Polygon poly; Points &pts = poly.points;
+            pts.reserve(ring.size());
+            
+            for (const marchsq::Coord &crd : ring)
+                pts.emplace_back(scaled(ox + crd.c * px), scaled(oy + crd.r * px));
+            
+            polys.emplace_back(std::move(poly));
+        }
+        
+        slices[i] = union_ex(polys);
+    });
+    
+    return slices;
+}
+
 Contour3D DrainHole::to_mesh() const
 {
     auto r = double(radius);
@@ -4,6 +4,7 @@
 #include <memory>
 #include <libslic3r/SLA/Contour3D.hpp>
 #include <libslic3r/SLA/JobController.hpp>
+#include <libslic3r/ExPolygon.hpp>
 
 namespace Slic3r {
 
@@ -60,6 +61,25 @@ using DrainHoles = std::vector<DrainHole>;
 
 constexpr float HoleStickOutLength = 1.f;
 
+// The distance field of a hollowed model, from which the interior can be
+// either extracted as a mesh or sliced directly.
+struct Interior;
+struct InteriorDeleter { void operator()(Interior *p); };
+using InteriorPtr = std::unique_ptr<Interior, InteriorDeleter>;
+
+InteriorPtr generate_interior_grid(const TriangleMesh &mesh,
+                                   const HollowingConfig &  = {},
+                                   const JobController &ctl = {});
+
+// Extract the interior mesh, its normals are facing inwards.
+TriangleMesh get_interior_mesh(const Interior &interior);
+
+// Slice the interior at the given heights by contouring the distance field
+// with the marching squares, without extracting the interior mesh first.
+std::vector<ExPolygons> slice_interior(const Interior &          interior,
+                                       const std::vector<float> &slice_grid,
+                                       std::function<void(void)> thr = [] {});
+
 std::unique_ptr<TriangleMesh> generate_interior(const TriangleMesh &mesh,
                                                 const HollowingConfig &  = {},
                                                 const JobController &ctl = {});
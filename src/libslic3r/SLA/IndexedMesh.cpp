@@ -53,6 +53,19 @@ public:
         closest = closest_vec3d;
         return dist;
     }
+
+    std::vector<double> squared_distances(const TriangleMesh& tm,
+                                          const std::vector<Vec3d> &points,
+                                          std::vector<size_t> &face_ids,
+                                          std::vector<Vec3d>  &closest)
+    {
+        std::vector<double> dists;
+        AABBTreeIndirect::squared_distances_to_indexed_triangle_set(
+            tm.its.vertices,
+            tm.its.indices,
+            m_tree, points, dists, face_ids, closest);
+        return dists;
+    }
 };
 
 static const constexpr double MESH_EPS = 1e-6;
@@ -106,7 +119,7 @@ const Vec3i32& IndexedMesh::indices(size_t idx) const
 }
 
 Vec3d IndexedMesh::normal_by_face_id(int face_id) const {
-    return m_tm->stl.facet_start[face_id].normal.cast<double>();
+    return m_tm->facet(face_id).normal.cast<double>();
 }
 
 IndexedMesh::hit_result
@@ -280,6 +293,17 @@ double IndexedMesh::squared_distance(const Vec3d &p, int& i, Vec3d& c) const {
     return sqdst;
 }
 
+std::vector<double> IndexedMesh::squared_distances(const std::vector<Vec3d> &points,
+                                                   std::vector<size_t> &face_ids,
+                                                   std::vector<Vec3d>  &closest) const
+{
+    return m_aabb->squared_distances(*m_tm, points, face_ids, closest);
+}
+
+
+// Number of the points, for which the hosting triangles are searched for
+// by a single batched query of normals().
+static const constexpr size_t NORMALS_BATCH_SIZE = 4096;
 
 static bool point_on_edge(const Vec3d& p, const Vec3d& e1, const Vec3d& e2,
                           double eps = 0.05)
@@ -308,16 +332,30 @@ PointSet normals(const PointSet& points,
 
     PointSet ret(range.size(), 3);
 
+    // Find the hosting triangles of the points in batches, checking for
+    // cancellation between the batches.
+    std::vector<size_t> faceids(range.size());
+    std::vector<Vec3d>  closest(range.size());
+    std::vector<Vec3d>  query_pts;
+    std::vector<size_t> batch_faceids;
+    std::vector<Vec3d>  batch_closest;
+    for (size_t begin = 0; begin < range.size(); begin += NORMALS_BATCH_SIZE) {
+        thr();
+        size_t end = std::min(range.size(), begin + NORMALS_BATCH_SIZE);
+        query_pts.clear();
+        for (size_t ridx = begin; ridx < end; ++ridx)
+            query_pts.emplace_back(points.row(Eigen::Index(range[ridx])));
+        mesh.squared_distances(query_pts, batch_faceids, batch_closest);
+        std::copy(batch_faceids.begin(), batch_faceids.end(), faceids.begin() + begin);
+        std::copy(batch_closest.begin(), batch_closest.end(), closest.begin() + begin);
+    }
+
     //    for (size_t ridx = 0; ridx < range.size(); ++ridx)
     ccr::for_each(size_t(0), range.size(),
-        [&ret, &mesh, &points, thr, eps, &range](size_t ridx) {
+        [&ret, &mesh, &faceids, &closest, thr, eps](size_t ridx) {
             thr();
-            unsigned el = range[ridx];
-            auto  eidx   = Eigen::Index(el);
-            int   faceid = 0;
-            Vec3d p;
-
-            mesh.squared_distance(points.row(eidx), faceid, p);
+            auto  faceid = faceids[ridx];
+            const Vec3d &p = closest[ridx];
 
             auto trindex = mesh.indices(faceid);
 
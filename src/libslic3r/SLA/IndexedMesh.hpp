@@ -128,6 +128,12 @@ public:
         return squared_distance(p, i, c);
     }
 
+    // Squared distances of many points at once, considerably faster than
+    // calling squared_distance() for each of them.
+    std::vector<double> squared_distances(const std::vector<Vec3d> &points,
+                                          std::vector<size_t> &face_ids,
+                                          std::vector<Vec3d>  &closest) const;
+
     Vec3d normal_by_face_id(int face_id) const;
 
     const TriangleMesh * get_triangle_mesh() const { return m_tm; }
@@ -2,6 +2,10 @@
 #define SLARASTER_CPP
 
 #include <functional>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <atomic>
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
@@ -67,6 +71,207 @@ EncodedRaster PPMRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
     return EncodedRaster(std::move(buf), "ppm");
 }
 
+namespace {
+
+void png_put_u32(std::vector<uint8_t> &buf, uint32_t v)
+{
+    buf.emplace_back(uint8_t(v >> 24));
+    buf.emplace_back(uint8_t(v >> 16));
+    buf.emplace_back(uint8_t(v >> 8));
+    buf.emplace_back(uint8_t(v));
+}
+
+// Finish the chunk opened by png_open_chunk: patch its length and append the CRC.
+void png_close_chunk(std::vector<uint8_t> &buf, size_t chunk_begin)
+{
+    size_t datalen = buf.size() - chunk_begin - 8;
+    for (size_t i = 0; i < 4; ++i)
+        buf[chunk_begin + i] = uint8_t(datalen >> (24 - 8 * i));
+    
+    // The CRC covers the chunk type and the data
+    auto crc = uint32_t(mz_crc32(MZ_CRC32_INIT, buf.data() + chunk_begin + 4,
+                                 datalen + 4));
+    png_put_u32(buf, crc);
+}
+
+size_t png_open_chunk(std::vector<uint8_t> &buf, const char *type)
+{
+    size_t chunk_begin = buf.size();
+    png_put_u32(buf, 0); // length, filled in by png_close_chunk
+    buf.insert(buf.end(), type, type + 4);
+    return chunk_begin;
+}
+
+mz_bool png_putter(const void *data, int len, void *user)
+{
+    auto &buf = *static_cast<std::vector<uint8_t> *>(user);
+    auto  ptr = static_cast<const uint8_t *>(data);
+    buf.insert(buf.end(), ptr, ptr + len);
+    return MZ_TRUE;
+}
+
+} // namespace
+
+EncodedRaster FastPNGRasterEncoder::operator()(const void *ptr, size_t w,
+                                               size_t h, size_t num_components)
+{
+    static const uint8_t png_sig[] = {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a};
+    static const uint8_t chans[]   = {0x00, 0x00, 0x04, 0x02, 0x06};
+    
+    if (num_components < 1 || num_components > 4) return EncodedRaster({}, "png");
+    
+    std::vector<uint8_t> buf;
+    buf.reserve(w * h / 32 + 1024);
+    buf.insert(buf.end(), std::begin(png_sig), std::end(png_sig));
+    
+    size_t chunk = png_open_chunk(buf, "IHDR");
+    png_put_u32(buf, uint32_t(w));
+    png_put_u32(buf, uint32_t(h));
+    buf.insert(buf.end(), {8, chans[num_components], 0, 0, 0});
+    png_close_chunk(buf, chunk);
+    
+    chunk = png_open_chunk(buf, "IDAT");
+    
+    std::unique_ptr<tdefl_compressor, void(*)(tdefl_compressor*)> comp{
+        tdefl_compressor_alloc(), tdefl_compressor_free};
+    
+    if (!comp) return EncodedRaster({}, "png");
+    
+    int flags = 1 | TDEFL_RLE_MATCHES | TDEFL_GREEDY_PARSING_FLAG |
+                TDEFL_WRITE_ZLIB_HEADER;
+    
+    tdefl_init(comp.get(), png_putter, &buf, flags);
+    
+    size_t bpl = w * num_components;
+    auto   rows = static_cast<const uint8_t *>(ptr);
+    
+    // An "up" filtered copy of a repeated scanline is all zeros
+    std::vector<uint8_t> zeros(bpl, 0);
+    
+    for (size_t y = 0; y < h; ++y) {
+        const uint8_t *row = rows + y * bpl;
+        bool repeated = y > 0 && std::memcmp(row, row - bpl, bpl) == 0;
+        
+        uint8_t filter = repeated ? 2 : 0;
+        tdefl_compress_buffer(comp.get(), &filter, 1, TDEFL_NO_FLUSH);
+        tdefl_compress_buffer(comp.get(), repeated ? zeros.data() : row, bpl,
+                              TDEFL_NO_FLUSH);
+    }
+    
+    if (tdefl_compress_buffer(comp.get(), nullptr, 0, TDEFL_FINISH) !=
+        TDEFL_STATUS_DONE)
+        return EncodedRaster({}, "png");
+    
+    png_close_chunk(buf, chunk);
+    png_close_chunk(buf, png_open_chunk(buf, "IEND"));
+    
+    return EncodedRaster(std::move(buf), "png");
+}
+
+uint64_t raster_hash(const void *ptr, size_t w, size_t h, size_t num_components)
+{
+    const uint64_t prime = 0x100000001b3ull;
+    
+    size_t len = w * h * num_components;
+    auto   bytes = static_cast<const uint8_t *>(ptr);
+    
+    uint64_t hash = 0xcbf29ce484222325ull ^ (uint64_t(w) << 32) ^ (uint64_t(h) << 8) ^ num_components;
+    
+    // Mix whole words first, byte-wise FNV-1a would be the bottleneck on
+    // a multi-megapixel layer.
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    
+    for (; i < len; ++i) hash = (hash ^ bytes[i]) * prime;
+    
+    return hash;
+}
+
+struct CachedRasterEncoder::Cache {
+    // The raw pixels are kept to verify a hash match, the hash alone may collide.
+    struct Entry {
+        uint64_t             hash;
+        size_t               w, h, num_components;
+        std::vector<uint8_t> raw;
+        EncodedRaster        encoded;
+        
+        size_t bytes() const { return raw.size() + encoded.size(); }
+        
+        bool matches(uint64_t hash_, const void *ptr, size_t w_, size_t h_, size_t num_components_) const
+        {
+            return hash == hash_ && w == w_ && h == h_ && num_components == num_components_ &&
+                   std::memcmp(raw.data(), ptr, raw.size()) == 0;
+        }
+    };
+    
+    RasterEncoder encoder;
+    size_t        max_bytes;
+    
+    std::mutex mutex;
+    // Oldest entries first. Only a few full size rasters fit into the bound,
+    // thus a linear search is fine.
+    std::deque<Entry> entries;
+    size_t            bytes = 0;
+    std::atomic<size_t> reused{0};
+    
+    Cache(RasterEncoder enc, size_t max_bytes) : encoder(std::move(enc)), max_bytes(max_bytes) {}
+    
+    const Entry* find(uint64_t hash, const void *ptr, size_t w, size_t h, size_t num_components) const
+    {
+        for (const Entry &entry : entries)
+            if (entry.matches(hash, ptr, w, h, num_components))
+                return &entry;
+        return nullptr;
+    }
+};
+
+CachedRasterEncoder::CachedRasterEncoder(RasterEncoder encoder, size_t max_bytes)
+    : m_cache(std::make_shared<Cache>(std::move(encoder), max_bytes))
+{}
+
+EncodedRaster CachedRasterEncoder::operator()(const void *ptr, size_t w,
+                                              size_t h, size_t num_components)
+{
+    uint64_t key = raster_hash(ptr, w, h, num_components);
+    
+    {
+        std::lock_guard<std::mutex> lk(m_cache->mutex);
+        if (const Cache::Entry *entry = m_cache->find(key, ptr, w, h, num_components)) {
+            ++m_cache->reused;
+            return entry->encoded;
+        }
+    }
+    
+    // Encode outside of the lock. Two threads may encode the same raster
+    // simultaneously, the result is the same either way.
+    EncodedRaster enc = m_cache->encoder(ptr, w, h, num_components);
+    
+    if (w * h * num_components + enc.size() > m_cache->max_bytes)
+        return enc;
+    
+    auto bytes = static_cast<const uint8_t *>(ptr);
+    std::vector<uint8_t> raw(bytes, bytes + w * h * num_components);
+    
+    std::lock_guard<std::mutex> lk(m_cache->mutex);
+    if (! m_cache->find(key, raw.data(), w, h, num_components)) {
+        m_cache->entries.push_back({key, w, h, num_components, std::move(raw), enc});
+        m_cache->bytes += m_cache->entries.back().bytes();
+        while (m_cache->bytes > m_cache->max_bytes) {
+            m_cache->bytes -= m_cache->entries.front().bytes();
+            m_cache->entries.pop_front();
+        }
+    }
+    
+    return enc;
+}
+
+size_t CachedRasterEncoder::reused() const { return m_cache->reused.load(); }
+
 std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const RasterBase::Resolution &res,
     const RasterBase::PixelDim &  pxdim,
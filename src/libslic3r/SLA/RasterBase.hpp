@@ -7,6 +7,8 @@
 #include <array>
 #include <utility>
 #include <cstdint>
+#include <functional>
+#include <string>
 
 #include <libslic3r/ExPolygon.hpp>
 #include <libslic3r/SLA/Concurrency.hpp>
@@ -110,6 +112,35 @@ struct PPMRasterEncoder {
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
 };
 
+// PNG encoder for the mostly two-tone SLA masks. Scanlines repeating the
+// previous one are written with the "up" filter, which turns them into runs of
+// zeros, and the deflate stage only searches for run-length matches. The
+// output is a regular PNG, just produced a lot faster than PNGRasterEncoder.
+struct FastPNGRasterEncoder {
+    EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+};
+
+// Hash of the raw pixel data, used to detect identical layers.
+uint64_t raster_hash(const void *ptr, size_t w, size_t h, size_t num_components);
+
+// Wraps an encoder and reuses the result for rasters with identical content.
+// Copies share the cache, so it can be used from multiple threads. The cache
+// keeps a copy of the raw pixels of each entry, it is bounded by the bytes
+// held: the oldest entries are dropped first and a raster larger than the
+// bound is not cached at all.
+class CachedRasterEncoder {
+    struct Cache;
+    std::shared_ptr<Cache> m_cache;
+    
+public:
+    explicit CachedRasterEncoder(RasterEncoder encoder, size_t max_bytes = 64 * 1024 * 1024);
+    
+    EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+    
+    // Number of rasters served from the cache so far.
+    size_t reused() const;
+};
+
 std::ostream& operator<<(std::ostream &stream, const EncodedRaster &bytes);
 
 // If gamma is zero, thresholding will be performed which disables AA.
@@ -275,12 +275,52 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
             }
         }
         // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
+        // The islands only read the grid of the layers below, so they can be
+        // covered in parallel. Every island gets a generator seeded from the
+        // layer seed and its index, which keeps the result deterministic.
+        std::mt19937::result_type layer_seed = m_rng();
+        std::vector<IslandSupportPoints> island_points(layer_top->islands.size());
+        auto init_island_points = [layer_seed, &point_grid](IslandSupportPoints &out, size_t idx) {
+            std::seed_seq seq{layer_seed, std::mt19937::result_type(idx)};
+            out.rng.seed(seq);
+            out.grid.cell_size = point_grid.cell_size;
+        };
+        ccr::for_each(size_t(0), layer_top->islands.size(),
+                      [this, layer_top, &init_island_points, &island_points, &point_grid](size_t idx) {
+            Structure &s = layer_top->islands[idx];
+            
             // Penalization resulting from large diff from the last layer:
             s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
 
-            add_support_points(s, point_grid);
+            IslandSupportPoints &out = island_points[idx];
+            init_island_points(out, idx);
+            add_support_points(s, point_grid, out);
+        });
+
+        // Merge in island order. An island with a point too close to a point
+        // of a neighboring island of this layer is covered again, serially
+        // against the merged grid, as the serial version would have done.
+        // Just dropping the point could leave a new island unsupported.
+        for (size_t idx = 0; idx < island_points.size(); ++ idx) {
+            Structure &s = layer_top->islands[idx];
+            IslandSupportPoints &out = island_points[idx];
+            
+            bool collides = std::any_of(out.points.begin(), out.points.end(), [&](const SupportPoint &p) {
+                return point_grid.collides_with(p.pos.head<2>(), float(layer_top->print_z), m_config.minimal_distance);
+            });
+            
+            if (collides) {
+                s.supports_force_this_layer -= m_config.support_force() * out.points.size();
+                out = IslandSupportPoints();
+                init_island_points(out, idx);
+                add_support_points(s, point_grid, out);
             }
+            
+            for (const SupportPoint &p : out.points) {
+                point_grid.insert(p.pos.head<2>(), &s);
+                m_output.emplace_back(p);
+            }
+        }
 
         m_throw_on_cancel();
 
@@ -297,7 +337,7 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
     }
 }
 
-void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d)
+void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, const SupportPointGenerator::PointGrid3D &grid3d, IslandSupportPoints &out) const
 {
     // Select each type of surface (overrhang, dangling, slope), derive the support
     // force deficit for it and call uniformly conver with the right params
@@ -310,12 +350,12 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
     if (s.islands_below.empty()) {
         // completely new island - needs support no doubt
         // deficit is full, there is nothing below that would hold this island
-        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
+        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, out, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
         return;
     }
 
     if (! s.overhangs.empty()) {
-        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d);
+        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d, out);
     }
 
     auto areafn = [](double sum, auto &p) { return sum + p.area() * SCALING_FACTOR * SCALING_FACTOR; };
@@ -326,13 +366,13 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
         // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
 
         double a = std::accumulate(s.dangling_areas.begin(), s.dangling_areas.end(), 0., areafn);
-        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, out, icfWithBoundary);
     }
 
     current = s.supports_force_total();
     if (! s.overhangs_slopes.empty()) {
         double a = std::accumulate(s.overhangs_slopes.begin(), s.overhangs_slopes.end(), 0., areafn);
-        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, out, icfWithBoundary);
     }
 }
 
@@ -547,7 +587,7 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
 }
 
 
-void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags)
+void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, const PointGrid3D &grid3d, IslandSupportPoints &out, IslandCoverageFlags flags) const
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
@@ -586,14 +626,15 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     std::vector<Vec2f> raw_samples =
         flags & icfWithBoundary ?
             sample_expolygon_with_boundary(islands, samples_per_mm2,
-                                           5.f / poisson_radius, m_rng) :
-            sample_expolygon(islands, samples_per_mm2, m_rng);
+                                           5.f / poisson_radius, out.rng) :
+            sample_expolygon(islands, samples_per_mm2, out.rng);
 
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
         poisson_samples = poisson_disk_from_samples(raw_samples, poisson_radius,
-            [&structure, &grid3d, min_spacing](const Vec2f &pos) {
-                return grid3d.collides_with(pos, structure.layer->print_z, min_spacing);
+            [&structure, &grid3d, &out, min_spacing](const Vec2f &pos) {
+                return grid3d.collides_with(pos, structure.layer->print_z, min_spacing) ||
+                       out.grid.collides_with(pos, structure.layer->print_z, min_spacing);
             });
         if (poisson_samples.size() >= poisson_samples_target || m_config.minimal_distance > poisson_radius-EPSILON)
             break;
@@ -619,13 +660,13 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
 
 //    assert(! poisson_samples.empty());
     if (poisson_samples_target < poisson_samples.size()) {
-        std::shuffle(poisson_samples.begin(), poisson_samples.end(), m_rng);
+        std::shuffle(poisson_samples.begin(), poisson_samples.end(), out.rng);
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
     for (const Vec2f &pt : poisson_samples) {
-        m_output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
+        out.points.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
         structure.supports_force_this_layer += m_config.support_force();
-        grid3d.insert(pt, &structure);
+        out.grid.insert(pt, &structure);
     }
 }
 
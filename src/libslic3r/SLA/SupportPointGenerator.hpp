@@ -147,7 +147,7 @@ public:
         Vec3f   cell_size;
         Grid    grid;
         
-        Vec3i32 cell_id(const Vec3f &pos) {
+        Vec3i32 cell_id(const Vec3f &pos) const {
             return Vec3i32(int(floor(pos.x() / cell_size.x())),
                          int(floor(pos.y() / cell_size.y())),
                          int(floor(pos.z() / cell_size.z())));
@@ -160,7 +160,7 @@ public:
             grid.emplace(cell_id(pt.position), pt);
         }
         
-        bool collides_with(const Vec2f &pos, float print_z, float radius) {
+        bool collides_with(const Vec2f &pos, float print_z, float radius) const {
             Vec3f pos3d(pos.x(), pos.y(), print_z);
             Vec3i32 cell = cell_id(pos3d);
             std::pair<Grid::const_iterator, Grid::const_iterator> it_pair = grid.equal_range(cell);
@@ -179,7 +179,7 @@ public:
         }
         
     private:
-        bool collides_with(const Vec3f &pos, float radius, Grid::const_iterator it_begin, Grid::const_iterator it_end) {
+        bool collides_with(const Vec3f &pos, float radius, Grid::const_iterator it_begin, Grid::const_iterator it_end) const {
             for (Grid::const_iterator it = it_begin; it != it_end; ++ it) {
                 float dist2 = (it->second.position - pos).squaredNorm();
                 if (dist2 < radius * radius)
@@ -189,6 +189,15 @@ public:
         }
     };
     
+    // Support points generated for one island of a layer. The islands of a
+    // layer are covered in parallel, each with its own random generator and
+    // a grid of its own points, and merged into the output in island order.
+    struct IslandSupportPoints {
+        std::vector<SupportPoint> points;
+        PointGrid3D               grid;
+        std::mt19937              rng;
+    };
+    
     void execute(const std::vector<ExPolygons> &slices,
                  const std::vector<float> &     heights);
     
@@ -205,9 +214,9 @@ public:
 
 private:
 
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags = icfNone);
+    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, const PointGrid3D &grid3d, IslandSupportPoints &out, IslandCoverageFlags flags = icfNone) const;
 
-    void add_support_points(Structure& structure, PointGrid3D &grid3d);
+    void add_support_points(Structure& structure, const PointGrid3D &grid3d, IslandSupportPoints &out) const;
 
     void project_onto_mesh(std::vector<SupportPoint>& points) const;
 
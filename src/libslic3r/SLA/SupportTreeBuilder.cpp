@@ -42,7 +42,10 @@ Pad::Pad(const TriangleMesh &support_mesh,
     create_pad(sup_contours, model_contours, tmesh, pcfg);
     
     tmesh.translate(0, 0, float(zlevel));
-    if (!tmesh.empty()) tmesh.require_shared_vertices();
+    if (!tmesh.empty()) {
+        tmesh.require_shared_vertices();
+        tmesh.release_facets();
+    }
 }
 
 const TriangleMesh &SupportTreeBuilder::add_pad(const ExPolygons &modelbase,
@@ -176,7 +179,10 @@ const TriangleMesh &SupportTreeBuilder::merged_mesh(size_t steps) const
     
     // The mesh will be passed by const-pointer to TriangleMeshSlicer,
     // which will need this.
-    if (!m_meshcache.empty()) m_meshcache.require_shared_vertices();
+    if (!m_meshcache.empty()) {
+        m_meshcache.require_shared_vertices();
+        m_meshcache.release_facets();
+    }
     
     BoundingBoxf3 &&bb = m_meshcache.bounding_box();
     m_model_height       = bb.max(Z) - bb.min(Z);
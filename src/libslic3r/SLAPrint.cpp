@@ -8,6 +8,8 @@
 
 #include <unordered_set>
 #include <numeric>
+#include <thread>
+#include <chrono>
 
 #include <tbb/parallel_for.h>
 #include <boost/filesystem/path.hpp>
@@ -116,6 +118,47 @@ bool validate_pad(const TriangleMesh &pad, const sla::PadConfig &pcfg)
     return !pad.empty() || (pcfg.embed_object.enabled && !pcfg.embed_object.everywhere);
 }
 
+void SLAPrinter::for_each_encoded_layer(const SLAPrint &print, const EncodedLayerFn &fn) const
+{
+    if (! m_draw_layer || m_layer_count == 0) return;
+    
+    sla::CachedRasterEncoder encoder(get_encoder());
+    sla::RasterBase::Resolution res;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    size_t window = 2 * size_t(std::max(1u, std::thread::hardware_concurrency()));
+    size_t idx_out = 0;
+    int    last_percent = -1;
+    sla::ccr::ordered_stream(size_t(0), m_layer_count, window,
+                             [this, &print, &encoder, &res] (size_t idx) {
+                                 if (print.canceled()) throw CanceledException();
+                                 auto rst = create_raster();
+                                 m_draw_layer(*rst, idx);
+                                 if (idx == 0) res = rst->resolution();
+                                 return rst->encode(encoder);
+                             },
+                             [this, &print, &fn, &idx_out, &last_percent] (const sla::EncodedRaster &rst) {
+                                 if (print.canceled()) throw CanceledException();
+                                 fn(rst);
+                                 int percent = int(min_export_status + (++ idx_out * (100 - min_export_status)) / m_layer_count);
+                                 if (percent != last_percent) {
+                                     last_percent = percent;
+                                     print.set_status(percent, std::string(L("Exporting layer %s / %s")),
+                                                      std::vector<std::string>{ std::to_string(idx_out), std::to_string(m_layer_count) },
+                                                      PrintBase::SlicingStatus::DEFAULT);
+                                 }
+                             });
+    
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    BOOST_LOG_TRIVIAL(info)
+        << "Encoded " << m_layer_count << " layers of " << res.width_px << "x"
+        << res.height_px << " px in " << secs << " s ("
+        << 1000. * secs / m_layer_count << " ms/layer, "
+        << (secs > 0. ? 1e-6 * res.pixels() * m_layer_count / secs : 0.)
+        << " Mpx/s), " << encoder.reused() << " identical layers reused.";
+}
+
 void SLAPrint::clear()
 {
     tbb::mutex::scoped_lock lock(this->state_mutex());
@@ -215,6 +258,8 @@ SLAPrint::ApplyStatus SLAPrint::apply(const Model &model, DynamicPrintConfig con
     tbb::mutex::scoped_lock lock(this->state_mutex());
 
     // The following call may stop the background processing.
+    if (const ConfigOptionInt *opt_threads = config.option<ConfigOptionInt>("slicing_threads"); opt_threads != nullptr)
+        this->set_num_threads(opt_threads->value);
     bool invalidate_all_model_objects = false;
     if (! print_diff.empty())
         update_apply_status(this->invalidate_state_by_config_options(print_diff, invalidate_all_model_objects));
@@ -697,6 +742,11 @@ bool SLAPrint::invalidate_step(SLAPrintStep step)
 }
 
 void SLAPrint::process()
+{
+    this->execute_in_arena([this]() { this->_process(); });
+}
+
+void SLAPrint::_process()
 {
     if (m_objects.empty())
         return;
@@ -788,8 +838,9 @@ void SLAPrint::process()
         st += printsteps.progressrange(currentstep);
     }
 
-    // If everything vent well
-    m_report_status(*this, 100, L("Slicing done"));
+    // If everything vent well. The rest of the progress range is reported
+    // by the export of the layers, if any.
+    m_report_status(*this, SLAPrinter::min_export_status, L("Slicing done"));
 
 #ifdef SLAPRINT_DO_BENCHMARK
     std::string csvbenchstr;
@@ -846,6 +897,7 @@ bool SLAPrint::invalidate_state_by_config_options(const std::vector<t_config_opt
         "printer_technology",
         "output_filename_format",
         "output_format",
+        "slicing_threads",
         "fast_tilt_time",
         "slow_tilt_time",
         "area_fill",
@@ -911,6 +963,8 @@ SLAPrintObject::SLAPrintObject(SLAPrint *print, ModelObject *model_object)
         if (!obj.empty()) {
             obj.transform(m_trafo);
             obj.require_shared_vertices();
+            // Keep just the indexed triangle set, see TriangleMesh::release_facets().
+            obj.release_facets();
         }
     })
 {}
@@ -2,10 +2,12 @@
 #define slic3r_SLAPrint_hpp_
 
 #include <cstdint>
+#include <functional>
 #include <mutex>
 #include "PrintBase.hpp"
 #include "SLA/RasterBase.hpp"
 #include "SLA/SupportTree.hpp"
+#include "SLA/Hollowing.hpp"
 #include "Point.hpp"
 #include "MTUtils.hpp"
 #include "Zipper.hpp"
@@ -329,6 +331,11 @@ private:
     public:
         
         TriangleMesh interior;
+        // Slices of the interior contoured from its distance field, which is
+        // released right after hollowing. They are valid for the slice levels
+        // they were made at, otherwise the interior mesh is sliced instead.
+        std::vector<float>      interior_slice_levels;
+        std::vector<ExPolygons> interior_slices;
         mutable TriangleMesh hollow_mesh_with_holes; // caching the complete hollowed mesh
     };
     
@@ -374,27 +381,45 @@ struct SLAPrintStatistics
 
 class SLAPrinter {
 protected:
-    std::vector<sla::EncodedRaster> m_layers;
+    // Draws one layer into a raster, it has to be thread safe.
+    using DrawLayerFn = std::function<void(sla::RasterBase& raster, size_t lyrid)>;
+    
+    DrawLayerFn m_draw_layer;
+    size_t      m_layer_count = 0;
     
     virtual uqptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
     
+    using EncodedLayerFn = std::function<void(const sla::EncodedRaster &)>;
+    
+    // Rasterize and encode the layers in parallel and pass the encoded
+    // layers to fn in the order of the layers. Only a window of encoded
+    // layers is kept in memory, not the whole print. Identical layers are
+    // encoded only once. The progress is reported to the print from
+    // min_export_status up, the print may cancel the export by throwing
+    // CanceledException.
+    void for_each_encoded_layer(const SLAPrint &print, const EncodedLayerFn &fn) const;
+    
 public:
+    // The slicing steps report their status below this value, the rest of
+    // the progress range is left to the export rasterizing the layers.
+    static const constexpr unsigned min_export_status = 90;
+    
     virtual ~SLAPrinter() = default;
     
     virtual void apply(const SLAPrinterConfig &cfg) = 0;
     
-    // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
-    template<class Fn> void draw_layers(size_t layer_num, Fn &&drawfn)
+    // The layers are rasterized on demand by the export of an archive.
+    void draw_layers(size_t layer_num, DrawLayerFn drawfn)
     {
-        m_layers.resize(layer_num);
-        sla::ccr::for_each(size_t(0), m_layers.size(),
-                           [this, &drawfn] (size_t idx) {
-                               sla::EncodedRaster& enc = m_layers[idx];
-                               auto rst = create_raster();
-                               drawfn(*rst, idx);
-                               enc = rst->encode(get_encoder());
-                           });
+        m_layer_count = layer_num;
+        m_draw_layer  = std::move(drawfn);
+    }
+    
+    void clear_layers()
+    {
+        m_layer_count = 0;
+        m_draw_layer  = nullptr;
     }
 };
 
@@ -507,6 +532,9 @@ public:
     
 private:
     
+    // Body of process(), executed in the task arena of this print.
+    void _process();
+
     // Implement same logic as in SLAPrintObject
     bool invalidate_step(SLAPrintStep st);
 
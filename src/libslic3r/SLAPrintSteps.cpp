@@ -54,9 +54,11 @@ std::string OBJ_STEP_LABELS(size_t idx)
     return "Out of bounds!";
 }
 
+// The layers themselves are rasterized by the export, the rasterize step
+// only prepares their slices.
 const std::array<unsigned, slapsCount> PRINT_STEP_LEVELS = {
-    10, // slapsMergeSlicesAndEval
-    90, // slapsRasterize
+    70, // slapsMergeSlicesAndEval
+    30, // slapsRasterize
 };
 
 std::string PRINT_STEP_LABELS(size_t idx)
@@ -109,10 +111,26 @@ void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin
             slices[idx] = offset_ex(slices[idx], float(clpr_offs));
     }
     
-    if (start_efc > 0.) for (size_t i = 0; i < faded_lyrs; ++i) {
+    if (start_efc > 0.) for (size_t i = 0; i < faded_lyrs;) {
         size_t idx = po.m_slice_index[i].get_slice_idx(o);
-        if (idx < slices.size())
-            slices[idx] = elephant_foot_compensation(slices[idx], min_w, efc(i));
+        if (idx >= slices.size()) { ++i; continue; }
+
+        // The first layers of a model usually have the very same slices,
+        // only the compensation fades out. Compensate such a run of layers
+        // in one go, so that the contours are resampled only once.
+        std::vector<size_t> run_idx = {idx};
+        std::vector<double> run_efc = {efc(i)};
+        for (++i; i < faded_lyrs; ++i) {
+            size_t nidx = po.m_slice_index[i].get_slice_idx(o);
+            if (nidx >= slices.size() || slices[nidx] != slices[idx]) break;
+            run_idx.emplace_back(nidx);
+            run_efc.emplace_back(efc(i));
+        }
+
+        std::vector<ExPolygons> compensated =
+            elephant_foot_compensation(slices[idx], min_w, run_efc);
+        for (size_t r = 0; r < run_idx.size(); ++r)
+            slices[run_idx[r]] = std::move(compensated[r]);
     }
 }
 
@@ -131,13 +149,31 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     double quality  = po.m_config.hollowing_quality.getFloat();
     double closing_d = po.m_config.hollowing_closing_distance.getFloat();
     sla::HollowingConfig hlwcfg{thickness, quality, closing_d};
-    auto meshptr = generate_interior(po.transformed_mesh(), hlwcfg);
+    const TriangleMesh &mesh = po.transformed_mesh();
+    sla::InteriorPtr interior = sla::generate_interior_grid(mesh, hlwcfg);
+    TriangleMesh interior_mesh;
+    if (interior)
+        interior_mesh = sla::get_interior_mesh(*interior);
 
-    if (meshptr->empty())
+    if (interior_mesh.empty())
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
     else {
         po.m_hollowing_data.reset(new SLAPrintObject::HollowingData());
-        po.m_hollowing_data->interior = *meshptr;
+        po.m_hollowing_data->interior = std::move(interior_mesh);
+
+        // Contour the distance field at the slice levels of the model now,
+        // so that the grid does not outlive this step. Drilling does not
+        // change the levels unless a hole cuts off the bottom of the model,
+        // slice_model() slices the interior mesh in that case.
+        auto bb3d        = mesh.bounding_box();
+        auto slice_index = create_slice_index(po, bb3d);
+        auto thr         = [this]() { m_print->throw_if_canceled(); };
+        std::vector<float> levels;
+        levels.reserve(slice_index.size());
+        for (auto it = po.closest_slice_record(slice_index, float(bb3d.min(Z))); it != slice_index.end(); ++it)
+            levels.emplace_back(it->slice_level());
+        po.m_hollowing_data->interior_slices       = sla::slice_interior(*interior, levels, thr);
+        po.m_hollowing_data->interior_slice_levels = std::move(levels);
     }
 }
 
@@ -166,6 +202,7 @@ void SLAPrint::Steps::drill_holes(SLAPrintObject &po)
     if (! po.m_hollowing_data->interior.empty()) {
         hollowed_mesh.merge(po.m_hollowing_data->interior);
         hollowed_mesh.require_shared_vertices();
+        hollowed_mesh.release_facets();
     }
 
     if (! needs_drilling) {
@@ -196,6 +233,8 @@ void SLAPrint::Steps::drill_holes(SLAPrintObject &po)
     try {
         MeshBoolean::cgal::minus(*hollowed_mesh_cgal, *holes_mesh_cgal);
         hollowed_mesh = MeshBoolean::cgal::cgal_to_triangle_mesh(*hollowed_mesh_cgal);
+        hollowed_mesh.require_shared_vertices();
+        hollowed_mesh.release_facets();
     } catch (const std::runtime_error &) {
         throw Slic3r::SlicingError(L(
             "Drilling holes into the mesh failed. "
@@ -211,31 +250,37 @@ void SLAPrint::Steps::drill_holes(SLAPrintObject &po)
 // model geometry starts on the ground level and the initial layer is part
 // of it. In any case, the model and the supports have to be sliced in the
 // same imaginary grid (the height vector argument to TriangleMeshSlicer).
-void SLAPrint::Steps::slice_model(SLAPrintObject &po)
-{   
-    const TriangleMesh &mesh = po.get_mesh_to_print();
-
-    // We need to prepare the slice index...
-    
+std::vector<SliceRecord> SLAPrint::Steps::create_slice_index(const SLAPrintObject &po, const BoundingBoxf3 &bb3d) const
+{
     double  lhd  = m_print->m_objects.front()->m_config.layer_height.getFloat();
     float   lh   = float(lhd);
     coord_t lhs  = scaled(lhd);
-    auto && bb3d = mesh.bounding_box();
     double  minZ = bb3d.min(Z) - po.get_elevation();
     double  maxZ = bb3d.max(Z);
     auto    minZf = float(minZ);
     coord_t minZs = scaled(minZ);
     coord_t maxZs = scaled(maxZ);
     
-    po.m_slice_index.clear();
+    std::vector<SliceRecord> slice_index;
     
     size_t cap = size_t(1 + (maxZs - minZs - ilhs) / lhs);
-    po.m_slice_index.reserve(cap);
+    slice_index.reserve(cap);
     
-    po.m_slice_index.emplace_back(minZs + ilhs, minZf + ilh / 2.f, ilh);
+    slice_index.emplace_back(minZs + ilhs, minZf + ilh / 2.f, ilh);
     
     for(coord_t h = minZs + ilhs + lhs; h <= maxZs; h += lhs)
-        po.m_slice_index.emplace_back(h, unscaled<float>(h) - lh / 2.f, lh);
+        slice_index.emplace_back(h, unscaled<float>(h) - lh / 2.f, lh);
+    
+    return slice_index;
+}
+
+void SLAPrint::Steps::slice_model(SLAPrintObject &po)
+{   
+    const TriangleMesh &mesh = po.get_mesh_to_print();
+
+    // We need to prepare the slice index...
+    auto && bb3d = mesh.bounding_box();
+    po.m_slice_index = create_slice_index(po, bb3d);
     
     // Just get the first record that is from the model:
     auto slindex_it =
@@ -262,17 +307,26 @@ void SLAPrint::Steps::slice_model(SLAPrintObject &po)
     slicer.slice(slice_grid, SlicingMode::Regular, &po.m_model_slices, thr);
     
     if (po.m_hollowing_data && ! po.m_hollowing_data->interior.empty()) {
-        po.m_hollowing_data->interior.repair(true);
-        TriangleMeshSlicer interior_slicer(closing_r, 0);
-        interior_slicer.init(&po.m_hollowing_data->interior, thr);
         std::vector<ExPolygons> interior_slices;
-        interior_slicer.slice(slice_grid, SlicingMode::Regular, &interior_slices, thr);
+        if (po.m_hollowing_data->interior_slice_levels == slice_grid) {
+            // Reuse the slices contoured from the distance field of the
+            // interior by hollow_model().
+            interior_slices = po.m_hollowing_data->interior_slices;
+        } else {
+            po.m_hollowing_data->interior.repair(true);
+            TriangleMeshSlicer interior_slicer(closing_r, 0);
+            interior_slicer.init(&po.m_hollowing_data->interior, thr);
+            interior_slicer.slice(slice_grid, SlicingMode::Regular, &interior_slices, thr);
+            // The mesh slicer has already applied the closing radius.
+            closing_r = 0.f;
+        }
 
         sla::ccr::for_each(size_t(0), interior_slices.size(),
-                           [&po, &interior_slices] (size_t i) {
+                           [&po, &interior_slices, closing_r] (size_t i) {
                               const ExPolygons &slice = interior_slices[i];
                               po.m_model_slices[i] =
-                                  diff_ex(po.m_model_slices[i], slice);
+                                  diff_ex(po.m_model_slices[i], closing_r > 0.f ?
+                                      offset2_ex(slice, scale_(closing_r), - scale_(closing_r)) : slice);
                            });
     }
     
@@ -825,50 +879,44 @@ void SLAPrint::Steps::rasterize()
 {
     if(canceled() || !m_print->m_printer) return;
     
-    // coefficient to map the rasterization state (0-99) to the allocated
-    // portion (slot) of the process state
-    double sd = (100 - max_objstatus) / 100.0;
-    
-    // slot is the portion of 100% that is realted to rasterization
-    unsigned slot = PRINT_STEP_LEVELS[slapsRasterize];
+    // The layers are rasterized and encoded while the archive is exported,
+    // a window of layers at a time, so that the encoded layers of the whole
+    // print are never held in memory at once. The drawing function owns a
+    // copy of the slices, thus it stays valid even if the printer input is
+    // invalidated while the archive is being exported.
+    using LayerSlices = std::vector<std::vector<ClipperLib::Polygon>>;
+    auto layers = std::make_shared<LayerSlices>();
+    layers->reserve(m_print->m_printer_input.size());
     
     // pst: previous state
     double pst = current_status();
+    double increment = progressrange(slapsRasterize) / std::max(m_print->m_printer_input.size(), size_t(1));
+    double dstatus = pst;
     
-    double increment = (slot * sd) / m_print->m_printer_input.size();
-    double dstatus = current_status();
-    
-    sla::ccr::SpinningMutex slck;
-    using Lock = std::lock_guard<sla::ccr::SpinningMutex>;
+    for (const PrintLayer &printlayer : m_print->m_printer_input) {
+        if (canceled()) return;
+        
+        layers->emplace_back(printlayer.transformed_slices());
+        
+        dstatus += increment;
+        double st = std::round(dstatus);
+        if (st > pst) {
+            report_status(st, PRINT_STEP_LABELS(slapsRasterize));
+            pst = st;
+        }
+    }
     
     // procedure to process one height level. This will run in parallel
-    auto lvlfn =
-        [this, &slck, increment, &dstatus, &pst]
-        (sla::RasterBase& raster, size_t idx)
+    auto lvlfn = [layers] (sla::RasterBase& raster, size_t idx)
     {
-        PrintLayer& printlayer = m_print->m_printer_input[idx];
-        if(canceled()) return;
-        
-        for (const ClipperLib::Polygon& poly : printlayer.transformed_slices())
+        for (const ClipperLib::Polygon& poly : (*layers)[idx])
             raster.draw(poly);
-        
-        // Status indication guarded with the spinlock
-        {
-            Lock lck(slck);
-            dstatus += increment;
-            double st = std::round(dstatus);
-            if(st > pst) {
-                report_status(st, PRINT_STEP_LABELS(slapsRasterize));
-                pst = st;
-            }
-        }
     };
     
     // last minute escape
     if(canceled()) return;
     
-    // Print all the layers in parallel
-    m_print->m_printer->draw_layers(m_print->m_printer_input.size(), lvlfn);
+    m_print->m_printer->draw_layers(layers->size(), lvlfn);
 }
 
 std::string SLAPrint::Steps::label(SLAPrintObjectStep step)
@@ -888,7 +936,7 @@ double SLAPrint::Steps::progressrange(SLAPrintObjectStep step) const
 
 double SLAPrint::Steps::progressrange(SLAPrintStep step) const
 {
-    return PRINT_STEP_LEVELS[step] * (100 - max_objstatus) / 100.0;
+    return PRINT_STEP_LEVELS[step] * (SLAPrinter::min_export_status - max_objstatus) / 100.0;
 }
 
 void SLAPrint::Steps::execute(SLAPrintObjectStep step, SLAPrintObject &obj)
@@ -45,6 +45,9 @@ private:
     
     void apply_printer_corrections(SLAPrintObject &po, SliceOrigin o);
     
+    // The slice index of an object whose mesh has the bounding box bb3d.
+    std::vector<SliceRecord> create_slice_index(const SLAPrintObject &po, const BoundingBoxf3 &bb3d) const;
+    
 public:
     explicit Steps(SLAPrint *print);
     
@@ -188,13 +188,8 @@ std::optional<std::string> get_current_thread_name()
 #endif // _WIN32
 
 // Spawn (n - 1) worker threads on Intel TBB thread pool and name them by an index and a system thread ID.
-void name_tbb_thread_pool_threads()
+static void name_tbb_thread_pool_threads_once()
 {
-	static bool initialized = false;
-	if (initialized)
-		return;
-	initialized = true;
-
 	// see GH issue #5661 PrusaSlicer hangs on Linux when run with non standard task affinity
 	// TBB will respect the task affinity mask on Linux and spawn less threads than std::thread::hardware_concurrency().
 //	const size_t nthreads_hw = std::thread::hardware_concurrency();
@@ -241,4 +236,11 @@ void name_tbb_thread_pool_threads()
         });
 }
 
+// May be called concurrently, for example by the jobs of --batch and --server.
+void name_tbb_thread_pool_threads()
+{
+	static std::once_flag initialized;
+	std::call_once(initialized, name_tbb_thread_pool_threads_once);
+}
+
 }
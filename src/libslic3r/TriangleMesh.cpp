@@ -71,6 +71,22 @@ TriangleMesh::TriangleMesh(const Pointf3s &points, const std::vector<Vec3i32>& f
     stl_get_size(&stl);
 }
 
+static inline stl_facet facet_from_its(const indexed_triangle_set &its, size_t idx)
+{
+    stl_facet facet;
+    facet.vertex[0] = its.vertices[size_t(its.indices[idx](0))];
+    facet.vertex[1] = its.vertices[size_t(its.indices[idx](1))];
+    facet.vertex[2] = its.vertices[size_t(its.indices[idx](2))];
+    facet.extra[0] = 0;
+    facet.extra[1] = 0;
+
+    stl_normal normal;
+    stl_calculate_normal(normal, &facet);
+    stl_normalize_vector(normal);
+    facet.normal = normal;
+    return facet;
+}
+
 TriangleMesh::TriangleMesh(const indexed_triangle_set &M) : repaired(false)
 {
     stl.stats.type = inmemory;
@@ -80,21 +96,8 @@ TriangleMesh::TriangleMesh(const indexed_triangle_set &M) : repaired(false)
     stl.stats.original_num_facets = int(stl.stats.number_of_facets);
     stl_allocate(&stl);
     
-    for (uint32_t i = 0; i < stl.stats.number_of_facets; ++ i) {
-        stl_facet facet;
-        facet.vertex[0] = M.vertices[size_t(M.indices[i](0))];
-        facet.vertex[1] = M.vertices[size_t(M.indices[i](1))];
-        facet.vertex[2] = M.vertices[size_t(M.indices[i](2))];
-        facet.extra[0] = 0;
-        facet.extra[1] = 0;
-        
-        stl_normal normal;
-        stl_calculate_normal(normal, &facet);
-        stl_normalize_vector(normal);
-        facet.normal = normal;
-        
-        stl.facet_start[i] = facet;
-    }
+    for (uint32_t i = 0; i < stl.stats.number_of_facets; ++ i)
+        stl.facet_start[i] = facet_from_its(M, i);
     
     stl_get_size(&stl);
 }
@@ -103,6 +106,7 @@ TriangleMesh::TriangleMesh(const indexed_triangle_set &M) : repaired(false)
 
 void TriangleMesh::repair(bool update_shared_vertices)
 {
+    this->restore_facets();
     if (this->repaired) {
     	if (update_shared_vertices)
     		this->require_shared_vertices();
@@ -212,6 +216,7 @@ void TriangleMesh::repair(bool update_shared_vertices)
 
 float TriangleMesh::volume()
 {
+    this->restore_facets();
     if (this->stl.stats.volume == -1) 
         stl_calculate_volume(&this->stl);
     return this->stl.stats.volume;
@@ -219,6 +224,7 @@ float TriangleMesh::volume()
 
 void TriangleMesh::check_topology()
 {
+    this->restore_facets();
     // checking exact
     stl_check_facets_exact(&stl);
     stl.stats.facets_w_1_bad_edge = (stl.stats.connected_facets_2_edge - stl.stats.connected_facets_3_edge);
@@ -270,16 +276,47 @@ void TriangleMesh::WriteOBJFile(const char* output_file) const
     its_write_obj(this->its, output_file);
 }
 
+// Update the bounding box statistics of a mesh with released facets from its indexed triangle set, see stl_get_size().
+static void its_get_size(const indexed_triangle_set &its, stl_stats &stats)
+{
+    if (its.vertices.empty())
+        return;
+    stats.min = its.vertices.front();
+    stats.max = stats.min;
+    for (const stl_vertex &v : its.vertices) {
+        stats.min = stats.min.cwiseMin(v);
+        stats.max = stats.max.cwiseMax(v);
+    }
+    stats.size = stats.max - stats.min;
+    stats.bounding_diameter = stats.size.norm();
+}
+
+static void its_flip_triangles(indexed_triangle_set &its)
+{
+    for (stl_triangle_vertex_indices &face : its.indices)
+        std::swap(face(0), face(1));
+}
+
+// The transformations below only update the indexed triangle set and the statistics if the STL facets were released
+// by release_facets(), the facets are restored on demand by the methods needing the facet neighbors.
 void TriangleMesh::scale(float factor)
 {
-    stl_scale(&(this->stl), factor);
-	for (stl_vertex& v : this->its.vertices)
-		v *= factor;
+    this->scale(Vec3d(factor, factor, factor));
 }
 
 void TriangleMesh::scale(const Vec3d &versor)
 {
-    stl_scale_versor(&this->stl, versor.cast<float>());
+    if (this->has_facets())
+        stl_scale_versor(&this->stl, versor.cast<float>());
+    else {
+        // Same as stl_scale_versor().
+        auto s = versor.cast<float>().array();
+        this->stl.stats.min.array() *= s;
+        this->stl.stats.max.array() *= s;
+        this->stl.stats.size.array() *= s;
+        if (this->stl.stats.volume > 0.0)
+            this->stl.stats.volume *= s(0) * s(1) * s(2);
+    }
 	for (stl_vertex& v : this->its.vertices) {
 		v.x() *= versor.x();
 		v.y() *= versor.y();
@@ -291,8 +328,13 @@ void TriangleMesh::translate(float x, float y, float z)
 {
     if (x == 0.f && y == 0.f && z == 0.f)
         return;
-    stl_translate_relative(&(this->stl), x, y, z);
 	stl_vertex shift(x, y, z);
+    if (this->has_facets())
+        stl_translate_relative(&(this->stl), x, y, z);
+    else {
+        this->stl.stats.min += shift;
+        this->stl.stats.max += shift;
+    }
 	for (stl_vertex& v : this->its.vertices)
 		v += shift;
 }
@@ -310,16 +352,22 @@ void TriangleMesh::rotate(float angle, const Axis &axis)
     // admesh uses degrees
     angle = Slic3r::Geometry::rad2deg(angle);
     
+    const bool facets = this->has_facets();
     if (axis == X) {
-        stl_rotate_x(&this->stl, angle);
+        if (facets)
+            stl_rotate_x(&this->stl, angle);
         its_rotate_x(this->its, angle);
     } else if (axis == Y) {
-        stl_rotate_y(&this->stl, angle);
+        if (facets)
+            stl_rotate_y(&this->stl, angle);
         its_rotate_y(this->its, angle);
     } else if (axis == Z) {
-        stl_rotate_z(&this->stl, angle);
+        if (facets)
+            stl_rotate_z(&this->stl, angle);
         its_rotate_z(this->its, angle);
     }
+    if (! facets)
+        its_get_size(this->its, this->stl.stats);
 }
 
 void TriangleMesh::rotate(float angle, const Vec3d& axis)
@@ -330,29 +378,46 @@ void TriangleMesh::rotate(float angle, const Vec3d& axis)
     Vec3d axis_norm = axis.normalized();
     Transform3d m = Transform3d::Identity();
     m.rotate(Eigen::AngleAxisd(angle, axis_norm));
-    stl_transform(&stl, m);
-    its_transform(its, m);
+    this->transform(m);
 }
 
 void TriangleMesh::mirror(const Axis &axis)
 {
+    const bool facets = this->has_facets();
     if (axis == X) {
-        stl_mirror_yz(&this->stl);
+        if (facets)
+            stl_mirror_yz(&this->stl);
         for (stl_vertex &v : this->its.vertices)
       		v(0) *= -1.0;
     } else if (axis == Y) {
-        stl_mirror_xz(&this->stl);
+        if (facets)
+            stl_mirror_xz(&this->stl);
         for (stl_vertex &v : this->its.vertices)
       		v(1) *= -1.0;
     } else if (axis == Z) {
-        stl_mirror_xy(&this->stl);
+        if (facets)
+            stl_mirror_xy(&this->stl);
         for (stl_vertex &v : this->its.vertices)
       		v(2) *= -1.0;
+    } else
+        return;
+    // stl_mirror_xx() reverses the facets, keep the indexed triangle set oriented the same way.
+    its_flip_triangles(this->its);
+    if (! facets) {
+        int i = int(axis);
+        std::swap(this->stl.stats.min(i), this->stl.stats.max(i));
+        this->stl.stats.min(i) *= -1.f;
+        this->stl.stats.max(i) *= -1.f;
     }
 }
 
 void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
 {
+    if (! this->has_facets()) {
+        its_transform(its, t, fix_left_handed);
+        its_get_size(this->its, this->stl.stats);
+        return;
+    }
     stl_transform(&stl, t);
     its_transform(its, t);
 	if (fix_left_handed && t.matrix().block(0, 0, 3, 3).determinant() < 0.) {
@@ -366,6 +431,11 @@ void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
 
 void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
 {
+    if (! this->has_facets()) {
+        its_transform(its, m, fix_left_handed);
+        its_get_size(this->its, this->stl.stats);
+        return;
+    }
     stl_transform(&stl, m);
     its_transform(its, m);
     if (fix_left_handed && m.determinant() < 0.) {
@@ -391,8 +461,12 @@ void TriangleMesh::rotate(double angle, Point* center)
         return;
     Vec2f c = center->cast<float>();
     this->translate(-c(0), -c(1), 0);
-    stl_rotate_z(&this->stl, (float)angle);
+    const bool facets = this->has_facets();
+    if (facets)
+        stl_rotate_z(&this->stl, (float)angle);
     its_rotate_z(this->its, (float)angle);
+    if (! facets)
+        its_get_size(this->its, this->stl.stats);
     this->translate(c(0), c(1), 0);
 }
 
@@ -401,6 +475,11 @@ void TriangleMesh::rotate(double angle, Point* center)
  */
 bool TriangleMesh::is_splittable() const
 {
+    if (! this->has_facets()) {
+        TriangleMesh mesh(*this);
+        mesh.restore_facets();
+        return mesh.is_splittable();
+    }
     std::vector<unsigned char> visited;
     find_unvisited_neighbors(visited);
 
@@ -460,6 +539,11 @@ std::deque<uint32_t> TriangleMesh::find_unvisited_neighbors(std::vector<unsigned
  */
 TriangleMeshPtrs TriangleMesh::split() const
 {
+    if (! this->has_facets()) {
+        TriangleMesh mesh(*this);
+        mesh.restore_facets();
+        return mesh.split();
+    }
     // Loop while we have remaining facets.
     std::vector<unsigned char> facet_visited;
     TriangleMeshPtrs meshes;
@@ -489,6 +573,7 @@ TriangleMeshPtrs TriangleMesh::split() const
 
 void TriangleMesh::merge(const TriangleMesh &mesh)
 {
+    this->restore_facets();
     // reset stats and metadata
     int number_of_facets = this->stl.stats.number_of_facets;
     this->its.clear();
@@ -501,7 +586,7 @@ void TriangleMesh::merge(const TriangleMesh &mesh)
     
     // copy facets
     for (uint32_t i = 0; i < mesh.stl.stats.number_of_facets; ++ i)
-        this->stl.facet_start[number_of_facets + i] = mesh.stl.facet_start[i];
+        this->stl.facet_start[number_of_facets + i] = mesh.facet(i);
     
     // update size
     stl_get_size(&this->stl);
@@ -513,7 +598,8 @@ ExPolygons TriangleMesh::horizontal_projection() const
 {
     Polygons pp;
     pp.reserve(this->stl.stats.number_of_facets);
-	for (const stl_facet &facet : this->stl.facet_start) {
+	for (size_t i = 0; i < this->stl.stats.number_of_facets; ++ i) {
+        const stl_facet facet = this->facet(i);
         Polygon p;
         p.points.resize(3);
         p.points[0] = Point::new_scale(facet.vertex[0](0), facet.vertex[0](1));
@@ -584,12 +670,20 @@ TriangleMesh TriangleMesh::convex_hull_3d() const
 	        qhull.runQhull("", 3, (int)src_vertices.size() / 3, src_vertices.data(), "Qt");
 #endif
 	    } else {
-	    	src_vertices.reserve(this->stl.facet_start.size() * 9);
-	    	// We will now fill the vector with input points for computation:
+	    	// Each vertex is shared by about six facets, feed qhull with the unique vertices only.
+	    	std::vector<stl_vertex> vertices;
+	    	vertices.reserve(this->stl.facet_start.size() * 3);
 			for (const stl_facet &f : this->stl.facet_start)
 				for (int i = 0; i < 3; ++ i)
-					for (int j = 0; j < 3; ++ j)
-		        		src_vertices.emplace_back(f.vertex[i](j));
+					vertices.emplace_back(f.vertex[i]);
+			std::sort(vertices.begin(), vertices.end(), [](const stl_vertex &l, const stl_vertex &r) {
+				return l.x() < r.x() || (l.x() == r.x() && (l.y() < r.y() || (l.y() == r.y() && l.z() < r.z()))); });
+			vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+	    	src_vertices.reserve(vertices.size() * 3);
+	    	// We will now fill the vector with input points for computation:
+			for (const stl_vertex &v : vertices)
+				for (int i = 0; i < 3; ++ i)
+		        	src_vertices.emplace_back(v(i));
 	        qhull.runQhull("", 3, (int)src_vertices.size() / 3, src_vertices.data(), "Qt");
 	    }
     }
@@ -635,6 +729,9 @@ std::vector<ExPolygons> TriangleMesh::slice(const std::vector<double> &z)
 
 void TriangleMesh::require_shared_vertices()
 {
+    if (this->has_shared_vertices() && ! this->has_facets())
+        // Only the indexed triangle set is kept, see release_facets().
+        return;
     BOOST_LOG_TRIVIAL(trace) << "TriangleMeshSlicer::require_shared_vertices - start";
     assert(stl_validate(&this->stl));
     if (!this->repaired) 
@@ -656,9 +753,11 @@ size_t TriangleMesh::memsize() const
 // Release optional data from the mesh if the object is on the Undo / Redo stack only. Returns the amount of memory released.
 size_t TriangleMesh::release_optional()
 {
-	size_t memsize_released = sizeof(stl_neighbors) * this->stl.neighbors_start.size() + this->its.memsize();
-	// The indexed triangle set may be recalculated using the stl_generate_shared_vertices() function.
-	this->its.clear();
+	if (this->has_shared_vertices())
+		// The indexed triangle set is much more compact than the STL facets (roughly 18 bytes per face instead of 50 bytes
+		// per face plus the neighbors), keep just the indexed triangle set.
+		return this->release_facets();
+	size_t memsize_released = sizeof(stl_neighbors) * this->stl.neighbors_start.size();
 	// The neighbors structure may be recalculated using the stl_check_facets_exact() function.
 	this->stl.neighbors_start.clear();
 	return memsize_released;
@@ -667,6 +766,7 @@ size_t TriangleMesh::release_optional()
 // Restore optional data possibly released by release_optional().
 void TriangleMesh::restore_optional()
 {
+	this->restore_facets();
 	if (! this->stl.facet_start.empty()) {
 		// Save the old stats before calling stl_check_faces_exact, as it may modify the statistics.
 		stl_stats stats = this->stl.stats;
@@ -681,6 +781,37 @@ void TriangleMesh::restore_optional()
 	}
 }
 
+size_t TriangleMesh::release_facets()
+{
+	if (! this->has_shared_vertices() || this->stl.facet_start.empty())
+		return 0;
+	size_t memsize_released = sizeof(stl_facet) * this->stl.facet_start.capacity() + sizeof(stl_neighbors) * this->stl.neighbors_start.capacity();
+	// Both may be recalculated from the indexed triangle set by restore_facets().
+	std::vector<stl_facet>().swap(this->stl.facet_start);
+	std::vector<stl_neighbors>().swap(this->stl.neighbors_start);
+	return memsize_released;
+}
+
+void TriangleMesh::restore_facets()
+{
+	if (this->has_facets())
+		return;
+	assert(this->its.indices.size() == this->stl.stats.number_of_facets);
+	// Save the old stats before calling stl_check_faces_exact, as it may modify the statistics.
+	stl_stats stats = this->stl.stats;
+	this->stl.facet_start.resize(this->stl.stats.number_of_facets);
+	for (size_t i = 0; i < this->stl.facet_start.size(); ++ i)
+		this->stl.facet_start[i] = facet_from_its(this->its, i);
+	this->stl.neighbors_start.assign(this->stl.stats.number_of_facets, stl_neighbors());
+	stl_check_facets_exact(&this->stl);
+	this->stl.stats = stats;
+}
+
+stl_facet TriangleMesh::facet(size_t idx) const
+{
+	return this->has_facets() ? this->stl.facet_start[idx] : facet_from_its(this->its, idx);
+}
+
 void TriangleMeshSlicer::init(const TriangleMesh *_mesh, throw_on_cancel_callback_type throw_on_cancel)
 {
     mesh = _mesh;
@@ -909,7 +1040,7 @@ void TriangleMeshSlicer::slice(
 void TriangleMeshSlicer::_slice_do(size_t facet_idx, std::vector<IntersectionLines>* lines, boost::mutex* lines_mutex, 
     const std::vector<float> &z) const
 {
-    const stl_facet &facet = m_use_quaternion ? (this->mesh->stl.facet_start.data() + facet_idx)->rotated(m_quaternion) : *(this->mesh->stl.facet_start.data() + facet_idx);
+    const stl_facet facet = m_use_quaternion ? this->mesh->facet(facet_idx).rotated(m_quaternion) : this->mesh->facet(facet_idx);
     
     // find facet extents
     const float min_z = fminf(facet.vertex[0](2), fminf(facet.vertex[1](2), facet.vertex[2](2)));
@@ -1824,7 +1955,8 @@ void TriangleMeshSlicer::cut(float z, TriangleMesh* upper, TriangleMesh* lower)
     BOOST_LOG_TRIVIAL(trace) << "TriangleMeshSlicer::cut - slicing object";
     float scaled_z = scale_(z);
     for (uint32_t facet_idx = 0; facet_idx < this->mesh->stl.stats.number_of_facets; ++ facet_idx) {
-        const stl_facet* facet = &this->mesh->stl.facet_start[facet_idx];
+        const stl_facet  facet_data = this->mesh->facet(facet_idx);
+        const stl_facet* facet = &facet_data;
         
         // find facet extents
         float min_z = std::min(facet->vertex[0](2), std::min(facet->vertex[1](2), facet->vertex[2](2)));
@@ -26,8 +26,8 @@ public:
     explicit TriangleMesh(const indexed_triangle_set &M);
 	void clear() { this->stl.clear(); this->its.clear(); this->repaired = false; }
     bool ReadSTLFile(const char* input_file) { return stl_open(&stl, input_file); }
-    bool write_ascii(const char* output_file) { return stl_write_ascii(&this->stl, output_file, ""); }
-    bool write_binary(const char* output_file) { return stl_write_binary(&this->stl, output_file, ""); }
+    bool write_ascii(const char* output_file) { this->restore_facets(); return stl_write_ascii(&this->stl, output_file, ""); }
+    bool write_binary(const char* output_file) { this->restore_facets(); return stl_write_binary(&this->stl, output_file, ""); }
     void repair(bool update_shared_vertices = true);
     float volume();
     void check_topology();
@@ -54,6 +54,8 @@ public:
     void merge(const TriangleMesh &mesh);
     ExPolygons horizontal_projection() const;
     const float* first_vertex() const { return this->stl.facet_start.empty() ? nullptr : &this->stl.facet_start.front().vertex[0](0); }
+    // Return a facet by its index. If only the indexed triangle set is stored, the facet is derived from it.
+    stl_facet facet(size_t idx) const;
     // 2D convex hull of a 3D mesh projected into the Z=0 plane.
     Polygon convex_hull();
     BoundingBoxf3 bounding_box() const;
@@ -80,6 +82,12 @@ public:
     size_t release_optional();
 	// Restore optional data possibly released by release_optional().
 	void restore_optional();
+    // Keep the indexed triangle set as the only representation of the mesh, release the STL facets and their neighbors.
+    // The statistics are retained and updated by the transformations. Returns the amount of memory released.
+    size_t release_facets();
+    // Rebuild the STL facets and their neighbors from the indexed triangle set, if they were released by release_facets().
+    void   restore_facets();
+    bool   has_facets() const { return this->stl.facet_start.size() == this->stl.stats.number_of_facets; }
 
     stl_file stl;
     indexed_triangle_set its;
@@ -273,7 +281,15 @@ namespace cereal {
 	template<class Archive> void save(Archive &archive, const Slic3r::TriangleMesh &mesh) {
 		const stl_file& stl = mesh.stl;
 		archive(stl.stats.number_of_facets, stl.stats.original_num_facets);
-		archive.saveBinary((char*)stl.facet_start.data(), stl.facet_start.size() * 50);
+		if (mesh.has_facets())
+			archive.saveBinary((char*)stl.facet_start.data(), stl.facet_start.size() * 50);
+		else {
+			// Only the indexed triangle set is stored, derive the facets from it.
+			for (size_t i = 0; i < stl.stats.number_of_facets; ++ i) {
+				stl_facet facet = mesh.facet(i);
+				archive.saveBinary((char*)&facet, 50);
+			}
+		}
 	}
 }
 
@@ -53,6 +53,7 @@ void TriangleSelector::select_patch(const Vec3f& hit, int facet_start,
     }
 
     // Now start with the facet the pointer points to and check all adjacent facets.
+    const std::vector<stl_neighbors> &neighbors = this->mesh_neighbors();
     std::vector<int> facets_to_check{facet_start};
     std::vector<bool> visited(m_orig_size_indices, false); // keep track of facets we already processed
     int facet_idx = 0; // index into facets_to_check
@@ -62,7 +63,7 @@ void TriangleSelector::select_patch(const Vec3f& hit, int facet_start,
             if (select_triangle(facet, new_state)) {
                 // add neighboring facets to list to be proccessed later
                 for (int n=0; n<3; ++n) {
-                    int neighbor_idx = m_mesh->stl.neighbors_start[facet].neighbor[n];
+                    int neighbor_idx = neighbors[facet].neighbor[n];
                     if (neighbor_idx >=0 && (m_cursor.type == SPHERE || faces_camera(neighbor_idx)))
                         facets_to_check.push_back(neighbor_idx);
                 }
@@ -235,8 +236,8 @@ bool TriangleSelector::is_pointer_in_triangle(int facet_idx) const
 bool TriangleSelector::faces_camera(int facet) const
 {
     assert(facet < m_orig_size_indices);
-    // The normal is cached in mesh->stl, use it.
-    Vec3f normal = m_mesh->stl.facet_start[facet].normal;
+    // The normal is cached in mesh->stl, use it. If only the indexed triangle set is kept, it is calculated.
+    Vec3f normal = m_mesh->facet(facet).normal;
 
     if (! m_cursor.uniform_scaling) {
         // Transform the normal into world coords.
@@ -416,6 +417,19 @@ TriangleSelector::TriangleSelector(const TriangleMesh& mesh)
     reset();
 }
 
+const std::vector<stl_neighbors>& TriangleSelector::mesh_neighbors()
+{
+    if (m_mesh->has_facets())
+        return m_mesh->stl.neighbors_start;
+    if (m_neighbors.empty()) {
+        // The mesh keeps just the indexed triangle set, calculate the neighbors once on a copy with the facets restored.
+        TriangleMesh mesh(*m_mesh);
+        mesh.restore_facets();
+        m_neighbors = std::move(mesh.stl.neighbors_start);
+    }
+    return m_neighbors;
+}
+
 
 void TriangleSelector::reset()
 {
@@ -116,6 +116,8 @@ protected:
     std::vector<Vertex> m_vertices;
     std::vector<Triangle> m_triangles;
     const TriangleMesh* m_mesh;
+    // Neighbors of the mesh facets, if the mesh does not keep its STL facets. See mesh_neighbors().
+    std::vector<stl_neighbors> m_neighbors;
 
     // Number of invalid triangles (to trigger garbage collection).
     int m_invalid_triangles;
@@ -153,6 +155,7 @@ protected:
                          bool recursive_call = false);
     int  vertices_inside(int facet_idx) const;
     bool faces_camera(int facet) const;
+    const std::vector<stl_neighbors>& mesh_neighbors();
     void undivide_triangle(int facet_idx);
     void split_triangle(int facet_idx);
     void remove_useless_children(int facet_idx); // No hidden meaning. Triangles are meant.
@@ -160,7 +160,7 @@ void GLIndexedVertexArray::load_mesh_full_shading(const TriangleMesh& mesh)
 
     unsigned int vertices_count = 0;
     for (int i = 0; i < (int)mesh.stl.stats.number_of_facets; ++i) {
-            const stl_facet& facet = mesh.stl.facet_start[i];
+            const stl_facet facet = mesh.facet(i);
         for (int j = 0; j < 3; ++j)
             this->push_geometry(facet.vertex[j](0), facet.vertex[j](1), facet.vertex[j](2), facet.normal(0), facet.normal(1), facet.normal(2));
 
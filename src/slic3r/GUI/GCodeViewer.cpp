@@ -29,6 +29,8 @@
 #include <wx/progdlg.h>
 #include <wx/numformatter.h>
 
+#include <tbb/parallel_for.h>
+
 #include <array>
 #include <algorithm>
 #include <chrono>
@@ -84,7 +86,7 @@ static float round_to_nearest(float value, unsigned int decimals)
 }
 
 #if ENABLE_SPLITTED_VERTEX_BUFFER
-void GCodeViewer::VBuffer::reset()
+void GCodeToolpaths::VBuffer::reset()
 {
     // release gpu memory
     if (!vbos.empty()) {
@@ -92,10 +94,105 @@ void GCodeViewer::VBuffer::reset()
         vbos.clear();
     }
     sizes.clear();
+    quantizations.clear();
     count = 0;
 }
+
+std::vector<unsigned char> GCodeToolpaths::VBuffer::quantize(const std::vector<float>& vertices, size_t vbo_id)
+{
+    assert(quantized && format == EFormat::PositionNormal3);
+    if (quantizations.size() <= vbo_id)
+        quantizations.resize(vbo_id + 1, { 0.0f, 0.0f, 0.0f, 1.0f });
+
+    const size_t floats_per_vertex = vertex_size_floats();
+    const size_t vertices_count = vertices.size() / floats_per_vertex;
+
+    // the positions are quantized in a cube centered into the bounding box of the vertices
+    Vec3f min = Vec3f::Constant(FLT_MAX);
+    Vec3f max = Vec3f::Constant(-FLT_MAX);
+    for (size_t i = 0; i < vertices_count; ++i) {
+        const Vec3f position(vertices.data() + i * floats_per_vertex);
+        min = min.cwiseMin(position);
+        max = max.cwiseMax(position);
+    }
+    const Vec3f origin = (vertices_count > 0) ? Vec3f(0.5f * (min + max)) : Vec3f::Zero();
+    const float half_size = (vertices_count > 0) ? 0.5f * (max - min).maxCoeff() : 0.0f;
+    const float step = (half_size > 0.0f) ? half_size / 32767.0f : 1.0f;
+    quantizations[vbo_id] = { origin.x(), origin.y(), origin.z(), step };
+
+    std::vector<unsigned char> ret(vertices_count * gpu_vertex_size_bytes());
+    unsigned char* dst = ret.data();
+    for (size_t i = 0; i < vertices_count; ++i) {
+        const float* src = vertices.data() + i * floats_per_vertex;
+        std::array<short, 4> position = { 0, 0, 0, 0 };
+        std::array<signed char, 4> normal = { 0, 0, 0, 0 };
+        for (size_t j = 0; j < 3; ++j) {
+            position[j] = static_cast<short>(std::clamp<long>(std::lround((src[j] - origin[j]) / step), -32767, 32767));
+            normal[j] = static_cast<signed char>(std::clamp<long>(std::lround(src[3 + j] * 127.0f), -127, 127));
+        }
+        ::memcpy(dst, position.data(), sizeof(position));
+        ::memcpy(dst + sizeof(position), normal.data(), sizeof(normal));
+        dst += gpu_vertex_size_bytes();
+    }
+    return ret;
+}
+
+void GCodeToolpaths::VBuffer::enable_arrays(unsigned int vbo) const
+{
+    if (quantized) {
+        const size_t vbo_id = std::find(vbos.begin(), vbos.end(), vbo) - vbos.begin();
+        const std::array<float, 4>& quantization = quantizations[vbo_id];
+        glsafe(::glMatrixMode(GL_MODELVIEW));
+        glsafe(::glPushMatrix());
+        glsafe(::glTranslatef(quantization[0], quantization[1], quantization[2]));
+        glsafe(::glScalef(quantization[3], quantization[3], quantization[3]));
+        glsafe(::glVertexPointer(3, GL_SHORT, gpu_vertex_size_bytes(), (const void*)0));
+        glsafe(::glEnableClientState(GL_VERTEX_ARRAY));
+        // normalized by opengl
+        glsafe(::glNormalPointer(GL_BYTE, gpu_vertex_size_bytes(), (const void*)(4 * sizeof(short))));
+        glsafe(::glEnableClientState(GL_NORMAL_ARRAY));
+        return;
+    }
+
+    glsafe(::glVertexPointer(position_size_floats(), GL_FLOAT, vertex_size_bytes(), (const void*)position_offset_size()));
+    glsafe(::glEnableClientState(GL_VERTEX_ARRAY));
+    if (normal_size_floats() > 0) {
+        glsafe(::glNormalPointer(GL_FLOAT, vertex_size_bytes(), (const void*)normal_offset_size()));
+        glsafe(::glEnableClientState(GL_NORMAL_ARRAY));
+    }
+}
+
+void GCodeToolpaths::VBuffer::disable_arrays(unsigned int vbo) const
+{
+    if (quantized || normal_size_floats() > 0)
+        glsafe(::glDisableClientState(GL_NORMAL_ARRAY));
+    glsafe(::glDisableClientState(GL_VERTEX_ARRAY));
+    if (quantized) {
+        glsafe(::glMatrixMode(GL_MODELVIEW));
+        glsafe(::glPopMatrix());
+    }
+}
+
+Vec3f GCodeToolpaths::VBuffer::get_position(unsigned int vbo, size_t index) const
+{
+    Vec3f ret = Vec3f::Zero();
+    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, vbo));
+    if (quantized) {
+        const size_t vbo_id = std::find(vbos.begin(), vbos.end(), vbo) - vbos.begin();
+        const std::array<float, 4>& quantization = quantizations[vbo_id];
+        std::array<short, 3> position = { 0, 0, 0 };
+        glsafe(::glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(index * gpu_vertex_size_bytes()), static_cast<GLsizeiptr>(sizeof(position)), static_cast<void*>(position.data())));
+        for (size_t j = 0; j < 3; ++j) {
+            ret[j] = quantization[j] + quantization[3] * static_cast<float>(position[j]);
+        }
+    }
+    else
+        glsafe(::glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(index * vertex_size_bytes()), static_cast<GLsizeiptr>(3 * sizeof(float)), static_cast<void*>(ret.data())));
+    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+    return ret;
+}
 #else
-void GCodeViewer::VBuffer::reset()
+void GCodeToolpaths::VBuffer::reset()
 {
     // release gpu memory
     if (id > 0) {
@@ -107,7 +204,7 @@ void GCodeViewer::VBuffer::reset()
 }
 #endif // ENABLE_SPLITTED_VERTEX_BUFFER
 
-void GCodeViewer::IBuffer::reset()
+void GCodeToolpaths::IBuffer::reset()
 {
 #if ENABLE_SPLITTED_VERTEX_BUFFER
     // release gpu memory
@@ -129,7 +226,7 @@ void GCodeViewer::IBuffer::reset()
     count = 0;
 }
 
-bool GCodeViewer::Path::matches(const GCodeProcessor::MoveVertex& move) const
+bool GCodeToolpaths::Path::matches(const GCodeProcessor::MoveVertex& move) const
 {
 #if ENABLE_TOOLPATHS_WIDTH_HEIGHT_FROM_GCODE
     auto matches_percent = [](float value1, float value2, float max_percent) {
@@ -184,7 +281,7 @@ bool GCodeViewer::Path::matches(const GCodeProcessor::MoveVertex& move) const
     }
 }
 
-void GCodeViewer::TBuffer::reset()
+void GCodeToolpaths::TBuffer::reset()
 {
     // release gpu memory
     vertices.reset();
@@ -198,7 +295,7 @@ void GCodeViewer::TBuffer::reset()
     render_paths.clear();
 }
 
-void GCodeViewer::TBuffer::add_path(const GCodeProcessor::MoveVertex& move, unsigned int b_id, size_t i_id, size_t s_id)
+void GCodeToolpaths::TBuffer::add_path(const GCodeProcessor::MoveVertex& move, unsigned int b_id, size_t i_id, size_t s_id)
 {
     Path::Endpoint endpoint = { b_id, i_id, s_id, move.position };
     // use rounding to reduce the number of generated paths
@@ -438,8 +535,16 @@ GCodeViewer::GCodeViewer()
 
     // initializes non OpenGL data of TBuffers
     // OpenGL data are initialized into render().init_gl_data()
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        TBuffer& buffer = m_buffers[i];
+    GCodeToolpaths::init_buffers(m_buffers);
+
+    set_toolpath_move_type_visible(EMoveType::Extrude, true);
+//    m_sequential_view.skip_invisible_moves = true;
+}
+
+void GCodeToolpaths::init_buffers(std::vector<TBuffer>& buffers)
+{
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        TBuffer& buffer = buffers[i];
         switch (buffer_type(i))
         {
         default: { break; }
@@ -466,9 +571,6 @@ GCodeViewer::GCodeViewer()
         }
         }
     }
-
-    set_toolpath_move_type_visible(EMoveType::Extrude, true);
-//    m_sequential_view.skip_invisible_moves = true;
 }
 
 void GCodeViewer::load(const GCodeProcessor::Result& gcode_result, const Print& print, bool initialized)
@@ -924,16 +1026,33 @@ void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
 
     // get vertices/normals data from vertex buffers on gpu
     for (size_t i = 0; i < t_buffer.vertices.vbos.size(); ++i) {
-        const size_t floats_count = t_buffer.vertices.sizes[i] / sizeof(float);
-        VertexBuffer vertices(floats_count);
-        glsafe(::glBindBuffer(GL_ARRAY_BUFFER, t_buffer.vertices.vbos[i]));
-        glsafe(::glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(t_buffer.vertices.sizes[i]), static_cast<void*>(vertices.data())));
-        glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
-        const size_t vertices_count = floats_count / floats_per_vertex;
-        for (size_t j = 0; j < vertices_count; ++j) {
-            const size_t base = j * floats_per_vertex;
-            out_vertices.push_back({ vertices[base + 0], vertices[base + 1], vertices[base + 2] });
-            out_normals.push_back({ vertices[base + 3], vertices[base + 4], vertices[base + 5] });
+        const size_t vertices_count = t_buffer.vertices.sizes[i] / t_buffer.vertices.gpu_vertex_size_bytes();
+        if (t_buffer.vertices.quantized) {
+            std::vector<unsigned char> vertices(t_buffer.vertices.sizes[i]);
+            glsafe(::glBindBuffer(GL_ARRAY_BUFFER, t_buffer.vertices.vbos[i]));
+            glsafe(::glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(t_buffer.vertices.sizes[i]), static_cast<void*>(vertices.data())));
+            glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+            const std::array<float, 4>& quantization = t_buffer.vertices.quantizations[i];
+            for (size_t j = 0; j < vertices_count; ++j) {
+                std::array<short, 4> position;
+                std::array<signed char, 4> normal;
+                ::memcpy(position.data(), vertices.data() + j * t_buffer.vertices.gpu_vertex_size_bytes(), sizeof(position));
+                ::memcpy(normal.data(), vertices.data() + j * t_buffer.vertices.gpu_vertex_size_bytes() + sizeof(position), sizeof(normal));
+                out_vertices.push_back(Vec3f(quantization[0], quantization[1], quantization[2]) + quantization[3] * Vec3f(position[0], position[1], position[2]));
+                out_normals.push_back(Vec3f(normal[0], normal[1], normal[2]).normalized());
+            }
+        }
+        else {
+            const size_t floats_count = t_buffer.vertices.sizes[i] / sizeof(float);
+            VertexBuffer vertices(floats_count);
+            glsafe(::glBindBuffer(GL_ARRAY_BUFFER, t_buffer.vertices.vbos[i]));
+            glsafe(::glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(t_buffer.vertices.sizes[i]), static_cast<void*>(vertices.data())));
+            glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+            for (size_t j = 0; j < vertices_count; ++j) {
+                const size_t base = j * floats_per_vertex;
+                out_vertices.push_back({ vertices[base + 0], vertices[base + 1], vertices[base + 2] });
+                out_normals.push_back({ vertices[base + 3], vertices[base + 4], vertices[base + 5] });
+            }
         }
 
         if (i < t_buffer.vertices.vbos.size() - 1)
@@ -1241,33 +1360,348 @@ void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
 }
 
 #if ENABLE_SPLITTED_VERTEX_BUFFER
-void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
+void GCodeToolpaths::generate_vertices(const GCodeProcessor::Result& gcode_result, std::vector<TBuffer>& buffers,
+    std::vector<MultiVertexBuffer>& vertices, std::vector<float>& options_zs)
 {
-    // max index buffer size, in bytes
-    static const size_t IBUFFER_THRESHOLD_BYTES = 64 * 1024 * 1024;
+    const std::vector<GCodeProcessor::MoveVertex>& moves = gcode_result.moves;
+    const size_t moves_count = moves.size();
 
-    auto log_memory_usage = [this](const std::string& label, const std::vector<MultiVertexBuffer>& vertices, const std::vector<MultiIndexBuffer>& indices) {
-        int64_t vertices_size = 0;
-        for (const MultiVertexBuffer& buffers : vertices) {
-            for (const VertexBuffer& buffer : buffers) {
-                vertices_size += SLIC3R_STDVEC_MEMSIZE(buffer, float);
+    // where the vertices of a move are stored into the vertex buffers
+    struct VertexSlot
+    {
+        // index of the vertex buffer in the multibuffer vector
+        unsigned int vbuffer_id{ 0 };
+        // offset into the vertex buffer, in floats
+        unsigned int offset{ 0 };
+        // index of the path in TBuffer::paths (solid toolpaths only)
+        unsigned int path_id{ 0 };
+        unsigned char tbuffer_id{ 0 };
+        // whether all the 8 vertices of the segment are stored (solid toolpaths only)
+        bool full_segment{ false };
+    };
+    std::vector<VertexSlot> slots(moves_count);
+    // sizes of the vertex buffers, in floats
+    std::vector<std::vector<size_t>> sizes(buffers.size());
+
+    // 1st pass: sequential, it lays out the paths and the vertex buffers without generating any vertex,
+    // the size of the vertices of a segment is known in advance
+    for (size_t i = 1; i < moves_count; ++i) {
+        const GCodeProcessor::MoveVertex& curr = moves[i];
+        const GCodeProcessor::MoveVertex& prev = moves[i - 1];
+
+        unsigned char id = buffer_id(curr.type);
+        TBuffer& t_buffer = buffers[id];
+        std::vector<size_t>& v_sizes = sizes[id];
+
+        // ensure there is at least one vertex buffer
+        if (v_sizes.empty())
+            v_sizes.push_back(0);
+
+        // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
+        // add another vertex buffer
+        if (v_sizes.back() * sizeof(float) > t_buffer.vertices.max_size_bytes() - t_buffer.max_vertices_per_segment_size_bytes()) {
+            v_sizes.push_back(0);
+            if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
+                Path& last_path = t_buffer.paths.back();
+                if (prev.type == curr.type && last_path.matches(curr))
+                    last_path.add_sub_path(prev, static_cast<unsigned int>(v_sizes.size()) - 1, 0, i - 1);
             }
         }
-        int64_t indices_size = 0;
-        for (const MultiIndexBuffer& buffers : indices) {
-            for (const IndexBuffer& buffer : buffers) {
-                indices_size += SLIC3R_STDVEC_MEMSIZE(buffer, IBufferType);
+
+        VertexSlot& slot = slots[i];
+        slot.tbuffer_id = id;
+        slot.vbuffer_id = static_cast<unsigned int>(v_sizes.size()) - 1;
+        slot.offset = static_cast<unsigned int>(v_sizes.back());
+        size_t& v_size = v_sizes.back();
+
+        if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
+            if (prev.type != curr.type || !t_buffer.paths.back().matches(curr)) {
+                t_buffer.add_path(curr, slot.vbuffer_id, v_size, i - 1);
+                t_buffer.paths.back().sub_paths.back().first.position = prev.position;
             }
+
+            Path& last_path = t_buffer.paths.back();
+            slot.path_id = static_cast<unsigned int>(t_buffer.paths.size()) - 1;
+            // 1st segment or restart into a new vertex buffer
+            slot.full_segment = last_path.vertices_count() == 1 || v_size == 0;
+            v_size += (slot.full_segment ? 8 : 6) * t_buffer.vertices.vertex_size_floats();
+            last_path.sub_paths.back().last = { slot.vbuffer_id, v_size, i, curr.position };
         }
-        log_memory_used(label, vertices_size + indices_size);
+        else
+            v_size += t_buffer.max_vertices_per_segment_size_floats();
+
+        // collect options zs for later use
+        if (curr.type == EMoveType::Pause_Print || curr.type == EMoveType::Custom_GCode) {
+            const float* const last_z = options_zs.empty() ? nullptr : &options_zs.back();
+            if (last_z == nullptr || curr.position[2] < *last_z - EPSILON || *last_z + EPSILON < curr.position[2])
+                options_zs.emplace_back(curr.position[2]);
+        }
+    }
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        vertices[i].resize(sizes[i].size());
+        for (size_t j = 0; j < sizes[i].size(); ++j) {
+            vertices[i][j].resize(sizes[i][j]);
+        }
+    }
+
+    // 2nd pass: parallel, each segment writes its vertices into its own slot
+    tbb::parallel_for(tbb::blocked_range<size_t>(1, std::max<size_t>(1, moves_count)), [&moves, &slots, &buffers, &vertices](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const GCodeProcessor::MoveVertex& curr = moves[i];
+            const GCodeProcessor::MoveVertex& prev = moves[i - 1];
+            const VertexSlot& slot = slots[i];
+            const TBuffer& t_buffer = buffers[slot.tbuffer_id];
+            float* dst = vertices[slot.tbuffer_id][slot.vbuffer_id].data() + slot.offset;
+
+            switch (t_buffer.render_primitive_type)
+            {
+            case TBuffer::ERenderPrimitiveType::Point: {
+                // format data into the buffers to be rendered as points
+                *dst++ = curr.position[0];
+                *dst++ = curr.position[1];
+                *dst++ = curr.position[2];
+                break;
+            }
+            case TBuffer::ERenderPrimitiveType::Line: {
+                // format data into the buffers to be rendered as lines
+                // x component of the normal to the current segment (the normal is parallel to the XY plane)
+                float normal_x = (curr.position - prev.position).normalized()[1];
+                for (const GCodeProcessor::MoveVertex* vertex : { &prev, &curr }) {
+                    // add position
+                    *dst++ = vertex->position[0];
+                    *dst++ = vertex->position[1];
+                    *dst++ = vertex->position[2];
+                    // add normal x component
+                    *dst++ = normal_x;
+                }
+                break;
+            }
+            case TBuffer::ERenderPrimitiveType::Triangle: {
+                // format data into the buffers to be rendered as solid
+                auto store_vertex = [&dst](const Vec3f& position, const Vec3f& normal) {
+                    // append position
+                    *dst++ = position[0];
+                    *dst++ = position[1];
+                    *dst++ = position[2];
+                    // append normal
+                    *dst++ = normal[0];
+                    *dst++ = normal[1];
+                    *dst++ = normal[2];
+                };
+
+                const Path& path = t_buffer.paths[slot.path_id];
+
+                Vec3f dir = (curr.position - prev.position).normalized();
+                Vec3f right = Vec3f(dir[1], -dir[0], 0.0f).normalized();
+                Vec3f left = -right;
+                Vec3f up = right.cross(dir);
+                Vec3f down = -up;
+                float half_width = 0.5f * path.width;
+                float half_height = 0.5f * path.height;
+                Vec3f prev_pos = prev.position - half_height * up;
+                Vec3f curr_pos = curr.position - half_height * up;
+                Vec3f d_up = half_height * up;
+                Vec3f d_down = -half_height * up;
+                Vec3f d_right = half_width * right;
+                Vec3f d_left = -half_width * right;
+
+                // vertices 1st endpoint
+                if (slot.full_segment) {
+                    // 1st segment or restart into a new vertex buffer
+                    // ===============================================
+                    store_vertex(prev_pos + d_up, up);
+                    store_vertex(prev_pos + d_right, right);
+                    store_vertex(prev_pos + d_down, down);
+                    store_vertex(prev_pos + d_left, left);
+                }
+                else {
+                    // any other segment
+                    // =================
+                    store_vertex(prev_pos + d_right, right);
+                    store_vertex(prev_pos + d_left, left);
+                }
+
+                // vertices 2nd endpoint
+                store_vertex(curr_pos + d_up, up);
+                store_vertex(curr_pos + d_right, right);
+                store_vertex(curr_pos + d_down, down);
+                store_vertex(curr_pos + d_left, left);
+                break;
+            }
+            }
+        }
+    });
+
+    // smooth toolpaths corners for the given TBuffer using triangles
+    auto smooth_triangle_toolpaths_corners = [&moves](const TBuffer& t_buffer, MultiVertexBuffer& v_multibuffer) {
+        auto extract_position_at = [](const VertexBuffer& vertices, size_t offset) {
+            return Vec3f(vertices[offset + 0], vertices[offset + 1], vertices[offset + 2]);
+        };
+        auto update_position_at = [](VertexBuffer& vertices, size_t offset, const Vec3f& position) {
+            vertices[offset + 0] = position[0];
+            vertices[offset + 1] = position[1];
+            vertices[offset + 2] = position[2];
+        };
+        auto match_right_vertices = [&](const Path::Sub_Path& prev_sub_path, const Path::Sub_Path& next_sub_path,
+            size_t curr_s_id, size_t vertex_size_floats, const Vec3f& displacement_vec) {
+                if (&prev_sub_path == &next_sub_path) { // previous and next segment are both contained into to the same vertex buffer
+                    VertexBuffer& vbuffer = v_multibuffer[prev_sub_path.first.b_id];
+                    // offset into the vertex buffer of the next segment 1st vertex
+                    size_t next_1st_offset = (prev_sub_path.last.s_id - curr_s_id) * 6 * vertex_size_floats;
+                    // offset into the vertex buffer of the right vertex of the previous segment
+                    size_t prev_right_offset = prev_sub_path.last.i_id - next_1st_offset - 3 * vertex_size_floats;
+                    // new position of the right vertices
+                    Vec3f shared_vertex = extract_position_at(vbuffer, prev_right_offset) + displacement_vec;
+                    // update previous segment
+                    update_position_at(vbuffer, prev_right_offset, shared_vertex);
+                    // offset into the vertex buffer of the right vertex of the next segment
+                    size_t next_right_offset = next_sub_path.last.i_id - next_1st_offset;
+                    // update next segment
+                    update_position_at(vbuffer, next_right_offset, shared_vertex);
+                }
+                else { // previous and next segment are contained into different vertex buffers
+                    VertexBuffer& prev_vbuffer = v_multibuffer[prev_sub_path.first.b_id];
+                    VertexBuffer& next_vbuffer = v_multibuffer[next_sub_path.first.b_id];
+                    // offset into the previous vertex buffer of the right vertex of the previous segment
+                    size_t prev_right_offset = prev_sub_path.last.i_id - 3 * vertex_size_floats;
+                    // new position of the right vertices
+                    Vec3f shared_vertex = extract_position_at(prev_vbuffer, prev_right_offset) + displacement_vec;
+                    // update previous segment
+                    update_position_at(prev_vbuffer, prev_right_offset, shared_vertex);
+                    // offset into the next vertex buffer of the right vertex of the next segment
+                    size_t next_right_offset = next_sub_path.first.i_id + 1 * vertex_size_floats;
+                    // update next segment
+                    update_position_at(next_vbuffer, next_right_offset, shared_vertex);
+                }
+        };
+        auto match_left_vertices = [&](const Path::Sub_Path& prev_sub_path, const Path::Sub_Path& next_sub_path,
+            size_t curr_s_id, size_t vertex_size_floats, const Vec3f& displacement_vec) {
+                if (&prev_sub_path == &next_sub_path) { // previous and next segment are both contained into to the same vertex buffer
+                    VertexBuffer& vbuffer = v_multibuffer[prev_sub_path.first.b_id];
+                    // offset into the vertex buffer of the next segment 1st vertex
+                    size_t next_1st_offset = (prev_sub_path.last.s_id - curr_s_id) * 6 * vertex_size_floats;
+                    // offset into the vertex buffer of the left vertex of the previous segment
+                    size_t prev_left_offset = prev_sub_path.last.i_id - next_1st_offset - 1 * vertex_size_floats;
+                    // new position of the left vertices
+                    Vec3f shared_vertex = extract_position_at(vbuffer, prev_left_offset) + displacement_vec;
+                    // update previous segment
+                    update_position_at(vbuffer, prev_left_offset, shared_vertex);
+                    // offset into the vertex buffer of the left vertex of the next segment
+                    size_t next_left_offset = next_sub_path.last.i_id - next_1st_offset + 1 * vertex_size_floats;
+                    // update next segment
+                    update_position_at(vbuffer, next_left_offset, shared_vertex);
+                }
+                else { // previous and next segment are contained into different vertex buffers
+                    VertexBuffer& prev_vbuffer = v_multibuffer[prev_sub_path.first.b_id];
+                    VertexBuffer& next_vbuffer = v_multibuffer[next_sub_path.first.b_id];
+                    // offset into the previous vertex buffer of the left vertex of the previous segment
+                    size_t prev_left_offset = prev_sub_path.last.i_id - 1 * vertex_size_floats;
+                    // new position of the left vertices
+                    Vec3f shared_vertex = extract_position_at(prev_vbuffer, prev_left_offset) + displacement_vec;
+                    // update previous segment
+                    update_position_at(prev_vbuffer, prev_left_offset, shared_vertex);
+                    // offset into the next vertex buffer of the left vertex of the next segment
+                    size_t next_left_offset = next_sub_path.first.i_id + 3 * vertex_size_floats;
+                    // update next segment
+                    update_position_at(next_vbuffer, next_left_offset, shared_vertex);
+                }
+        };
+
+        size_t vertex_size_floats = t_buffer.vertices.vertex_size_floats();
+        // the corners of a path only move the vertices of the path itself, so the paths are smoothed in parallel
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, t_buffer.paths.size()), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t path_id = range.begin(); path_id < range.end(); ++path_id) {
+                const Path& path = t_buffer.paths[path_id];
+                // the two segments of the path sharing the current vertex may belong
+                // to two different vertex buffers
+                size_t prev_sub_path_id = 0;
+                size_t next_sub_path_id = 0;
+                size_t path_vertices_count = path.vertices_count();
+                float half_width = 0.5f * path.width;
+                for (size_t j = 1; j < path_vertices_count - 1; ++j) {
+                    size_t curr_s_id = path.sub_paths.front().first.s_id + j;
+                    const Vec3f& prev = moves[curr_s_id - 1].position;
+                    const Vec3f& curr = moves[curr_s_id].position;
+                    const Vec3f& next = moves[curr_s_id + 1].position;
+
+                    // select the subpaths which contains the previous/next segments
+                    if (!path.sub_paths[prev_sub_path_id].contains(curr_s_id))
+                        ++prev_sub_path_id;
+                    if (!path.sub_paths[next_sub_path_id].contains(curr_s_id + 1))
+                        ++next_sub_path_id;
+                    const Path::Sub_Path& prev_sub_path = path.sub_paths[prev_sub_path_id];
+                    const Path::Sub_Path& next_sub_path = path.sub_paths[next_sub_path_id];
+
+                    Vec3f prev_dir = (curr - prev).normalized();
+                    Vec3f prev_right = Vec3f(prev_dir[1], -prev_dir[0], 0.0f).normalized();
+                    Vec3f prev_up = prev_right.cross(prev_dir);
+
+                    Vec3f next_dir = (next - curr).normalized();
+
+                    bool is_right_turn = prev_up.dot(prev_dir.cross(next_dir)) <= 0.0f;
+                    float cos_dir = prev_dir.dot(next_dir);
+                    // whether the angle between adjacent segments is greater than 45 degrees
+                    bool is_sharp = cos_dir < 0.7071068f;
+
+                    float displacement = 0.0f;
+                    if (cos_dir > -0.9998477f) {
+                        // if the angle between adjacent segments is smaller than 179 degrees
+                        Vec3f med_dir = (prev_dir + next_dir).normalized();
+                        displacement = half_width * ::tan(::acos(std::clamp(next_dir.dot(med_dir), -1.0f, 1.0f)));
+                    }
+
+                    float sq_prev_length = (curr - prev).squaredNorm();
+                    float sq_next_length = (next - curr).squaredNorm();
+                    float sq_displacement = sqr(displacement);
+                    bool can_displace = displacement > 0.0f && sq_displacement < sq_prev_length && sq_displacement < sq_next_length;
+
+                    if (can_displace) {
+                        // displacement to apply to the vertices to match
+                        Vec3f displacement_vec = displacement * prev_dir;
+                        // matches inner corner vertices
+                        if (is_right_turn)
+                            match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
+                        else
+                            match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
+
+                        if (!is_sharp) {
+                            // matches outer corner vertices
+                            if (is_right_turn)
+                                match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
+                            else
+                                match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
+                        }
+                    }
+                }
+            }
+        });
     };
 
+    // smooth toolpaths corners for TBuffers using triangles
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const TBuffer& t_buffer = buffers[i];
+        if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
+            smooth_triangle_toolpaths_corners(t_buffer, vertices[i]);
+        }
+    }
+
+    // move the wipe toolpaths half height up to render them on proper position
+    MultiVertexBuffer& wipe_vertices = vertices[buffer_id(EMoveType::Wipe)];
+    for (VertexBuffer& v_buffer : wipe_vertices) {
+        for (size_t i = 2; i < v_buffer.size(); i += 3) {
+            v_buffer[i] += 0.5f * GCodeProcessor::Wipe_Height;
+        }
+    }
+}
+
+void GCodeToolpaths::generate_indices(const GCodeProcessor::Result& gcode_result, unsigned char tbuffer_id, TBuffer& t_buffer,
+    MultiIndexBuffer& indices, std::vector<unsigned int>& vbuffer_ids)
+{
+    // max index buffer size, in bytes
+    static const size_t IBUFFER_THRESHOLD_BYTES = 64 * 1024 * 1024;
+
     // format data into the buffers to be rendered as points
-    auto add_vertices_as_point = [](const GCodeProcessor::MoveVertex& curr, VertexBuffer& vertices) {
-        vertices.push_back(curr.position[0]);
-        vertices.push_back(curr.position[1]);
-        vertices.push_back(curr.position[2]);
-    };
     auto add_indices_as_point = [](const GCodeProcessor::MoveVertex& curr, TBuffer& buffer,
         unsigned int ibuffer_id, IndexBuffer& indices, size_t move_id) {
             buffer.add_path(curr, ibuffer_id, indices.size(), move_id);
@@ -1275,24 +1709,6 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
     };
 
     // format data into the buffers to be rendered as lines
-    auto add_vertices_as_line = [](const GCodeProcessor::MoveVertex& prev, const GCodeProcessor::MoveVertex& curr, VertexBuffer& vertices) {
-        // x component of the normal to the current segment (the normal is parallel to the XY plane)
-        float normal_x = (curr.position - prev.position).normalized()[1];
-
-        auto add_vertex = [&vertices, normal_x](const GCodeProcessor::MoveVertex& vertex) {
-            // add position
-            vertices.push_back(vertex.position[0]);
-            vertices.push_back(vertex.position[1]);
-            vertices.push_back(vertex.position[2]);
-            // add normal x component
-            vertices.push_back(normal_x);
-        };
-
-        // add previous vertex
-        add_vertex(prev);
-        // add current vertex
-        add_vertex(curr);
-    };
     auto add_indices_as_line = [](const GCodeProcessor::MoveVertex& prev, const GCodeProcessor::MoveVertex& curr, TBuffer& buffer,
         unsigned int ibuffer_id, IndexBuffer& indices, size_t move_id) {
             if (prev.type != curr.type || !buffer.paths.back().matches(curr)) {
@@ -1314,73 +1730,17 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
     };
 
     // format data into the buffers to be rendered as solid
-    auto add_vertices_as_solid = [](const GCodeProcessor::MoveVertex& prev, const GCodeProcessor::MoveVertex& curr, TBuffer& buffer, unsigned int vbuffer_id, VertexBuffer& vertices, size_t move_id) {
-        auto store_vertex = [](VertexBuffer& vertices, const Vec3f& position, const Vec3f& normal) {
-            // append position
-            vertices.push_back(position[0]);
-            vertices.push_back(position[1]);
-            vertices.push_back(position[2]);
-            // append normal
-            vertices.push_back(normal[0]);
-            vertices.push_back(normal[1]);
-            vertices.push_back(normal[2]);
-        };
-
-        if (prev.type != curr.type || !buffer.paths.back().matches(curr)) {
-            buffer.add_path(curr, vbuffer_id, vertices.size(), move_id - 1);
-            buffer.paths.back().sub_paths.back().first.position = prev.position;
-        }
-
-        Path& last_path = buffer.paths.back();
-
-        Vec3f dir = (curr.position - prev.position).normalized();
-        Vec3f right = Vec3f(dir[1], -dir[0], 0.0f).normalized();
-        Vec3f left = -right;
-        Vec3f up = right.cross(dir);
-        Vec3f down = -up;
-        float half_width = 0.5f * last_path.width;
-        float half_height = 0.5f * last_path.height;
-        Vec3f prev_pos = prev.position - half_height * up;
-        Vec3f curr_pos = curr.position - half_height * up;
-        Vec3f d_up = half_height * up;
-        Vec3f d_down = -half_height * up;
-        Vec3f d_right = half_width * right;
-        Vec3f d_left = -half_width * right;
-
-        // vertices 1st endpoint
-        if (last_path.vertices_count() == 1 || vertices.empty()) {
-            // 1st segment or restart into a new vertex buffer
-            // ===============================================
-            store_vertex(vertices, prev_pos + d_up, up);
-            store_vertex(vertices, prev_pos + d_right, right);
-            store_vertex(vertices, prev_pos + d_down, down);
-            store_vertex(vertices, prev_pos + d_left, left);
-        }
-        else {
-            // any other segment
-            // =================
-            store_vertex(vertices, prev_pos + d_right, right);
-            store_vertex(vertices, prev_pos + d_left, left);
-        }
-
-        // vertices 2nd endpoint
-        store_vertex(vertices, curr_pos + d_up, up);
-        store_vertex(vertices, curr_pos + d_right, right);
-        store_vertex(vertices, curr_pos + d_down, down);
-        store_vertex(vertices, curr_pos + d_left, left);
-
-        last_path.sub_paths.back().last = { vbuffer_id, vertices.size(), move_id, curr.position };
-    };
+    // data of the previous segment of the current path
+    Vec3f prev_dir = Vec3f::Zero();
+    Vec3f prev_up = Vec3f::Zero();
+    float sq_prev_length = 0.0f;
 #if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
     auto add_indices_as_solid = [&](const GCodeProcessor::MoveVertex& prev, const GCodeProcessor::MoveVertex& curr, const GCodeProcessor::MoveVertex* next,
         TBuffer& buffer, size_t& vbuffer_size, unsigned int ibuffer_id, IndexBuffer& indices, size_t move_id) {
 #else
-    auto add_indices_as_solid = [](const GCodeProcessor::MoveVertex& prev, const GCodeProcessor::MoveVertex& curr, TBuffer& buffer,
+    auto add_indices_as_solid = [&](const GCodeProcessor::MoveVertex& prev, const GCodeProcessor::MoveVertex& curr, TBuffer& buffer,
         size_t& vbuffer_size, unsigned int ibuffer_id, IndexBuffer& indices, size_t move_id) {
 #endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-            static Vec3f prev_dir;
-            static Vec3f prev_up;
-            static float sq_prev_length;
             auto store_triangle = [](IndexBuffer& indices, IBufferType i1, IBufferType i2, IBufferType i3) {
                 indices.push_back(i1);
                 indices.push_back(i2);
@@ -1544,17 +1904,118 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
 
                 vbuffer_size += 6;
             }
-
-#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-            if (next != nullptr && (curr.type != next->type || !last_path.matches(*next)))
-                // ending cap triangles
-                append_ending_cap_triangles(indices, non_first_seg_v_offsets);
-#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-
-            last_path.sub_paths.back().last = { ibuffer_id, indices.size() - 1, move_id, curr.position };
-            prev_dir = dir;
-            prev_up = up;
-            sq_prev_length = sq_length;
+
+#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+            if (next != nullptr && (curr.type != next->type || !last_path.matches(*next)))
+                // ending cap triangles
+                append_ending_cap_triangles(indices, non_first_seg_v_offsets);
+#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+
+            last_path.sub_paths.back().last = { ibuffer_id, indices.size() - 1, move_id, curr.position };
+            prev_dir = dir;
+            prev_up = up;
+            sq_prev_length = sq_length;
+    };
+
+    // variable used to keep track of the current vertex buffer index and size
+    unsigned int curr_vbuffer_id = 0;
+    size_t curr_vbuffer_size = 0;
+
+    const size_t moves_count = gcode_result.moves.size();
+    for (size_t i = 1; i < moves_count; ++i) {
+        const GCodeProcessor::MoveVertex& curr = gcode_result.moves[i];
+        if (buffer_id(curr.type) != tbuffer_id)
+            continue;
+
+        const GCodeProcessor::MoveVertex& prev = gcode_result.moves[i - 1];
+#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+        const GCodeProcessor::MoveVertex* next = nullptr;
+        if (i < moves_count - 1)
+            next = &gcode_result.moves[i + 1];
+#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+
+        // ensure there is at least one index buffer
+        if (indices.empty()) {
+            indices.push_back(IndexBuffer());
+            vbuffer_ids.push_back(curr_vbuffer_id);
+        }
+
+        // if adding the indices for the current segment exceeds the threshold size of the current index buffer
+        // create another index buffer
+#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+        if (indices.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - t_buffer.max_indices_per_segment_size_bytes()) {
+#else
+        if (indices.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - t_buffer.indices_per_segment_size_bytes()) {
+#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+            indices.push_back(IndexBuffer());
+            vbuffer_ids.push_back(curr_vbuffer_id);
+            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::Point) {
+                Path& last_path = t_buffer.paths.back();
+                last_path.add_sub_path(prev, static_cast<unsigned int>(indices.size()) - 1, 0, i - 1);
+            }
+        }
+
+        // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
+        // create another index buffer
+        if (curr_vbuffer_size * t_buffer.vertices.vertex_size_bytes() > t_buffer.vertices.max_size_bytes() - t_buffer.max_vertices_per_segment_size_bytes()) {
+            indices.push_back(IndexBuffer());
+
+            ++curr_vbuffer_id;
+            curr_vbuffer_size = 0;
+            vbuffer_ids.push_back(curr_vbuffer_id);
+
+            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::Point) {
+                Path& last_path = t_buffer.paths.back();
+                last_path.add_sub_path(prev, static_cast<unsigned int>(indices.size()) - 1, 0, i - 1);
+            }
+        }
+
+        IndexBuffer& i_buffer = indices.back();
+
+        switch (t_buffer.render_primitive_type)
+        {
+        case TBuffer::ERenderPrimitiveType::Point: {
+            add_indices_as_point(curr, t_buffer, static_cast<unsigned int>(indices.size()) - 1, i_buffer, i);
+            curr_vbuffer_size += t_buffer.max_vertices_per_segment();
+            break;
+        }
+        case TBuffer::ERenderPrimitiveType::Line: {
+            add_indices_as_line(prev, curr, t_buffer, static_cast<unsigned int>(indices.size()) - 1, i_buffer, i);
+            curr_vbuffer_size += t_buffer.max_vertices_per_segment();
+            break;
+        }
+        case TBuffer::ERenderPrimitiveType::Triangle: {
+#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+            add_indices_as_solid(prev, curr, next, t_buffer, curr_vbuffer_size, static_cast<unsigned int>(indices.size()) - 1, i_buffer, i);
+#else
+            add_indices_as_solid(prev, curr, t_buffer, curr_vbuffer_size, static_cast<unsigned int>(indices.size()) - 1, i_buffer, i);
+#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
+            break;
+        }
+        }
+    }
+
+    for (IndexBuffer& i_buffer : indices) {
+        i_buffer.shrink_to_fit();
+    }
+}
+
+void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
+{
+    auto log_memory_usage = [this](const std::string& label, const std::vector<MultiVertexBuffer>& vertices, const std::vector<MultiIndexBuffer>& indices) {
+        int64_t vertices_size = 0;
+        for (const MultiVertexBuffer& buffers : vertices) {
+            for (const VertexBuffer& buffer : buffers) {
+                vertices_size += SLIC3R_STDVEC_MEMSIZE(buffer, float);
+            }
+        }
+        int64_t indices_size = 0;
+        for (const MultiIndexBuffer& buffers : indices) {
+            for (const IndexBuffer& buffer : buffers) {
+                indices_size += SLIC3R_STDVEC_MEMSIZE(buffer, IBufferType);
+            }
+        }
+        log_memory_used(label, vertices_size + indices_size);
     };
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
@@ -1567,8 +2028,6 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
     if (m_moves_count == 0)
         return;
 
-    unsigned int progress_count = 0;
-    static const unsigned int progress_threshold = 1000;
     wxProgressDialog* progress_dialog = wxGetApp().is_gcode_viewer() ?
         new wxProgressDialog(_L("Generating toolpaths"), "...",
             100, wxGetApp().plater(), wxPD_AUTO_HIDE | wxPD_APP_MODAL) : nullptr;
@@ -1594,239 +2053,40 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
     std::vector<MultiIndexBuffer> indices(m_buffers.size());
     std::vector<float> options_zs;
 
-    // toolpaths data -> extract vertices from result
-    for (size_t i = 0; i < m_moves_count; ++i) {
-        const GCodeProcessor::MoveVertex& curr = gcode_result.moves[i];
-
-        // skip first vertex
-        if (i == 0)
-            continue;
-
-        const GCodeProcessor::MoveVertex& prev = gcode_result.moves[i - 1];
-
-        // update progress dialog
-        ++progress_count;
-        if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
-            progress_dialog->Update(int(100.0f * float(i) / (2.0f * float(m_moves_count))),
-                _L("Generating vertex buffer") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(m_moves_count), 0, wxNumberFormatter::Style_None) + "%");
-            progress_dialog->Fit();
-            progress_count = 0;
-        }
-
-        unsigned char id = buffer_id(curr.type);
-        TBuffer& t_buffer = m_buffers[id];
-        MultiVertexBuffer& v_multibuffer = vertices[id];
-
-        // ensure there is at least one vertex buffer
-        if (v_multibuffer.empty())
-            v_multibuffer.push_back(VertexBuffer());
-
-        // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
-        // add another vertex buffer
-        if (v_multibuffer.back().size() * sizeof(float) > t_buffer.vertices.max_size_bytes() - t_buffer.max_vertices_per_segment_size_bytes()) {
-            v_multibuffer.push_back(VertexBuffer());
-            if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
-                Path& last_path = t_buffer.paths.back();
-                if (prev.type == curr.type && last_path.matches(curr))
-                    last_path.add_sub_path(prev, static_cast<unsigned int>(v_multibuffer.size()) - 1, 0, i - 1);
-            }
-        }
-
-        VertexBuffer& v_buffer = v_multibuffer.back();
-
-        switch (t_buffer.render_primitive_type)
-        {
-        case TBuffer::ERenderPrimitiveType::Point:    { add_vertices_as_point(curr, v_buffer); break; }
-        case TBuffer::ERenderPrimitiveType::Line:     { add_vertices_as_line(prev, curr, v_buffer); break; }
-        case TBuffer::ERenderPrimitiveType::Triangle: { add_vertices_as_solid(prev, curr, t_buffer, static_cast<unsigned int>(v_multibuffer.size()) - 1, v_buffer, i); break; }
-        }
-
-        // collect options zs for later use
-        if (curr.type == EMoveType::Pause_Print || curr.type == EMoveType::Custom_GCode) {
-            const float* const last_z = options_zs.empty() ? nullptr : &options_zs.back();
-            if (last_z == nullptr || curr.position[2] < *last_z - EPSILON || *last_z + EPSILON < curr.position[2])
-                options_zs.emplace_back(curr.position[2]);
-        }
+    if (progress_dialog != nullptr) {
+        progress_dialog->Update(0, _L("Generating vertex buffer") + "...");
+        progress_dialog->Fit();
     }
 
-    // smooth toolpaths corners for the given TBuffer using triangles
-    auto smooth_triangle_toolpaths_corners = [&gcode_result](const TBuffer& t_buffer, MultiVertexBuffer& v_multibuffer) {
-        auto extract_position_at = [](const VertexBuffer& vertices, size_t offset) {
-            return Vec3f(vertices[offset + 0], vertices[offset + 1], vertices[offset + 2]);
-        };
-        auto update_position_at = [](VertexBuffer& vertices, size_t offset, const Vec3f& position) {
-            vertices[offset + 0] = position[0];
-            vertices[offset + 1] = position[1];
-            vertices[offset + 2] = position[2];
-        };
-        auto match_right_vertices = [&](const Path::Sub_Path& prev_sub_path, const Path::Sub_Path& next_sub_path,
-            size_t curr_s_id, size_t vertex_size_floats, const Vec3f& displacement_vec) {
-                if (&prev_sub_path == &next_sub_path) { // previous and next segment are both contained into to the same vertex buffer
-                    VertexBuffer& vbuffer = v_multibuffer[prev_sub_path.first.b_id];
-                    // offset into the vertex buffer of the next segment 1st vertex
-                    size_t next_1st_offset = (prev_sub_path.last.s_id - curr_s_id) * 6 * vertex_size_floats;
-                    // offset into the vertex buffer of the right vertex of the previous segment 
-                    size_t prev_right_offset = prev_sub_path.last.i_id - next_1st_offset - 3 * vertex_size_floats;
-                    // new position of the right vertices
-                    Vec3f shared_vertex = extract_position_at(vbuffer, prev_right_offset) + displacement_vec;
-                    // update previous segment
-                    update_position_at(vbuffer, prev_right_offset, shared_vertex);
-                    // offset into the vertex buffer of the right vertex of the next segment
-                    size_t next_right_offset = next_sub_path.last.i_id - next_1st_offset;
-                    // update next segment
-                    update_position_at(vbuffer, next_right_offset, shared_vertex);
-                }
-                else { // previous and next segment are contained into different vertex buffers
-                    VertexBuffer& prev_vbuffer = v_multibuffer[prev_sub_path.first.b_id];
-                    VertexBuffer& next_vbuffer = v_multibuffer[next_sub_path.first.b_id];
-                    // offset into the previous vertex buffer of the right vertex of the previous segment 
-                    size_t prev_right_offset = prev_sub_path.last.i_id - 3 * vertex_size_floats;
-                    // new position of the right vertices
-                    Vec3f shared_vertex = extract_position_at(prev_vbuffer, prev_right_offset) + displacement_vec;
-                    // update previous segment
-                    update_position_at(prev_vbuffer, prev_right_offset, shared_vertex);
-                    // offset into the next vertex buffer of the right vertex of the next segment
-                    size_t next_right_offset = next_sub_path.first.i_id + 1 * vertex_size_floats;
-                    // update next segment
-                    update_position_at(next_vbuffer, next_right_offset, shared_vertex);
-                }
-        };
-        auto match_left_vertices = [&](const Path::Sub_Path& prev_sub_path, const Path::Sub_Path& next_sub_path,
-            size_t curr_s_id, size_t vertex_size_floats, const Vec3f& displacement_vec) {
-                if (&prev_sub_path == &next_sub_path) { // previous and next segment are both contained into to the same vertex buffer
-                    VertexBuffer& vbuffer = v_multibuffer[prev_sub_path.first.b_id];
-                    // offset into the vertex buffer of the next segment 1st vertex
-                    size_t next_1st_offset = (prev_sub_path.last.s_id - curr_s_id) * 6 * vertex_size_floats;
-                    // offset into the vertex buffer of the left vertex of the previous segment 
-                    size_t prev_left_offset = prev_sub_path.last.i_id - next_1st_offset - 1 * vertex_size_floats;
-                    // new position of the left vertices
-                    Vec3f shared_vertex = extract_position_at(vbuffer, prev_left_offset) + displacement_vec;
-                    // update previous segment
-                    update_position_at(vbuffer, prev_left_offset, shared_vertex);
-                    // offset into the vertex buffer of the left vertex of the next segment
-                    size_t next_left_offset = next_sub_path.last.i_id - next_1st_offset + 1 * vertex_size_floats;
-                    // update next segment
-                    update_position_at(vbuffer, next_left_offset, shared_vertex);
-                }
-                else { // previous and next segment are contained into different vertex buffers
-                    VertexBuffer& prev_vbuffer = v_multibuffer[prev_sub_path.first.b_id];
-                    VertexBuffer& next_vbuffer = v_multibuffer[next_sub_path.first.b_id];
-                    // offset into the previous vertex buffer of the left vertex of the previous segment 
-                    size_t prev_left_offset = prev_sub_path.last.i_id - 1 * vertex_size_floats;
-                    // new position of the left vertices
-                    Vec3f shared_vertex = extract_position_at(prev_vbuffer, prev_left_offset) + displacement_vec;
-                    // update previous segment
-                    update_position_at(prev_vbuffer, prev_left_offset, shared_vertex);
-                    // offset into the next vertex buffer of the left vertex of the next segment
-                    size_t next_left_offset = next_sub_path.first.i_id + 3 * vertex_size_floats;
-                    // update next segment
-                    update_position_at(next_vbuffer, next_left_offset, shared_vertex);
-                }
-        };
-
-        size_t vertex_size_floats = t_buffer.vertices.vertex_size_floats();
-        for (const Path& path : t_buffer.paths) {
-            // the two segments of the path sharing the current vertex may belong
-            // to two different vertex buffers
-            size_t prev_sub_path_id = 0;
-            size_t next_sub_path_id = 0;
-            size_t path_vertices_count = path.vertices_count();
-            float half_width = 0.5f * path.width;
-            for (size_t j = 1; j < path_vertices_count - 1; ++j) {
-                size_t curr_s_id = path.sub_paths.front().first.s_id + j;
-                const Vec3f& prev = gcode_result.moves[curr_s_id - 1].position;
-                const Vec3f& curr = gcode_result.moves[curr_s_id].position;
-                const Vec3f& next = gcode_result.moves[curr_s_id + 1].position;
-
-                // select the subpaths which contains the previous/next segments
-                if (!path.sub_paths[prev_sub_path_id].contains(curr_s_id))
-                    ++prev_sub_path_id;
-                if (!path.sub_paths[next_sub_path_id].contains(curr_s_id + 1))
-                    ++next_sub_path_id;
-                const Path::Sub_Path& prev_sub_path = path.sub_paths[prev_sub_path_id];
-                const Path::Sub_Path& next_sub_path = path.sub_paths[next_sub_path_id];
-
-                Vec3f prev_dir = (curr - prev).normalized();
-                Vec3f prev_right = Vec3f(prev_dir[1], -prev_dir[0], 0.0f).normalized();
-                Vec3f prev_up = prev_right.cross(prev_dir);
-
-                Vec3f next_dir = (next - curr).normalized();
-
-                bool is_right_turn = prev_up.dot(prev_dir.cross(next_dir)) <= 0.0f;
-                float cos_dir = prev_dir.dot(next_dir);
-                // whether the angle between adjacent segments is greater than 45 degrees
-                bool is_sharp = cos_dir < 0.7071068f;
-
-                float displacement = 0.0f;
-                if (cos_dir > -0.9998477f) {
-                    // if the angle between adjacent segments is smaller than 179 degrees
-                    Vec3f med_dir = (prev_dir + next_dir).normalized();
-                    displacement = half_width * ::tan(::acos(std::clamp(next_dir.dot(med_dir), -1.0f, 1.0f)));
-                }
-
-                float sq_prev_length = (curr - prev).squaredNorm();
-                float sq_next_length = (next - curr).squaredNorm();
-                float sq_displacement = sqr(displacement);
-                bool can_displace = displacement > 0.0f && sq_displacement < sq_prev_length && sq_displacement < sq_next_length;
-
-                if (can_displace) {
-                    // displacement to apply to the vertices to match
-                    Vec3f displacement_vec = displacement * prev_dir;
-                    // matches inner corner vertices
-                    if (is_right_turn)
-                        match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
-                    else
-                        match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
-
-                    if (!is_sharp) {
-                        // matches outer corner vertices
-                        if (is_right_turn)
-                            match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
-                        else
-                            match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
-                    }
-                }
-            }
-        }
-    };
+    // toolpaths data -> extract vertices from result
+    GCodeToolpaths::generate_vertices(gcode_result, m_buffers, vertices, options_zs);
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
     auto load_vertices_time = std::chrono::high_resolution_clock::now();
     m_statistics.load_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-    // smooth toolpaths corners for TBuffers using triangles
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        const TBuffer& t_buffer = m_buffers[i];
-        if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
-            smooth_triangle_toolpaths_corners(t_buffer, vertices[i]);
-        }
-    }
-
-    for (MultiVertexBuffer& v_multibuffer : vertices) {
-        for (VertexBuffer& v_buffer : v_multibuffer) {
-            v_buffer.shrink_to_fit();
-        }
-    }
-
-    // move the wipe toolpaths half height up to render them on proper position
-    MultiVertexBuffer& wipe_vertices = vertices[buffer_id(EMoveType::Wipe)];
-    for (VertexBuffer& v_buffer : wipe_vertices) {
-        for (size_t i = 2; i < v_buffer.size(); i += 3) {
-            v_buffer[i] += 0.5f * GCodeProcessor::Wipe_Height;
-        }
-    }
+    // the solid toolpaths may be stored on the gpu with quantized positions and normals, to save memory
+    const bool quantize = get_app_config()->get("gcode_preview_quantized") == "1";
+    int64_t quantization_saved_size = 0;
 
     // send vertices data to gpu
     for (size_t i = 0; i < m_buffers.size(); ++i) {
         TBuffer& t_buffer = m_buffers[i];
+        t_buffer.vertices.quantized = quantize && t_buffer.vertices.format == VBuffer::EFormat::PositionNormal3;
 
         const MultiVertexBuffer& v_multibuffer = vertices[i];
         for (const VertexBuffer& v_buffer : v_multibuffer) {
             size_t size_elements = v_buffer.size();
-            size_t size_bytes = size_elements * sizeof(float);
             size_t vertices_count = size_elements / t_buffer.vertices.vertex_size_floats();
             t_buffer.vertices.count += vertices_count;
+            std::vector<unsigned char> quantized_data;
+            if (t_buffer.vertices.quantized) {
+                quantized_data = t_buffer.vertices.quantize(v_buffer, t_buffer.vertices.vbos.size());
+                quantization_saved_size += static_cast<int64_t>(size_elements * sizeof(float) - quantized_data.size());
+            }
+            const void* data = t_buffer.vertices.quantized ? static_cast<const void*>(quantized_data.data()) : static_cast<const void*>(v_buffer.data());
+            size_t size_bytes = t_buffer.vertices.quantized ? quantized_data.size() : size_elements * sizeof(float);
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
             m_statistics.total_vertices_gpu_size += static_cast<int64_t>(size_bytes);
@@ -1839,20 +2099,28 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
             t_buffer.vertices.vbos.push_back(static_cast<unsigned int>(id));
             t_buffer.vertices.sizes.push_back(size_bytes);
             glsafe(::glBindBuffer(GL_ARRAY_BUFFER, id));
-            glsafe(::glBufferData(GL_ARRAY_BUFFER, size_bytes, v_buffer.data(), GL_STATIC_DRAW));
+            glsafe(::glBufferData(GL_ARRAY_BUFFER, size_bytes, data, GL_STATIC_DRAW));
             glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
         }
     }
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
+    m_statistics.quantization_saved_gpu_size = quantization_saved_size;
     auto smooth_vertices_time = std::chrono::high_resolution_clock::now();
     m_statistics.smooth_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - load_vertices_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
-    log_memory_usage("Loaded G-code generated vertex buffers ", vertices, indices);
+    log_memory_usage(quantize ?
+        "Loaded G-code generated vertex buffers (quantization saved " + format_memsize_MB(quantization_saved_size) + " of gpu memory) " :
+        "Loaded G-code generated vertex buffers ", vertices, indices);
 
     // dismiss vertices data, no more needed
     std::vector<MultiVertexBuffer>().swap(vertices);
 
+    if (progress_dialog != nullptr) {
+        progress_dialog->Update(50, _L("Generating index buffers") + "...");
+        progress_dialog->Fit();
+    }
+
     // toolpaths data -> extract indices from result
     // paths may have been filled while extracting vertices,
     // so reset them, they will be filled again while extracting indices
@@ -1860,108 +2128,15 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
         buffer.paths.clear();
     }
 
-    // variable used to keep track of the current vertex buffers index and size
-    using CurrVertexBuffer = std::pair<unsigned int, size_t>;
-    std::vector<CurrVertexBuffer> curr_vertex_buffers(m_buffers.size(), { 0, 0 });
-
-    // variable used to keep track of the vertex buffers ids
-    using VboIndexList = std::vector<unsigned int>;
-    std::vector<VboIndexList> vbo_indices(m_buffers.size());
-
-    for (size_t i = 0; i < m_moves_count; ++i) {
-        const GCodeProcessor::MoveVertex& curr = gcode_result.moves[i];
-
-        // skip first vertex
-        if (i == 0)
-            continue;
-
-        const GCodeProcessor::MoveVertex& prev = gcode_result.moves[i - 1];
-#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-        const GCodeProcessor::MoveVertex* next = nullptr;
-        if (i < m_moves_count - 1)
-            next = &gcode_result.moves[i + 1];
-#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-
-        ++progress_count;
-        if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
-            progress_dialog->Update(int(100.0f * float(m_moves_count + i) / (2.0f * float(m_moves_count))),
-                _L("Generating index buffers") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(m_moves_count), 0, wxNumberFormatter::Style_None) + "%");
-            progress_dialog->Fit();
-            progress_count = 0;
-        }
-
-        unsigned char id = buffer_id(curr.type);
-        TBuffer& t_buffer = m_buffers[id];
-        MultiIndexBuffer& i_multibuffer = indices[id];
-        CurrVertexBuffer& curr_vertex_buffer = curr_vertex_buffers[id];
-        VboIndexList& vbo_index_list = vbo_indices[id];
-
-        // ensure there is at least one index buffer
-        if (i_multibuffer.empty()) {
-            i_multibuffer.push_back(IndexBuffer());
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
-        }
-
-        // if adding the indices for the current segment exceeds the threshold size of the current index buffer
-        // create another index buffer
-#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-        if (i_multibuffer.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - t_buffer.max_indices_per_segment_size_bytes()) {
-#else
-        if (i_multibuffer.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - t_buffer.indices_per_segment_size_bytes()) {
-#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-            i_multibuffer.push_back(IndexBuffer());
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
-            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::Point) {
-                Path& last_path = t_buffer.paths.back();
-                last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, i - 1);
-            }
-        }
-
-        // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
-        // create another index buffer
-        if (curr_vertex_buffer.second * t_buffer.vertices.vertex_size_bytes() > t_buffer.vertices.max_size_bytes() - t_buffer.max_vertices_per_segment_size_bytes()) {
-            i_multibuffer.push_back(IndexBuffer());
-
-            ++curr_vertex_buffer.first;
-            curr_vertex_buffer.second = 0;
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
-
-            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::Point) {
-                Path& last_path = t_buffer.paths.back();
-                last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, i - 1);
-            }
-        }
-
-        IndexBuffer& i_buffer = i_multibuffer.back();
-
-        switch (t_buffer.render_primitive_type)
-        {
-        case TBuffer::ERenderPrimitiveType::Point: {
-            add_indices_as_point(curr, t_buffer, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, i);
-            curr_vertex_buffer.second += t_buffer.max_vertices_per_segment();
-            break;
-        }
-        case TBuffer::ERenderPrimitiveType::Line: {
-            add_indices_as_line(prev, curr, t_buffer, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, i);
-            curr_vertex_buffer.second += t_buffer.max_vertices_per_segment();
-            break;
-        }
-        case TBuffer::ERenderPrimitiveType::Triangle: {
-#if ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-            add_indices_as_solid(prev, curr, next, t_buffer, curr_vertex_buffer.second, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, i);
-#else
-            add_indices_as_solid(prev, curr, t_buffer, curr_vertex_buffer.second, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, i);
-#endif // ENABLE_REDUCED_TOOLPATHS_SEGMENT_CAPS
-            break;
-        }
-        }
-    }
+    // for each index buffer, the index of the vertex buffer it refers to
+    std::vector<std::vector<unsigned int>> vbuffer_ids(m_buffers.size());
 
-    for (MultiIndexBuffer& i_multibuffer : indices) {
-        for (IndexBuffer& i_buffer : i_multibuffer) {
-            i_buffer.shrink_to_fit();
+    // the TBuffers are independent from each other, so their indices are extracted in parallel
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_buffers.size(), 1), [this, &gcode_result, &indices, &vbuffer_ids](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            GCodeToolpaths::generate_indices(gcode_result, static_cast<unsigned char>(i), m_buffers[i], indices[i], vbuffer_ids[i]);
         }
-    }
+    });
 
     // toolpaths data -> send indices data to gpu
     for (size_t i = 0; i < m_buffers.size(); ++i) {
@@ -1975,7 +2150,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessor::Result& gcode_result)
             t_buffer.indices.push_back(IBuffer());
             IBuffer& ibuf = t_buffer.indices.back();
             ibuf.count = size_elements;
-            ibuf.vbo = vbo_indices[i][t_buffer.indices.size() - 1];
+            ibuf.vbo = t_buffer.vertices.vbos[vbuffer_ids[i][t_buffer.indices.size() - 1]];
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
             m_statistics.total_indices_gpu_size += static_cast<int64_t>(size_bytes);
@@ -2994,9 +3169,7 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
                     glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
                     // gets the position from the vertices buffer on gpu
-                    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, i_buffer.vbo));
-                    glsafe(::glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(index * buffer.vertices.vertex_size_bytes()), static_cast<GLsizeiptr>(3 * sizeof(float)), static_cast<void*>(sequential_view->current_position.data())));
-                    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+                    sequential_view->current_position = buffer.vertices.get_position(i_buffer.vbo, index);
 
                     found = true;
                     break;
@@ -3634,13 +3807,7 @@ void GCodeViewer::render_toolpaths() const
                 const IBuffer& i_buffer = buffer.indices[j];
 
                 glsafe(::glBindBuffer(GL_ARRAY_BUFFER, i_buffer.vbo));
-                glsafe(::glVertexPointer(buffer.vertices.position_size_floats(), GL_FLOAT, buffer.vertices.vertex_size_bytes(), (const void*)buffer.vertices.position_offset_size()));
-                glsafe(::glEnableClientState(GL_VERTEX_ARRAY));
-                bool has_normals = buffer.vertices.normal_size_floats() > 0;
-                if (has_normals) {
-                    glsafe(::glNormalPointer(GL_FLOAT, buffer.vertices.vertex_size_bytes(), (const void*)buffer.vertices.normal_offset_size()));
-                    glsafe(::glEnableClientState(GL_NORMAL_ARRAY));
-                }
+                buffer.vertices.enable_arrays(i_buffer.vbo);
 
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, i_buffer.ibo));
 
@@ -3662,10 +3829,7 @@ void GCodeViewer::render_toolpaths() const
 
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
-                if (has_normals)
-                    glsafe(::glDisableClientState(GL_NORMAL_ARRAY));
-
-                glsafe(::glDisableClientState(GL_VERTEX_ARRAY));
+                buffer.vertices.disable_arrays(i_buffer.vbo);
                 glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
             }
 
@@ -3680,13 +3844,7 @@ void GCodeViewer::render_toolpaths() const
             shader->start_using();
 
             glsafe(::glBindBuffer(GL_ARRAY_BUFFER, cap.vbo));
-            glsafe(::glVertexPointer(cap.buffer->vertices.position_size_floats(), GL_FLOAT, cap.buffer->vertices.vertex_size_bytes(), (const void*)cap.buffer->vertices.position_offset_size()));
-            glsafe(::glEnableClientState(GL_VERTEX_ARRAY));
-            bool has_normals = cap.buffer->vertices.normal_size_floats() > 0;
-            if (has_normals) {
-                glsafe(::glNormalPointer(GL_FLOAT, cap.buffer->vertices.vertex_size_bytes(), (const void*)cap.buffer->vertices.normal_offset_size()));
-                glsafe(::glEnableClientState(GL_NORMAL_ARRAY));
-            }
+            cap.buffer->vertices.enable_arrays(cap.vbo);
 
             set_uniform_color(cap.color, *shader);
 
@@ -3698,10 +3856,7 @@ void GCodeViewer::render_toolpaths() const
             ++const_cast<Statistics*>(&m_statistics)->gl_triangles_calls_count;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-            if (has_normals)
-                glsafe(::glDisableClientState(GL_NORMAL_ARRAY));
-
-            glsafe(::glDisableClientState(GL_VERTEX_ARRAY));
+            cap.buffer->vertices.disable_arrays(cap.vbo);
             glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
 
             shader->stop_using();
@@ -4693,6 +4848,9 @@ void GCodeViewer::render_statistics() const
         ImGui::Separator();
         add_memory(std::string("Max VBuffer:"), m_statistics.max_vbuffer_gpu_size);
         add_memory(std::string("Max IBuffer:"), m_statistics.max_ibuffer_gpu_size);
+#if ENABLE_SPLITTED_VERTEX_BUFFER
+        add_memory(std::string("Saved by quantization:"), m_statistics.quantization_saved_gpu_size);
+#endif // ENABLE_SPLITTED_VERTEX_BUFFER
     }
 
     if (ImGui::CollapsingHeader("Other")) {
@@ -17,7 +17,8 @@ class TriangleMesh;
 
 namespace GUI {
 
-class GCodeViewer
+// Toolpaths buffers of the GCodeViewer and the CPU side of their generation, which does not use OpenGL.
+struct GCodeToolpaths
 {
 #if ENABLE_SPLITTED_VERTEX_BUFFER
     using IBufferType = unsigned short;
@@ -32,22 +33,6 @@ class GCodeViewer
 #endif // ENABLE_SPLITTED_VERTEX_BUFFER
     using MultiIndexBuffer = std::vector<IndexBuffer>;
 
-    std::vector<Color> Extrusion_Role_Colors;
-    static const std::vector<Color> Options_Colors;
-    static const std::vector<Color> Travel_Colors;
-    static const Color              Wipe_Color;
-    static const std::vector<Color> Range_Colors;
-
-    enum class EOptionsColors : unsigned char
-    {
-        Retractions,
-        Unretractions,
-        ToolChanges,
-        ColorChanges,
-        PausePrints,
-        CustomGCodes
-    };
-
     // vbo buffer containing vertices data used to render a specific toolpath type
     struct VBuffer
     {
@@ -67,6 +52,12 @@ class GCodeViewer
         std::vector<unsigned int> vbos;
         // sizes of the buffers, in bytes, used in export to obj
         std::vector<size_t> sizes;
+        // whether the vertices are stored on the gpu in the quantized format (PositionNormal3 only):
+        // 3 shorts -> position, relative to the origin of the vbo and in units of its step | 1 short padding |
+        // 3 bytes -> normalized normal | 1 byte padding
+        bool quantized{ false };
+        // origin (x, y, z) and step (w) of the quantized positions, one for each vbo
+        std::vector<std::array<float, 4>> quantizations;
 #else
         // vbo id
         unsigned int id{ 0 };
@@ -83,6 +74,20 @@ class GCodeViewer
 
         size_t vertex_size_floats() const { return position_size_floats() + normal_size_floats(); }
         size_t vertex_size_bytes() const { return vertex_size_floats() * sizeof(float); }
+#if ENABLE_SPLITTED_VERTEX_BUFFER
+        // size of a vertex as stored on the gpu
+        size_t gpu_vertex_size_bytes() const { return quantized ? 4 * sizeof(short) + 4 * sizeof(char) : vertex_size_bytes(); }
+
+        // converts the vertices generated in this format into the quantized format,
+        // the quantization of the vbo with the given index is set accordingly
+        std::vector<unsigned char> quantize(const std::vector<float>& vertices, size_t vbo_id);
+        // enables the vertex and normal arrays of the given vbo, which must be bound as GL_ARRAY_BUFFER,
+        // quantized positions are decoded by pushing the proper transformation onto the modelview matrix
+        void enable_arrays(unsigned int vbo) const;
+        void disable_arrays(unsigned int vbo) const;
+        // position of the vertex with the given index, read back from the given vbo
+        Vec3f get_position(unsigned int vbo, size_t index) const;
+#endif // ENABLE_SPLITTED_VERTEX_BUFFER
 
         size_t position_offset_floats() const { return 0; }
         size_t position_offset_size() const { return position_offset_floats() * sizeof(float); }
@@ -368,6 +373,56 @@ class GCodeViewer
 #endif // ENABLE_SPLITTED_VERTEX_BUFFER
     };
 
+    // Initializes the non OpenGL data of the TBuffers, one per toolpath type.
+    static void init_buffers(std::vector<TBuffer>& buffers);
+#if ENABLE_SPLITTED_VERTEX_BUFFER
+    // Fills the paths of the given TBuffers and generates the vertices of the toolpaths, in parallel.
+    static void generate_vertices(const GCodeProcessor::Result& gcode_result, std::vector<TBuffer>& buffers,
+        std::vector<MultiVertexBuffer>& vertices, std::vector<float>& options_zs);
+    // Fills the paths of the given TBuffer and generates the indices of its toolpaths,
+    // vbuffer_ids receives the index of the vertex buffer referenced by each index buffer.
+    static void generate_indices(const GCodeProcessor::Result& gcode_result, unsigned char tbuffer_id, TBuffer& t_buffer,
+        MultiIndexBuffer& indices, std::vector<unsigned int>& vbuffer_ids);
+#endif // ENABLE_SPLITTED_VERTEX_BUFFER
+};
+
+class GCodeViewer
+{
+#if ENABLE_SPLITTED_VERTEX_BUFFER
+    using IBufferType = GCodeToolpaths::IBufferType;
+#endif // ENABLE_SPLITTED_VERTEX_BUFFER
+    using Color = GCodeToolpaths::Color;
+    using VertexBuffer = GCodeToolpaths::VertexBuffer;
+#if ENABLE_SPLITTED_VERTEX_BUFFER
+    using MultiVertexBuffer = GCodeToolpaths::MultiVertexBuffer;
+#endif // ENABLE_SPLITTED_VERTEX_BUFFER
+    using IndexBuffer = GCodeToolpaths::IndexBuffer;
+    using MultiIndexBuffer = GCodeToolpaths::MultiIndexBuffer;
+
+    std::vector<Color> Extrusion_Role_Colors;
+    static const std::vector<Color> Options_Colors;
+    static const std::vector<Color> Travel_Colors;
+    static const Color              Wipe_Color;
+    static const std::vector<Color> Range_Colors;
+
+    enum class EOptionsColors : unsigned char
+    {
+        Retractions,
+        Unretractions,
+        ToolChanges,
+        ColorChanges,
+        PausePrints,
+        CustomGCodes
+    };
+
+    using VBuffer = GCodeToolpaths::VBuffer;
+    using IBuffer = GCodeToolpaths::IBuffer;
+    using Path = GCodeToolpaths::Path;
+    using RenderPath = GCodeToolpaths::RenderPath;
+    using RenderPathPropertyLower = GCodeToolpaths::RenderPathPropertyLower;
+    using RenderPathPropertyEqual = GCodeToolpaths::RenderPathPropertyEqual;
+    using TBuffer = GCodeToolpaths::TBuffer;
+
     // helper to render shells
     struct Shells
     {
@@ -535,6 +590,7 @@ class GCodeViewer
         int64_t total_indices_gpu_size{ 0 };
         int64_t max_vbuffer_gpu_size{ 0 };
         int64_t max_ibuffer_gpu_size{ 0 };
+        int64_t quantization_saved_gpu_size{ 0 };
         int64_t paths_size{ 0 };
         int64_t render_paths_size{ 0 };
         // other
@@ -576,6 +632,7 @@ class GCodeViewer
             total_indices_gpu_size = 0;
             max_vbuffer_gpu_size = 0;
             max_ibuffer_gpu_size = 0;
+            quantization_saved_gpu_size = 0;
             paths_size = 0;
             render_paths_size = 0;
         }
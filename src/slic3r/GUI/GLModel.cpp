@@ -56,7 +56,7 @@ void GLModel::init_from(const TriangleMesh& mesh)
 
     unsigned int vertices_count = 0;
     for (uint32_t i = 0; i < mesh.stl.stats.number_of_facets; ++i) {
-        const stl_facet& facet = mesh.stl.facet_start[i];
+        const stl_facet facet = mesh.facet(i);
         for (uint32_t j = 0; j < 3; ++j) {
             uint32_t offset = i * 18 + j * 6;
             ::memcpy(static_cast<void*>(&vertices[offset]), static_cast<const void*>(facet.vertex[j].data()), 3 * sizeof(float));
@@ -279,10 +279,9 @@ void GLGizmoFdmSupports::select_facets_by_angle(float threshold_deg, bool block)
         float dot_limit = limit.dot(down);
 
         // Now calculate dot product of vert_direction and facets' normals.
-        int idx = -1;
-        for (const stl_facet& facet : mv->mesh().stl.facet_start) {
-            ++idx;
-            if (facet.normal.dot(down) > dot_limit)
+        const TriangleMesh &mesh = mv->mesh();
+        for (int idx = 0; idx < int(mesh.facets_count()); ++ idx) {
+            if (mesh.facet(idx).normal.dot(down) > dot_limit)
                 m_triangle_selectors[mesh_id]->set_facet(idx,
                                                          block
                                                          ? EnforcerBlockerType::BLOCKER
@@ -109,9 +109,9 @@ public:
     MeshRaycaster(const TriangleMesh& mesh)
         : m_emesh(mesh)
     {
-        m_normals.reserve(mesh.stl.facet_start.size());
-        for (const stl_facet& facet : mesh.stl.facet_start)
-            m_normals.push_back(facet.normal);
+        m_normals.reserve(mesh.facets_count());
+        for (size_t i = 0; i < mesh.facets_count(); ++ i)
+            m_normals.push_back(mesh.facet(i).normal);
     }
 
     void line_from_mouse_pos(const Vec2d& mouse_pos, const Transform3d& trafo, const Camera& camera,
@@ -14,6 +14,8 @@
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/convert.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <wx/sizer.h>
 #include <wx/stattext.h>
 #include <wx/button.h>
@@ -30,6 +32,7 @@
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/Format/OBJ.hpp"
 #include "libslic3r/Format/AMF.hpp"
 #include "libslic3r/Format/3mf.hpp"
 #include "libslic3r/GCode/ThumbnailData.hpp"
@@ -2381,6 +2384,36 @@ std::vector<size_t> Plater::priv::load_files(const std::vector<fs::path>& input_
     auto *new_model = (!load_model || one_by_one) ? nullptr : new Slic3r::Model();
     std::vector<size_t> obj_idxs;
 
+    // Read the STL and OBJ files, repair their meshes and calculate their convex hulls in parallel, as these are the most
+    // expensive steps of loading many simple geometry files. The model objects are created by the loop below,
+    // because the ObjectIDs may only be generated by the UI thread. A file failing to load here is read again by the loop,
+    // which reports the error.
+    struct LoadedMesh {
+        bool         loaded { false };
+        TriangleMesh mesh;
+        TriangleMesh convex_hull;
+    };
+    std::vector<LoadedMesh> loaded_meshes;
+    if (load_model && input_files.size() > 1) {
+        loaded_meshes.assign(input_files.size(), LoadedMesh());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, input_files.size()), [&input_files, &loaded_meshes](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                const std::string path   = input_files[i].string();
+                LoadedMesh       &loaded = loaded_meshes[i];
+                try {
+                    if (boost::algorithm::iends_with(path, ".stl"))
+                        loaded.loaded = load_stl(path.c_str(), &loaded.mesh);
+                    else if (boost::algorithm::iends_with(path, ".obj"))
+                        loaded.loaded = load_obj(path.c_str(), &loaded.mesh);
+                    if (loaded.loaded)
+                        loaded.convex_hull = loaded.mesh.convex_hull_3d();
+                } catch (const std::exception &) {
+                    loaded = LoadedMesh();
+                }
+            }
+        });
+    }
+
     for (size_t i = 0; i < input_files.size(); ++i) {
         const auto &path = input_files[i];
         const auto filename = path.filename();
@@ -2447,6 +2480,10 @@ std::vector<size_t> Plater::priv::load_files(const std::vector<fs::path>& input_
                         wxGetApp().app_config->update_config_dir(path.parent_path().string());
                 }
             }
+            else if (i < loaded_meshes.size() && loaded_meshes[i].loaded) {
+                LoadedMesh &loaded = loaded_meshes[i];
+                model.add_object(filename.string().c_str(), path.string().c_str(), std::move(loaded.mesh), std::move(loaded.convex_hull));
+            }
             else {
                 model = Slic3r::Model::read_from_file(path.string(), nullptr, nullptr, only_if(load_config, Model::LoadAttribute::CheckVersion));
                 for (auto obj : model.objects)
@@ -4668,7 +4705,7 @@ void Plater::priv::take_snapshot(const std::string& snapshot_name)
     this->undo_redo_stack().release_least_recently_used();
     // Save the last active preset name of a particular printer technology.
     ((this->printer_technology == ptFFF) ? m_last_fff_printer_profile_name : m_last_sla_printer_profile_name) = wxGetApp().preset_bundle->printers.get_selected_preset_name();
-    BOOST_LOG_TRIVIAL(info) << "Undo / Redo snapshot taken: " << snapshot_name << ", Undo / Redo stack memory: " << Slic3r::format_memsize_MB(this->undo_redo_stack().memsize()) << log_memory_info();
+    BOOST_LOG_TRIVIAL(info) << "Undo / Redo snapshot taken: " << snapshot_name << ", Undo / Redo stack memory: " << Slic3r::format_memsize_MB(this->undo_redo_stack().memsize()) << ", on disk: " << Slic3r::format_memsize_MB(this->undo_redo_stack().memsize_on_disk()) << log_memory_info();
 }
 
 void Plater::priv::undo()
@@ -4831,7 +4868,7 @@ void Plater::priv::update_after_undo_redo(const UndoRedo::Snapshot& snapshot, bo
     //FIXME what about the state of the manipulators?
     //FIXME what about the focus? Cursor in the side panel?
 
-    BOOST_LOG_TRIVIAL(info) << "Undo / Redo snapshot reloaded. Undo / Redo stack memory: " << Slic3r::format_memsize_MB(this->undo_redo_stack().memsize()) << log_memory_info();
+    BOOST_LOG_TRIVIAL(info) << "Undo / Redo snapshot reloaded. Undo / Redo stack memory: " << Slic3r::format_memsize_MB(this->undo_redo_stack().memsize()) << ", on disk: " << Slic3r::format_memsize_MB(this->undo_redo_stack().memsize_on_disk()) << log_memory_info();
 }
 
 void Plater::priv::bring_instance_forward() const
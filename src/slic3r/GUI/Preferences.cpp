@@ -420,6 +420,14 @@ void PreferencesDialog::build()
 	option = Option(def, "seq_top_layer_only");
 	m_optgroup_gui->append_single_option_line(option);
 
+	def.label = L("Compact G-code preview");
+	def.type = coBool;
+	def.tooltip = L("If enabled, the toolpaths of the G-code preview are stored with quantized positions and normals, "
+					"halving their graphic memory. Applied when the G-code preview is loaded again.");
+	def.set_default_value(new ConfigOptionBool{ app_config->get("gcode_preview_quantized") == "1" });
+	option = Option(def, "gcode_preview_quantized");
+	m_optgroup_gui->append_single_option_line(option);
+
 	if (is_editor) {
 		def.label = L("Show sidebar collapse/expand button");
 		def.type = coBool;
@@ -2854,6 +2854,9 @@ void TabPrinter::toggle_options()
     field = get_field("thumbnails_color");
     if (field) field->toggle(custom_color);
 
+    field = get_field("arc_fitting_tolerance");
+    if (field) field->toggle(m_config->opt_bool("arc_fitting"));
+
     bool is_marlin_flavor = m_config->option<ConfigOptionEnum<GCodeFlavor>>("gcode_flavor")->value == gcfMarlin;
     // Disable silent mode for non-marlin firmwares.
     field = get_field("silent_mode");
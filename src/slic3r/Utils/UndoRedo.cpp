@@ -22,6 +22,17 @@
 #include <libslic3r/Utils.hpp>
 
 #include <boost/foreach.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <miniz.h>
+
+#include <atomic>
+#include <chrono>
+
+#include <tbb/task_group.h>
+#include <tbb/task_scheduler_init.h>
 
 #ifndef NDEBUG
 // #define SLIC3R_UNDOREDO_DEBUG
@@ -56,6 +67,98 @@ bool Snapshot::is_topmost() const
 	return this->name == topmost_snapshot_name;
 }
 
+// Serialized immutable objects are compressed with a fast compression level, the uncompressed size is stored first.
+static std::string compress_serialized(const std::string &data)
+{
+	uint64_t  size_uncompressed = data.size();
+	mz_ulong  size_compressed   = mz_compressBound(mz_ulong(data.size()));
+	std::string out(sizeof(uint64_t) + size_compressed, 0);
+	memcpy(out.data(), &size_uncompressed, sizeof(uint64_t));
+	if (mz_compress2((unsigned char*)out.data() + sizeof(uint64_t), &size_compressed, (const unsigned char*)data.data(), mz_ulong(data.size()), MZ_BEST_SPEED) != MZ_OK)
+		return std::string();
+	out.resize(sizeof(uint64_t) + size_compressed);
+	out.shrink_to_fit();
+	return out;
+}
+
+static std::string decompress_serialized(const std::string &data)
+{
+	uint64_t size_uncompressed = 0;
+	assert(data.size() > sizeof(uint64_t));
+	memcpy(&size_uncompressed, data.data(), sizeof(uint64_t));
+	std::string out(size_uncompressed, 0);
+	mz_ulong size = mz_ulong(size_uncompressed);
+	if (mz_uncompress((unsigned char*)out.data(), &size, (const unsigned char*)data.data() + sizeof(uint64_t), mz_ulong(data.size() - sizeof(uint64_t))) != MZ_OK || size != size_uncompressed)
+		throw Slic3r::RuntimeError("Undo / Redo stack: Failed to decompress a snapshot");
+	return out;
+}
+
+// Temporary file, to which the least recently used serialized objects are moved if the Undo / Redo stack grows over its memory limit.
+// The data is only ever appended, the file is deleted once none of the data stored there is referenced anymore.
+class SpillFile
+{
+public:
+	~SpillFile() { this->close(); }
+
+	// Append data to the file, return its offset. Throws Slic3r::RuntimeError on failure.
+	size_t write(const std::string &data) {
+		if (! m_file.is_open()) {
+			m_path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("slic3r_undo_redo_%%%%-%%%%-%%%%-%%%%.bin");
+			m_file.open(m_path.string(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			m_end = 0;
+		}
+		m_file.seekp(std::streamoff(m_end));
+		m_file.write(data.data(), std::streamsize(data.size()));
+		m_file.flush();
+		if (! m_file.good()) {
+			m_file.clear();
+			throw Slic3r::RuntimeError("Undo / Redo stack: Failed to write to " + m_path.string());
+		}
+		size_t offset = m_end;
+		m_end  += data.size();
+		m_live += data.size();
+		return offset;
+	}
+
+	std::string read(size_t offset, size_t size) {
+		std::string out(size, 0);
+		m_file.seekg(std::streamoff(offset));
+		m_file.read(out.data(), std::streamsize(size));
+		if (! m_file.good()) {
+			m_file.clear();
+			throw Slic3r::RuntimeError("Undo / Redo stack: Failed to read from " + m_path.string());
+		}
+		return out;
+	}
+
+	// The data of the given size stored in the file is not referenced anymore.
+	void   release(size_t size) {
+		assert(m_live >= size);
+		m_live -= size;
+		if (m_live == 0)
+			this->close();
+	}
+
+	// Size of the data referenced in the file.
+	size_t memsize_on_disk() const { return m_live; }
+
+private:
+	void   close() {
+		if (m_file.is_open()) {
+			m_file.close();
+			boost::system::error_code ec;
+			boost::filesystem::remove(m_path, ec);
+		}
+		m_end  = 0;
+		m_live = 0;
+	}
+
+	boost::filesystem::path m_path;
+	boost::nowide::fstream  m_file;
+	size_t                  m_end  { 0 };
+	size_t                  m_live { 0 };
+};
+
 // Time interval, start is closed, end is open.
 struct Interval
 {
@@ -113,6 +216,20 @@ public:
 	// Restore optional data possibly released by release_optional.
 	virtual void   restore_optional() = 0;
 
+	// Start compressing the object on a background thread if it is referenced by the Undo / Redo stack only.
+	// Returns true if the compression was started.
+	virtual bool   compress_async() { return false; }
+	// Is the background compression running?
+	virtual bool   compressing() const { return false; }
+	// Take over the result of the background compression, releasing the object. If wait, then block until the compression finishes.
+	// Returns the pointer of the released object, so that the Undo / Redo stack may forget its temporary ObjectID,
+	// and the amount of memory released.
+	virtual const void* compress_finalize(bool /* wait */, size_t & /* mem_released */) { return nullptr; }
+	// Move the compressed data into the spill file. Returns the amount of memory released.
+	virtual size_t spill() { return 0; }
+	// Time of the last snapshot this history is active in, to spill the least recently used data first.
+	virtual size_t last_used() const = 0;
+
 	// Estimated size in memory, to be used to drop least recently used snapshots.
 	virtual size_t memsize() const = 0;
 
@@ -134,6 +251,8 @@ public:
 	// If the history is empty, the ObjectHistory object could be released.
 	bool empty() override { return m_history.empty(); }
 
+	size_t last_used() const override { return m_history.empty() ? 0 : m_history.back().end(); }
+
 	// Release all data before the given timestamp. For the ImmutableObjectHistory, the shared pointer is NOT released.
 	size_t release_before_timestamp(size_t timestamp) override {
 		size_t mem_released = 0;
@@ -196,14 +315,17 @@ protected:
 // at the Undo / Redo stack. Once the reference counter drops to 1 (only the Undo / Redo
 // stack holds the reference), the shared pointer may get serialized (and possibly compressed)
 // and the shared pointer may be released.
+// The object is serialized and compressed on a background thread, and the compressed data of the least
+// recently used objects may be moved to a temporary file if the Undo / Redo stack grows over its memory limit.
 // The history of a single immutable object may not be continuous, as an immutable object may
 // be removed from the scene while being kept at the Copy / Paste stack.
 template<typename T>
 class ImmutableObjectHistory : public ObjectHistory<Interval>
 {
 public:
-	ImmutableObjectHistory(std::shared_ptr<const T>	shared_object, bool optional) : m_shared_object(shared_object), m_optional(optional) {}
-	~ImmutableObjectHistory() override {}
+	ImmutableObjectHistory(std::shared_ptr<const T>	shared_object, bool optional, std::shared_ptr<SpillFile> spill_file) :
+		m_shared_object(shared_object), m_optional(optional), m_spill_file(spill_file) {}
+	~ImmutableObjectHistory() override { this->compress_cancel(); this->release_serialized(); }
 
 	bool is_mutable() const override { return false; }
 	bool is_immutable() const override { return true; }
@@ -252,7 +374,7 @@ public:
 			bool released = false;
 			if (this->is_serialized()) {
 				mem_released += m_serialized.size();
-				m_serialized.clear();
+				this->release_serialized();
 				released = true;
 			} else if (m_shared_object.use_count() == 1) {
 				mem_released += m_shared_object->memsize();
@@ -263,7 +385,7 @@ public:
 				mem_released += m_history.size() * sizeof(Interval);
 				m_history.clear();
 			}
-		} else if (m_shared_object.use_count() == 1) {
+		} else if (m_shared_object.use_count() == 1 && ! this->compressing()) {
 			// The object is in memory, but it is not shared with the scene. Let the object decide whether there is any optional data to release.
 			const_cast<T*>(m_shared_object.get())->release_optional();
 		}
@@ -272,19 +394,75 @@ public:
 
 	// Restore optional data possibly released by this->release_optional().
 	void restore_optional() override {
+		// The object is about to be modified, it must not be read by the background compression.
+		this->compress_cancel();
 		if (m_shared_object.use_count() == 1)
 			const_cast<T*>(m_shared_object.get())->restore_optional();
 	}
 
+	bool compress_async() override {
+		if (m_optional || ! m_shared_object || m_shared_object.use_count() > 1 || this->compressing())
+			return false;
+		const T     *object      = m_shared_object.get();
+		Compression *compression = new Compression();
+		m_compression.reset(compression);
+		compression->group.run([object, compression]() {
+			std::ostringstream oss;
+			{
+				// The immutable objects do not reference other objects stored at the Undo / Redo stack,
+				// thus they are serialized without the StackImpl user data.
+				cereal::BinaryOutputArchive archive(oss);
+				archive(*object);
+			}
+			compression->result = compress_serialized(oss.str());
+			compression->done   = true;
+		});
+		return true;
+	}
+
+	bool compressing() const override { return m_compression != nullptr; }
+
+	const void* compress_finalize(bool wait, size_t &mem_released) override {
+		if (! this->compressing() || (! wait && ! m_compression->done))
+			return nullptr;
+		m_compression->group.wait();
+		std::string data = std::move(m_compression->result);
+		m_compression.reset();
+		if (data.empty() || m_shared_object.use_count() > 1)
+			// Compression failed, or the object was picked up by the scene in the meantime.
+			return nullptr;
+		const void *ptr = m_shared_object.get();
+		size_t      mem = m_shared_object->memsize();
+		m_shared_object.reset();
+		m_serialized = std::move(data);
+		mem_released += mem > m_serialized.size() ? mem - m_serialized.size() : 0;
+		return ptr;
+	}
+
+	size_t spill() override {
+		if (m_serialized.empty())
+			return 0;
+		try {
+			m_spill_offset = m_spill_file->write(m_serialized);
+		} catch (const Slic3r::RuntimeError &ex) {
+			BOOST_LOG_TRIVIAL(error) << ex.what();
+			return 0;
+		}
+		m_spill_size = m_serialized.size();
+		std::string().swap(m_serialized);
+		return m_spill_size;
+	}
+
 	bool 						is_serialized() const { return m_shared_object.get() == nullptr; }
+	bool 						is_spilled() const { return m_spill_size > 0; }
 	const std::string&			serialized_data() const { return m_serialized; }
 	std::shared_ptr<const T>& 	shared_ptr(StackImpl &stack);
 
 #ifdef SLIC3R_UNDOREDO_DEBUG
 	std::string 				format() override {
 		std::string out = typeid(T).name();
-		out += this->is_serialized() ? 
-			std::string(" len:") + std::to_string(m_serialized.size()) : 
+		out += this->is_serialized() ?
+			(this->is_spilled() ? std::string(" spilled:") + std::to_string(m_spill_size) : std::string(" len:") + std::to_string(m_serialized.size())) :
 			std::string(" shared_ptr:") + ptr_to_string(m_shared_object.get());
 		for (const Interval &interval : m_history)
 			out += std::string(", <") + std::to_string(interval.begin()) + "," + std::to_string(interval.end()) + ")";
@@ -297,12 +475,39 @@ public:
 #endif /* NDEBUG */
 
 private:
+	// Wait for the background compression to finish and throw its result away.
+	void 						compress_cancel() {
+		if (this->compressing()) {
+			m_compression->group.wait();
+			m_compression.reset();
+		}
+	}
+	// Release the compressed data both from memory and from the spill file.
+	void 						release_serialized() {
+		std::string().swap(m_serialized);
+		if (this->is_spilled()) {
+			m_spill_file->release(m_spill_size);
+			m_spill_size = 0;
+		}
+	}
+
 	// Either the source object is held by a shared pointer and the m_serialized field is empty,
-	// or the shared pointer is null and the object is being serialized into m_serialized.
+	// or the shared pointer is null and the object is serialized and compressed into m_serialized,
+	// or the shared pointer is null and the compressed object is stored in the spill file.
 	std::shared_ptr<const T>	m_shared_object;
 	// If this object is optional, then it may be deleted from the Undo / Redo stack and recalculated from other data (for example mesh convex hull).
 	bool 						m_optional;
 	std::string 				m_serialized;
+	std::shared_ptr<SpillFile>	m_spill_file;
+	size_t 						m_spill_offset { 0 };
+	size_t 						m_spill_size   { 0 };
+	// Background compression of m_shared_object, executed by the TBB worker threads.
+	struct Compression {
+		tbb::task_group 		group;
+		std::atomic<bool> 		done { false };
+		std::string 			result;
+	};
+	std::unique_ptr<Compression> m_compression;
 };
 
 struct MutableHistoryInterval
@@ -480,7 +685,8 @@ template<typename T>
 bool ImmutableObjectHistory<T>::valid()
 {
 	// The immutable object content is captured either by a shared object, or by its serialization, but not both.
-	assert(! m_shared_object == ! m_serialized.empty());
+	assert(! m_shared_object == (! m_serialized.empty() || this->is_spilled()));
+	assert(m_serialized.empty() || ! this->is_spilled());
 	// Verify that the history intervals are sorted and do not overlap.
 	if (! m_history.empty())
 		for (size_t i = 1; i < m_history.size(); ++ i)
@@ -516,7 +722,8 @@ class StackImpl
 public:
 	// Stack needs to be initialized. An empty stack is not valid, there must be a "New Project" status stored at the beginning.
 	// Initially enable Undo / Redo stack to occupy maximum 10% of the total system physical memory.
-	StackImpl() : m_memory_limit(std::min(Slic3r::total_physical_memory() / 10, size_t(1 * 16384 * 65536 / UNDO_REDO_DEBUG_LOW_MEM_FACTOR))), m_active_snapshot_time(0), m_current_time(0) {}
+	StackImpl() : m_memory_limit(std::min(Slic3r::total_physical_memory() / 10, size_t(1 * 16384 * 65536 / UNDO_REDO_DEBUG_LOW_MEM_FACTOR))), m_active_snapshot_time(0), m_current_time(0),
+		m_spill_file(std::make_shared<SpillFile>()) {}
 
 	void clear() {
 		m_objects.clear();
@@ -542,16 +749,21 @@ public:
 			memsize += object.second->memsize();
 		return memsize;
 	}
+	size_t memsize_on_disk() const { return m_spill_file->memsize_on_disk(); }
+
+	// Called by ImmutableObjectHistory when an object is being deserialized, to report the Undo / Redo latency.
+	void   on_object_deserialized(bool from_disk) { ++ (from_disk ? m_num_reloaded : m_num_decompressed); }
 
     // Store the current application state onto the Undo / Redo stack, remove all snapshots after m_active_snapshot_time.
-    void take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager& gizmos, const SnapshotData &snapshot_data);
-    void load_snapshot(size_t timestamp, Slic3r::Model& model, Slic3r::GUI::GLGizmosManager& gizmos);
+    // The gizmos are optional, they are neither saved nor loaded if gizmos == nullptr.
+    void take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager* gizmos, const SnapshotData &snapshot_data);
+    void load_snapshot(size_t timestamp, Slic3r::Model& model, Slic3r::GUI::GLGizmosManager* gizmos);
 
 	bool has_undo_snapshot() const;
 	bool has_undo_snapshot(size_t time_to_load) const;
 	bool has_redo_snapshot() const;
-    bool undo(Slic3r::Model &model, const Slic3r::GUI::Selection &selection, Slic3r::GUI::GLGizmosManager &gizmos, const SnapshotData &snapshot_data, size_t jump_to_time);
-    bool redo(Slic3r::Model &model, Slic3r::GUI::GLGizmosManager &gizmos, size_t jump_to_time);
+    bool undo(Slic3r::Model &model, const Slic3r::GUI::Selection &selection, Slic3r::GUI::GLGizmosManager *gizmos, const SnapshotData &snapshot_data, size_t jump_to_time);
+    bool redo(Slic3r::Model &model, Slic3r::GUI::GLGizmosManager *gizmos, size_t jump_to_time);
 	void release_least_recently_used();
 
 	// Snapshot history (names with timestamps).
@@ -621,6 +833,7 @@ private:
 		return it->second;
 	}
 	void 							collect_garbage();
+	size_t 							compress_finalize(bool wait);
 
 	// Maximum memory allowed to be occupied by the Undo / Redo stack. If the limit is exceeded,
 	// least recently used snapshots will be released.
@@ -638,6 +851,11 @@ private:
 	size_t 													m_current_time;
 	// Last selection serialized or deserialized.
 	Selection 												m_selection;
+	// Compressed immutable objects moved out of memory.
+	std::shared_ptr<SpillFile> 								m_spill_file;
+	// Number of immutable objects decompressed from memory / reloaded from the spill file by the last load_snapshot().
+	size_t 													m_num_decompressed { 0 };
+	size_t 													m_num_reloaded     { 0 };
 };
 
 using InputArchive  = cereal::UserDataAdapter<StackImpl, cereal::BinaryInputArchive>;
@@ -755,9 +973,14 @@ namespace UndoRedo {
 
 template<typename T> std::shared_ptr<const T>& 	ImmutableObjectHistory<T>::shared_ptr(StackImpl &stack)
 {
-	if (m_shared_object.get() == nullptr && ! this->m_serialized.empty()) {
+	// The object is being handed over to the scene, the result of the compression would not be used.
+	this->compress_cancel();
+	if (m_shared_object.get() == nullptr && (! this->m_serialized.empty() || this->is_spilled())) {
 		// Deserialize the object.
-		std::istringstream iss(m_serialized);
+		stack.on_object_deserialized(this->is_spilled());
+		std::istringstream iss(decompress_serialized(this->is_spilled() ? m_spill_file->read(m_spill_offset, m_spill_size) : m_serialized));
+		// From now on the object will be held by the shared pointer.
+		this->release_serialized();
 		{
 			Slic3r::UndoRedo::InputArchive archive(stack, iss);
 			typedef typename std::remove_const<T>::type Type;
@@ -803,7 +1026,7 @@ template<typename T> ObjectID StackImpl::save_immutable_object(std::shared_ptr<c
 	// and find or allocate a history stack for the ObjectID associated to this shared_ptr.
 	auto it_object_history = m_objects.find(object_id);
 	if (it_object_history == m_objects.end())
-		it_object_history = m_objects.emplace_hint(it_object_history, object_id, std::unique_ptr<ImmutableObjectHistory<T>>(new ImmutableObjectHistory<T>(object, optional)));
+		it_object_history = m_objects.emplace_hint(it_object_history, object_id, std::unique_ptr<ImmutableObjectHistory<T>>(new ImmutableObjectHistory<T>(object, optional, m_spill_file)));
 	else
 		assert(it_object_history->second.get()->is_optional() == optional);
 	// Then save the interval.
@@ -828,7 +1051,11 @@ template<typename T> std::shared_ptr<const T> StackImpl::load_immutable_object(c
 	auto *object_history = static_cast<ImmutableObjectHistory<T>*>(it_object_history->second.get());
 	assert(object_history->has_snapshot(m_active_snapshot_time));
 	object_history->restore_optional();
-	return object_history->shared_ptr(*this);
+	std::shared_ptr<const T> &ptr = object_history->shared_ptr(*this);
+	if (ptr)
+		// The object may have been deserialized into a new memory location, let the next snapshot find its history.
+		m_shared_ptr_to_object_id[ptr.get()] = id;
+	return ptr;
 }
 
 template<typename T> void StackImpl::load_mutable_object(const Slic3r::ObjectID id, T &target)
@@ -845,7 +1072,7 @@ template<typename T> void StackImpl::load_mutable_object(const Slic3r::ObjectID
 }
 
 // Store the current application state onto the Undo / Redo stack, remove all snapshots after m_active_snapshot_time.
-void StackImpl::take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager& gizmos, const SnapshotData &snapshot_data)
+void StackImpl::take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager* gizmos, const SnapshotData &snapshot_data)
 {
 	// Release old snapshot data.
 	assert(m_active_snapshot_time <= m_current_time);
@@ -856,6 +1083,8 @@ void StackImpl::take_snapshot(const std::string& snapshot_name, const Slic3r::Mo
 		m_snapshots.erase(it, m_snapshots.end());
 	}
 	// Take new snapshots.
+	auto   time_start     = std::chrono::steady_clock::now();
+	size_t memsize_before = this->memsize();
 	this->save_mutable_object<Slic3r::Model>(model);
 	m_selection.volumes_and_instances.clear();
 	m_selection.volumes_and_instances.reserve(selection.get_volume_idxs().size());
@@ -863,7 +1092,8 @@ void StackImpl::take_snapshot(const std::string& snapshot_name, const Slic3r::Mo
 	for (unsigned int volume_idx : selection.get_volume_idxs())
 		m_selection.volumes_and_instances.emplace_back(selection.get_volume(volume_idx)->geometry_id);
 	this->save_mutable_object<Selection>(m_selection);
-    this->save_mutable_object<Slic3r::GUI::GLGizmosManager>(gizmos);
+    if (gizmos != nullptr)
+        this->save_mutable_object<Slic3r::GUI::GLGizmosManager>(*gizmos);
     // Save the snapshot info.
 	m_snapshots.emplace_back(snapshot_name, m_current_time ++, model.id().id, snapshot_data);
 	m_active_snapshot_time = m_current_time;
@@ -873,19 +1103,26 @@ void StackImpl::take_snapshot(const std::string& snapshot_name, const Slic3r::Mo
 	// Release empty objects from the history.
 	this->collect_garbage();
 	assert(this->valid());
+	size_t memsize_after = this->memsize();
+	BOOST_LOG_TRIVIAL(debug) << "Undo / Redo snapshot \"" << snapshot_name << "\" taken in " <<
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count() << "ms, snapshot memory: " <<
+		Slic3r::format_memsize_MB(memsize_after > memsize_before ? memsize_after - memsize_before : 0);
 #ifdef SLIC3R_UNDOREDO_DEBUG
 	std::cout << "After snapshot" << std::endl;
 	this->print();
 #endif /* SLIC3R_UNDOREDO_DEBUG */
 }
 
-void StackImpl::load_snapshot(size_t timestamp, Slic3r::Model& model, Slic3r::GUI::GLGizmosManager& gizmos)
+void StackImpl::load_snapshot(size_t timestamp, Slic3r::Model& model, Slic3r::GUI::GLGizmosManager* gizmos)
 {
 	// Find the snapshot by time. It must exist.
 	const auto it_snapshot = std::lower_bound(m_snapshots.begin(), m_snapshots.end(), Snapshot(timestamp));
 	if (it_snapshot == m_snapshots.end() || it_snapshot->timestamp != timestamp)
 		throw Slic3r::RuntimeError((boost::format("Snapshot with timestamp %1% does not exist") % timestamp).str());
 
+	auto time_start    = std::chrono::steady_clock::now();
+	m_num_decompressed = 0;
+	m_num_reloaded     = 0;
 	m_active_snapshot_time = timestamp;
 	model.clear_objects();
 	model.clear_materials();
@@ -894,11 +1131,15 @@ void StackImpl::load_snapshot(size_t timestamp, Slic3r::Model& model, Slic3r::GU
 	m_selection.volumes_and_instances.clear();
 	this->load_mutable_object<Selection>(m_selection.id(), m_selection);
     //gizmos.reset_all_states(); FIXME: is this really necessary? It is quite unpleasant for the gizmo undo/redo substack
-    this->load_mutable_object<Slic3r::GUI::GLGizmosManager>(gizmos.id(), gizmos);
+    if (gizmos != nullptr)
+        this->load_mutable_object<Slic3r::GUI::GLGizmosManager>(gizmos->id(), *gizmos);
     // Sort the volumes so that we may use binary search.
 	std::sort(m_selection.volumes_and_instances.begin(), m_selection.volumes_and_instances.end());
 	this->m_active_snapshot_time = timestamp;
 	assert(this->valid());
+	BOOST_LOG_TRIVIAL(info) << "Undo / Redo snapshot \"" << it_snapshot->name << "\" loaded in " <<
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count() << "ms, objects decompressed: " <<
+		m_num_decompressed << ", objects reloaded from disk: " << m_num_reloaded;
 }
 
 bool StackImpl::has_undo_snapshot() const
@@ -920,7 +1161,7 @@ bool StackImpl::has_redo_snapshot() const
 	return ++ it != m_snapshots.end();
 }
 
-bool StackImpl::undo(Slic3r::Model &model, const Slic3r::GUI::Selection &selection, Slic3r::GUI::GLGizmosManager &gizmos, const SnapshotData &snapshot_data, size_t time_to_load)
+bool StackImpl::undo(Slic3r::Model &model, const Slic3r::GUI::Selection &selection, Slic3r::GUI::GLGizmosManager *gizmos, const SnapshotData &snapshot_data, size_t time_to_load)
 {
 	assert(this->valid());
 	if (time_to_load == SIZE_MAX) {
@@ -960,7 +1201,7 @@ bool StackImpl::undo(Slic3r::Model &model, const Slic3r::GUI::Selection &selecti
 	return true;
 }
 
-bool StackImpl::redo(Slic3r::Model& model, Slic3r::GUI::GLGizmosManager& gizmos, size_t time_to_load)
+bool StackImpl::redo(Slic3r::Model& model, Slic3r::GUI::GLGizmosManager* gizmos, size_t time_to_load)
 {
 	assert(this->valid());
 	if (time_to_load == SIZE_MAX) {
@@ -993,14 +1234,41 @@ void StackImpl::collect_garbage()
 	}
 }
 
+// Take over the results of the background compressions, forget the temporary ObjectIDs of the released objects.
+// Returns the amount of memory released.
+size_t StackImpl::compress_finalize(bool wait)
+{
+	size_t mem_released = 0;
+	for (auto &kvp : m_objects)
+		if (const void *ptr = kvp.second->compress_finalize(wait, mem_released))
+			// The memory of the released object may be reused by another object, which must receive a new ObjectID.
+			m_shared_ptr_to_object_id.erase(ptr);
+	return mem_released;
+}
+
 void StackImpl::release_least_recently_used()
 {
 	assert(this->valid());
-	size_t current_memsize = this->memsize();
 #ifdef SLIC3R_UNDOREDO_DEBUG
 	bool released = false;
 #endif
-	// First try to release the optional immutable data (for example the convex hulls),
+	// Take over the objects compressed in the background since the last call, even if the stack dropped below
+	// the compression threshold in the meantime, so that the uncompressed data is not kept around.
+	this->compress_finalize(false);
+	size_t current_memsize = this->memsize();
+	// Only compress if the stack gets close to its memory limit, as the decompression on undo / redo is not free.
+	if (current_memsize > m_memory_limit - m_memory_limit / 4) {
+		// Compress the immutable objects, which are referenced by the Undo / Redo stack only, in the background.
+		size_t num_compressing = std::count_if(m_objects.begin(), m_objects.end(), [](const auto &kvp) { return kvp.second->compressing(); });
+		size_t max_compressing = size_t(std::max(1, tbb::task_scheduler_init::default_num_threads()));
+		for (auto it = m_objects.begin(); num_compressing < max_compressing && it != m_objects.end(); ++ it)
+			if (it->second->compress_async())
+				++ num_compressing;
+		if (current_memsize > m_memory_limit)
+			// The compression is the cheapest way to save memory, wait for the running compressions.
+			current_memsize -= std::min(current_memsize, this->compress_finalize(true));
+	}
+	// Then try to release the optional immutable data (for example the convex hulls),
 	// or the shared vertices of triangle meshes.
 	for (auto it = m_objects.begin(); current_memsize > m_memory_limit && it != m_objects.end();) {
 		const void *ptr = it->second->immutable_object_ptr();
@@ -1019,6 +1287,16 @@ void StackImpl::release_least_recently_used()
 		else
 			current_memsize = 0;
 	}
+	if (current_memsize > m_memory_limit) {
+		// Move the compressed data of the least recently used objects to the spill file.
+		std::vector<ObjectHistoryBase*> histories;
+		histories.reserve(m_objects.size());
+		for (auto &kvp : m_objects)
+			histories.emplace_back(kvp.second.get());
+		std::sort(histories.begin(), histories.end(), [](const ObjectHistoryBase *l, const ObjectHistoryBase *r) { return l->last_used() < r->last_used(); });
+		for (auto it = histories.begin(); current_memsize > m_memory_limit && it != histories.end(); ++ it)
+			current_memsize -= std::min(current_memsize, (*it)->spill());
+	}
 	while (current_memsize > m_memory_limit && m_snapshots.size() >= 3) {
 		// From which side to remove a snapshot?
 		assert(m_snapshots.front().timestamp < m_active_snapshot_time);
@@ -1085,15 +1363,21 @@ bool Stack::empty() const { return pimpl->empty(); }
 void Stack::set_memory_limit(size_t memsize) { pimpl->set_memory_limit(memsize); }
 size_t Stack::get_memory_limit() const { return pimpl->get_memory_limit(); }
 size_t Stack::memsize() const { return pimpl->memsize(); }
+size_t Stack::memsize_on_disk() const { return pimpl->memsize_on_disk(); }
 void Stack::release_least_recently_used() { pimpl->release_least_recently_used(); }
 void Stack::take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager& gizmos, const SnapshotData &snapshot_data)
-	{ pimpl->take_snapshot(snapshot_name, model, selection, gizmos, snapshot_data); }
+	{ pimpl->take_snapshot(snapshot_name, model, selection, &gizmos, snapshot_data); }
+void Stack::take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const SnapshotData &snapshot_data)
+	{ pimpl->take_snapshot(snapshot_name, model, selection, nullptr, snapshot_data); }
 bool Stack::has_undo_snapshot() const { return pimpl->has_undo_snapshot(); }
 bool Stack::has_undo_snapshot(size_t time_to_load) const { return pimpl->has_undo_snapshot(time_to_load); }
 bool Stack::has_redo_snapshot() const { return pimpl->has_redo_snapshot(); }
 bool Stack::undo(Slic3r::Model& model, const Slic3r::GUI::Selection& selection, Slic3r::GUI::GLGizmosManager& gizmos, const SnapshotData &snapshot_data, size_t time_to_load)
-	{ return pimpl->undo(model, selection, gizmos, snapshot_data, time_to_load); }
-bool Stack::redo(Slic3r::Model& model, Slic3r::GUI::GLGizmosManager& gizmos, size_t time_to_load) { return pimpl->redo(model, gizmos, time_to_load); }
+	{ return pimpl->undo(model, selection, &gizmos, snapshot_data, time_to_load); }
+bool Stack::undo(Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const SnapshotData &snapshot_data, size_t time_to_load)
+	{ return pimpl->undo(model, selection, nullptr, snapshot_data, time_to_load); }
+bool Stack::redo(Slic3r::Model& model, Slic3r::GUI::GLGizmosManager& gizmos, size_t time_to_load) { return pimpl->redo(model, &gizmos, time_to_load); }
+bool Stack::redo(Slic3r::Model& model, size_t time_to_load) { return pimpl->redo(model, nullptr, time_to_load); }
 const Selection& Stack::selection_deserialized() const { return pimpl->selection_deserialized(); }
 
 const std::vector<Snapshot>& Stack::snapshots() const { return pimpl->snapshots(); }
@@ -2,6 +2,7 @@
 
 #include <numeric>
 #include <sstream>
+#include <thread>
 
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Fill/Fill.hpp"
@@ -190,6 +191,46 @@ TEST_CASE("Fill: Pattern Path Length", "[Fill]") {
     }
 }
 
+TEST_CASE("Fill: Gyroid waves are confined to the region", "[Fill]") {
+    std::unique_ptr<Slic3r::Fill> filler(Slic3r::Fill::new_from_type(ipGyroid));
+    FillParams fill_params;
+    fill_params.density = 0.15f;
+    filler->z = 1.2;
+    filler->init_spacing(0.45, fill_params);
+
+    // A thin diagonal band, most of its bounding box is outside of it.
+    Slic3r::ExPolygon band(Slic3r::Points{
+        Point::new_scale(0, 0), Point::new_scale(10, 0), Point::new_scale(100, 90),
+        Point::new_scale(100, 100), Point::new_scale(90, 100), Point::new_scale(0, 10) });
+    Slic3r::Surface surface(SurfaceType::stPosInternal | SurfaceType::stDensSparse, band);
+
+    Polylines paths = filler->fill_surface(&surface, fill_params);
+    REQUIRE(! paths.empty());
+    REQUIRE(diff_pl(paths, offset(band, float(SCALED_EPSILON * 10))).empty());
+
+    // The wave periods are cached per thread. A new thread starts with an empty cache,
+    // thus it fills the surface with freshly calculated wave periods.
+    auto fill_uncached = [&filler, &fill_params](const Slic3r::Surface &surface) {
+        Polylines out;
+        std::thread([&]() { out = filler->fill_surface(&surface, fill_params); }).join();
+        return out;
+    };
+
+    // The second fill of the same layer uses the cached wave periods.
+    REQUIRE(filler->fill_surface(&surface, fill_params) == paths);
+    REQUIRE(fill_uncached(surface) == paths);
+
+    // Another region of the same layer reuses the periods cached for the band.
+    Slic3r::ExPolygon square(Slic3r::Points{
+        Point::new_scale(20, 50), Point::new_scale(60, 50), Point::new_scale(60, 90), Point::new_scale(20, 90) });
+    Slic3r::Surface surface2(SurfaceType::stPosInternal | SurfaceType::stDensSparse, square);
+    Polylines paths2 = filler->fill_surface(&surface2, fill_params);
+    REQUIRE(! paths2.empty());
+    REQUIRE(paths2 == fill_uncached(surface2));
+    // And the band is still filled the same after the other region.
+    REQUIRE(filler->fill_surface(&surface, fill_params) == paths);
+}
+
 /*
 {
     my $collection = Slic3r::Polyline::Collection->new(
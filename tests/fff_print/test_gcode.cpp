@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCode/ArcFitter.hpp"
 
 using namespace Slic3r;
 
@@ -20,3 +21,63 @@ SCENARIO("Origin manipulation", "[GCode]") {
     	}
     }
 }
+
+SCENARIO("Arc fitting", "[GCode]") {
+    GIVEN("Three quarters of a circle of radius 10mm sampled with 100 points") {
+        Points points;
+        for (size_t i = 0; i < 100; ++ i) {
+            double angle = 1.5 * PI * double(i) / 99.;
+            points.emplace_back(scaled<double>(10. * cos(angle)), scaled<double>(10. * sin(angle)));
+        }
+        std::vector<ArcSegment> segments = arc_fit(points, scaled<double>(0.01));
+        THEN("It is replaced by a single counter-clockwise arc") {
+            REQUIRE(segments.size() == 1);
+            REQUIRE(segments.front().end_point_idx == 99);
+            REQUIRE(segments.front().orientation == 1);
+            REQUIRE(unscaled(segments.front().center.norm()) < 0.01);
+            REQUIRE(unscaled(segments.front().length) == Approx(1.5 * PI * 10.).epsilon(1e-4));
+            REQUIRE(arc_length(unscaled(Vec2d(points.back().cast<double>() - points.front().cast<double>())),
+                unscaled(Vec2d(segments.front().center - points.front().cast<double>())), true) == Approx(1.5 * PI * 10.).epsilon(1e-4));
+        }
+        THEN("The reversed polyline is fitted by a clockwise arc") {
+            std::reverse(points.begin(), points.end());
+            segments = arc_fit(points, scaled<double>(0.01));
+            REQUIRE(segments.size() == 1);
+            REQUIRE(segments.front().orientation == -1);
+        }
+    }
+    GIVEN("Half a circle of radius 100mm sampled with 2000 points") {
+        Points points;
+        for (size_t i = 0; i < 2000; ++ i) {
+            double angle = PI * double(i) / 1999.;
+            points.emplace_back(scaled<double>(100. * cos(angle)), scaled<double>(100. * sin(angle)));
+        }
+        std::vector<ArcSegment> segments = arc_fit(points, scaled<double>(0.01));
+        THEN("The long run is split into consecutive arcs covering the whole polyline") {
+            REQUIRE(segments.size() > 1);
+            REQUIRE(segments.back().end_point_idx == points.size() - 1);
+            double length = 0.;
+            for (const ArcSegment &segment : segments) {
+                REQUIRE(segment.is_arc());
+                REQUIRE(unscaled(segment.center.norm()) < 0.01);
+                length += segment.length;
+            }
+            REQUIRE(unscaled(length) == Approx(PI * 100.).epsilon(1e-4));
+        }
+    }
+    GIVEN("A square followed by a coarse arc") {
+        Points points { { 0., 0. }, { scaled<double>(10.), 0. }, { scaled<double>(10.), scaled<double>(10.) }, { 0., scaled<double>(10.) } };
+        for (size_t i = 1; i <= 4; ++ i) {
+            double angle = 0.5 * PI + 0.5 * PI * double(i) / 4.;
+            points.emplace_back(scaled<double>(5. * cos(angle)), scaled<double>(10. + 5. * sin(angle)));
+        }
+        std::vector<ArcSegment> segments = arc_fit(points, scaled<double>(0.01));
+        THEN("The corners stay lines and the coarse arc is not fitted, as its chords are too far from the circle") {
+            REQUIRE(segments.size() == points.size() - 1);
+            for (size_t i = 0; i < segments.size(); ++ i) {
+                REQUIRE(! segments[i].is_arc());
+                REQUIRE(segments[i].end_point_idx == i + 1);
+            }
+        }
+    }
+}
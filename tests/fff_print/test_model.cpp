@@ -60,3 +60,81 @@ SCENARIO("Model construction", "[Model]") {
         }
     }
 }
+
+SCENARIO("Model instance bounding box", "[Model]") {
+    GIVEN("A model object with a sphere enclosing a cube and a rotated instance") {
+        Slic3r::TriangleMesh mesh = Slic3r::make_sphere(10., PI / 32.);
+        mesh.merge(Slic3r::make_cube(5., 5., 5.));
+        mesh.repair();
+        Slic3r::Model model;
+        Slic3r::ModelObject *model_object = model.add_object();
+        Slic3r::ModelVolume *volume = model_object->add_volume(mesh);
+        volume->set_offset(Vec3d(1., 2., 3.));
+        Slic3r::ModelInstance *instance = model_object->add_instance();
+        instance->set_offset(Vec3d(50., 60., 0.));
+        instance->set_rotation(Vec3d(0.3, 0.2, 0.7));
+        auto mesh_bbox = [volume, instance](bool dont_translate) {
+            return volume->mesh().transformed_bounding_box(instance->get_matrix(dont_translate) * volume->get_matrix());
+        };
+        THEN("The convex hull has fewer vertices than the mesh") {
+            REQUIRE(volume->get_convex_hull().its.vertices.size() < volume->mesh().its.vertices.size());
+        }
+        THEN("The volume keeps just the indexed triangle set of its repaired mesh") {
+            REQUIRE(! volume->mesh().has_facets());
+            REQUIRE(volume->mesh().facet(0).vertex[0] == mesh.facet(0).vertex[0]);
+        }
+        THEN("The instance bounding box matches the bounding box of the transformed mesh") {
+            for (bool dont_translate : { false, true }) {
+                BoundingBoxf3 bb = model_object->instance_bounding_box(0, dont_translate);
+                REQUIRE(bb.min == mesh_bbox(dont_translate).min);
+                REQUIRE(bb.max == mesh_bbox(dont_translate).max);
+            }
+        }
+        WHEN("The instance and the volume are transformed after the bounding box was queried") {
+            model_object->instance_bounding_box(0);
+            instance->set_rotation(Vec3d(0.1, 0.5, 1.2));
+            volume->set_scaling_factor(Vec3d(1., 2., 1.5));
+            BoundingBoxf3 bb = model_object->instance_bounding_box(0);
+            THEN("The bounding box is recalculated") {
+                REQUIRE(bb.min == mesh_bbox(false).min);
+                REQUIRE(bb.max == mesh_bbox(false).max);
+            }
+        }
+        WHEN("The mesh of the volume is replaced after the bounding box was queried") {
+            model_object->instance_bounding_box(0);
+            volume->set_mesh(Slic3r::make_cube(30., 40., 50.));
+            BoundingBoxf3 bb = model_object->instance_bounding_box(0);
+            THEN("The stale convex hull is released") {
+                REQUIRE(! volume->get_convex_hull_shared_ptr());
+            }
+            THEN("The bounding box is recalculated from the new mesh") {
+                REQUIRE(bb.min == mesh_bbox(false).min);
+                REQUIRE(bb.max == mesh_bbox(false).max);
+            }
+        }
+    }
+}
+
+SCENARIO("Arrange copies of an object on an infinite bed", "[Model]") {
+    GIVEN("30 copies of a 10x10mm square") {
+        const coord_t size = coord_t(scale_(10.));
+        arrangement::ArrangePolygons items(30);
+        for (arrangement::ArrangePolygon &ap : items)
+            ap.poly.contour.points = { Point(0, 0), Point(size, coord_t(0)), Point(size, size), Point(coord_t(0), size) };
+        WHEN("arranged") {
+            arrangement::arrange(items, arrangement::InfiniteBed{ scaled(Vec2d(100, 100)) }, arrangement::ArrangeParams{ scaled(2.) });
+            THEN("all the copies are placed on the first bed without overlaps") {
+                for (size_t i = 0; i < items.size(); ++ i) {
+                    REQUIRE(items[i].bed_idx == 0);
+                    BoundingBox bbi = get_extents(items[i].transformed_poly());
+                    for (size_t j = i + 1; j < items.size(); ++ j) {
+                        BoundingBox bbj = get_extents(items[j].transformed_poly());
+                        bool overlaps = bbi.min.x() < bbj.max.x() && bbj.min.x() < bbi.max.x() &&
+                                        bbi.min.y() < bbj.max.y() && bbj.min.y() < bbi.max.y();
+                        REQUIRE(! overlaps);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -138,3 +138,44 @@ SCENARIO("Print: Brim generation", "[Print]") {
         }
     }
 }
+
+SCENARIO("PrintObject: Reuse of the adaptive cubic infill octree", "[PrintObject]") {
+    GIVEN("20mm cube sliced with the adaptive cubic infill") {
+        DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({ { "fill_pattern", "adaptivecubic" }, { "fill_density", "20%" } });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        print.process();
+        std::shared_ptr<const FillAdaptive::Octree> octree = print.objects().front()->adaptive_fill_octree();
+        REQUIRE(octree);
+        REQUIRE(! print.objects().front()->support_fill_octree());
+        WHEN("the infill angle is changed") {
+            config.set_deserialize_strict("fill_angle", "30");
+            print.apply(model, config);
+            print.process();
+            THEN("the octree is reused") {
+                REQUIRE(print.objects().front()->adaptive_fill_octree() == octree);
+            }
+        }
+        WHEN("the infill density is changed") {
+            config.set_deserialize_strict("fill_density", "40%");
+            print.apply(model, config);
+            print.process();
+            THEN("the octree is rebuilt") {
+                std::shared_ptr<const FillAdaptive::Octree> rebuilt = print.objects().front()->adaptive_fill_octree();
+                REQUIRE(rebuilt);
+                REQUIRE(rebuilt != octree);
+            }
+            AND_WHEN("the infill angle is changed") {
+                std::shared_ptr<const FillAdaptive::Octree> rebuilt = print.objects().front()->adaptive_fill_octree();
+                config.set_deserialize_strict("fill_angle", "30");
+                print.apply(model, config);
+                print.process();
+                THEN("the rebuilt octree is reused") {
+                    REQUIRE(print.objects().front()->adaptive_fill_octree() == rebuilt);
+                }
+            }
+        }
+    }
+}
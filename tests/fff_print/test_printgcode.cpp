@@ -2,6 +2,7 @@
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/GCodeReader.hpp"
+#include "libslic3r/GCode/ArcFitter.hpp"
 
 #include "test_data.hpp"
 
@@ -268,3 +269,207 @@ SCENARIO( "PrintGCode basic functionality", "[PrintGCode]") {
         }
     }
 }
+
+SCENARIO("PrintGCode re-export after a change of the cooling settings", "[PrintGCode]") {
+    GIVEN("A 20mm cube exported once with cooling enabled") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "cooling",                "1" },
+            { "fan_below_layer_time",   "100" },
+            { "slowdown_below_layer_time", "60" },
+            { "max_fan_speed",          "100" },
+            { "gcode_comments",         true }
+            });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        std::string gcode_first = Slic3r::Test::gcode(print);
+        WHEN("only max_fan_speed and min_print_speed are changed") {
+            config.set_deserialize_strict({ { "max_fan_speed", "55" }, { "min_print_speed", "5" } });
+            print.apply(model, config);
+            std::string gcode_reexported = Slic3r::Test::gcode(print);
+            Slic3r::Print print_fresh;
+            Slic3r::Model model_fresh;
+            Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print_fresh, model_fresh, config);
+            std::string gcode_fresh = Slic3r::Test::gcode(print_fresh);
+            // Skip the header line, which contains the time of the export.
+            auto body = [](const std::string &gcode) { return gcode.substr(gcode.find('\n')); };
+            THEN("the re-exported G-code is the same as the one of a fresh export") {
+                REQUIRE(print.gcode_export_cache().num_replayed == 1);
+                REQUIRE(body(gcode_reexported) != body(gcode_first));
+                REQUIRE(body(gcode_reexported) == body(gcode_fresh));
+            }
+        }
+    }
+    GIVEN("A 20mm cube with max_fan_speed referenced by the layer G-code") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "cooling",                "1" },
+            { "max_fan_speed",          "100" },
+            { "layer_gcode",            "; max fan [max_fan_speed]" }
+            });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        Slic3r::Test::gcode(print);
+        WHEN("max_fan_speed is changed") {
+            config.set_deserialize_strict({ { "max_fan_speed", "55" } });
+            print.apply(model, config);
+            std::string gcode = Slic3r::Test::gcode(print);
+            THEN("the layer G-code is regenerated while replaying the cached layers") {
+                REQUIRE(print.gcode_export_cache().num_replayed == 1);
+                REQUIRE(gcode.find("; max fan 55") != std::string::npos);
+                REQUIRE(gcode.find("; max fan 100") == std::string::npos);
+            }
+        }
+    }
+    GIVEN("A 20mm cube with max_fan_speed referenced by the start G-code") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "cooling",                "1" },
+            { "max_fan_speed",          "100" },
+            { "start_gcode",            "; max fan [max_fan_speed]" }
+            });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        Slic3r::Test::gcode(print);
+        WHEN("max_fan_speed is changed") {
+            config.set_deserialize_strict({ { "max_fan_speed", "55" } });
+            print.apply(model, config);
+            std::string gcode = Slic3r::Test::gcode(print);
+            THEN("the G-code is regenerated") {
+                REQUIRE(print.gcode_export_cache().num_replayed == 0);
+                REQUIRE(gcode.find("; max fan 55") != std::string::npos);
+                REQUIRE(gcode.find("; max fan 100") == std::string::npos);
+            }
+        }
+    }
+}
+
+SCENARIO("PrintGCode re-export after a change of the per-layer G-code", "[PrintGCode]") {
+    GIVEN("A 20mm cube exported once") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "retract_layer_change",   "0" },
+            { "before_layer_gcode",     "; before layer [layer_num]" },
+            { "layer_gcode",            "; layer [layer_num] at [layer_z]" },
+            { "end_gcode",              "; end at layer [layer_num]" },
+            { "temperature",            "200" },
+            { "first_layer_temperature", "210" },
+            { "bed_temperature",        "60" },
+            { "first_layer_bed_temperature", "65" }
+            });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        Slic3r::Test::gcode(print);
+        // Skip the header line, which contains the time of the export.
+        auto body = [](const std::string &gcode) { return gcode.substr(gcode.find('\n')); };
+        auto fresh_gcode = [&config](const Slic3r::Model &model) {
+            Slic3r::Print print;
+            Slic3r::Model model_fresh;
+            Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model_fresh, config);
+            model_fresh.custom_gcode_per_print_z = model.custom_gcode_per_print_z;
+            print.apply(model_fresh, config);
+            return Slic3r::Test::gcode(print);
+        };
+        WHEN("the layer G-codes, the end G-code and the temperatures are changed") {
+            config.set_deserialize_strict({
+                { "before_layer_gcode", "; before layer [layer_num] max [max_layer_z]" },
+                { "layer_gcode",        "; new layer [layer_num]" },
+                { "end_gcode",          "; new end at layer [layer_num]" },
+                { "temperature",        "195" },
+                { "bed_temperature",    "55" }
+                });
+            print.apply(model, config);
+            std::string gcode = Slic3r::Test::gcode(print);
+            THEN("the cached layers are replayed with the new sections, the same as a fresh export") {
+                REQUIRE(print.gcode_export_cache().num_replayed == 1);
+                REQUIRE(gcode.find("; new layer 2") != std::string::npos);
+                REQUIRE(gcode.find("M104 S195") != std::string::npos);
+                REQUIRE(gcode.find("M140 S55") != std::string::npos);
+                REQUIRE(body(gcode) == body(fresh_gcode(model)));
+            }
+        }
+        WHEN("a color change and a custom G-code are added") {
+            model.custom_gcode_per_print_z.mode = CustomGCode::SingleExtruder;
+            model.custom_gcode_per_print_z.gcodes = {
+                { 5., CustomGCode::ColorChange, 1, "#FF0000", "" },
+                { 10., CustomGCode::Custom, 1, "", "; custom at 10mm" }
+            };
+            print.apply(model, config);
+            std::string gcode = Slic3r::Test::gcode(print);
+            THEN("the cached layers are replayed with the color change, the same as a fresh export") {
+                REQUIRE(print.gcode_export_cache().num_replayed == 1);
+                REQUIRE(gcode.find("; custom at 10mm") != std::string::npos);
+                REQUIRE(print.print_statistics().color_extruderid_to_used_filament.size() == 1);
+                REQUIRE(body(gcode) == body(fresh_gcode(model)));
+            }
+        }
+    }
+}
+
+SCENARIO("PrintGCode with arc fitting", "[PrintGCode]") {
+    GIVEN("A cylinder of radius 10mm slowed down by the cooling") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "cooling",                    "1" },
+            { "fan_below_layer_time",       "100" },
+            { "slowdown_below_layer_time",  "30" },
+            { "min_print_speed",            "1" },
+            { "max_fan_speed",              "100" },
+            { "use_relative_e_distances",   "0" }
+            });
+        auto export_gcode = [&config](bool arc_fitting, double fan_speedup_time) {
+            config.set_deserialize_strict({ { "arc_fitting", arc_fitting ? "1" : "0" }, { "fan_speedup_time", std::to_string(fan_speedup_time) } });
+            Slic3r::Print print;
+            Slic3r::Model model;
+            Slic3r::Test::init_print({ make_cylinder(10., 2.) }, print, model, config);
+            return Slic3r::Test::gcode(print);
+        };
+        // Arc lines and the time spent extruding, arcs measured by their length.
+        auto parse_gcode = [&config](const std::string &gcode, std::vector<std::string> &arcs) {
+            double time = 0.;
+            GCodeReader parser;
+            parser.apply_config(config);
+            parser.parse_buffer(gcode, [&arcs, &time](Slic3r::GCodeReader &self, const Slic3r::GCodeReader::GCodeLine &line) {
+                bool arc = line.cmd_is("G2") || line.cmd_is("G3");
+                if ((arc || line.cmd_is("G1")) && line.dist_E(self) > 0) {
+                    double length = line.dist_XY(self);
+                    if (arc) {
+                        float i = 0.f, j = 0.f;
+                        REQUIRE(line.has_value('I', i));
+                        REQUIRE(line.has_value('J', j));
+                        length = arc_length(Vec2d(line.dist_X(self), line.dist_Y(self)), Vec2d(i, j), line.cmd_is("G3"));
+                        arcs.emplace_back(line.raw());
+                    }
+                    time += length / (line.new_F(self) / 60.);
+                }
+            });
+            return time;
+        };
+        WHEN("the G-code is exported with and without arc fitting") {
+            std::vector<std::string> arcs_fitted, arcs_none;
+            double time_fitted = parse_gcode(export_gcode(true, 0.), arcs_fitted);
+            double time_none   = parse_gcode(export_gcode(false, 0.), arcs_none);
+            THEN("the perimeters are exported as G2 / G3 arcs") {
+                REQUIRE(arcs_none.empty());
+                REQUIRE(arcs_fitted.size() > 10);
+            }
+            THEN("the cooling slows down the arcs to the same layer time as the straight lines") {
+                REQUIRE(time_fitted == Approx(time_none).epsilon(0.05));
+            }
+        }
+        WHEN("the G-code with arcs is exported with the fan speedup") {
+            std::vector<std::string> arcs, arcs_fan_moved;
+            parse_gcode(export_gcode(true, 0.), arcs);
+            std::string gcode = export_gcode(true, 2.);
+            parse_gcode(gcode, arcs_fan_moved);
+            THEN("the fan commands are moved around the arcs, which are kept intact") {
+                REQUIRE(gcode.find("M106") != std::string::npos);
+                REQUIRE(arcs_fan_moved == arcs);
+            }
+        }
+    }
+}
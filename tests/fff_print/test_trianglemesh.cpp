@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Geometry.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Model.hpp"
@@ -380,6 +381,87 @@ SCENARIO( "TriangleMeshSlicer: Cut behavior.") {
         }
     }
 }
+SCENARIO( "TriangleMesh: Indexed triangle set only representation.") {
+    GIVEN( "A sphere with its STL facets released") {
+        TriangleMesh reference = make_sphere(10., PI / 32.);
+        reference.repair();
+        TriangleMesh mesh = reference;
+        size_t memsize_before = mesh.memsize();
+        size_t released = mesh.release_facets();
+        THEN( "The facets and neighbors are released, the statistics are retained.") {
+            REQUIRE(! mesh.has_facets());
+            REQUIRE(released > 0);
+            REQUIRE(mesh.memsize() * 2 < memsize_before);
+            REQUIRE(mesh.facets_count() == reference.facets_count());
+            REQUIRE(mesh.bounding_box().min == reference.bounding_box().min);
+            REQUIRE(mesh.bounding_box().max == reference.bounding_box().max);
+        }
+        WHEN( "The mesh is sliced") {
+            std::vector<double> z { 0.5, 3., 7.5, 15. };
+            std::vector<ExPolygons> slices     = mesh.slice(z);
+            std::vector<ExPolygons> slices_ref = reference.slice(z);
+            THEN( "The slices match the slices of the full mesh.") {
+                REQUIRE(! mesh.has_facets());
+                REQUIRE(slices.size() == slices_ref.size());
+                for (size_t i = 0; i < z.size(); ++ i)
+                    REQUIRE(slices[i] == slices_ref[i]);
+            }
+        }
+        WHEN( "The shared vertices are required") {
+            mesh.require_shared_vertices();
+            THEN( "The facets stay released.") {
+                REQUIRE(! mesh.has_facets());
+                REQUIRE(mesh.its.vertices == reference.its.vertices);
+            }
+        }
+        WHEN( "The facets are restored") {
+            mesh.restore_facets();
+            THEN( "The facets and neighbors match the original mesh.") {
+                REQUIRE(mesh.has_facets());
+                REQUIRE(mesh.stl.neighbors_start.size() == reference.stl.neighbors_start.size());
+                for (size_t i = 0; i < mesh.facets_count(); ++ i) {
+                    for (size_t j = 0; j < 3; ++ j) {
+                        REQUIRE(mesh.stl.facet_start[i].vertex[j] == reference.stl.facet_start[i].vertex[j]);
+                        REQUIRE(mesh.stl.neighbors_start[i].neighbor[j] == reference.stl.neighbors_start[i].neighbor[j]);
+                    }
+                }
+            }
+        }
+        WHEN( "The mesh is transformed") {
+            mesh.translate(1.f, 2.f, 3.f);
+            reference.translate(1.f, 2.f, 3.f);
+            THEN( "The facets stay released, the indexed triangle set and the bounding box are transformed.") {
+                REQUIRE(! mesh.has_facets());
+                REQUIRE(mesh.bounding_box().min == reference.bounding_box().min);
+                REQUIRE(mesh.bounding_box().max == reference.bounding_box().max);
+                REQUIRE(mesh.its.vertices == reference.its.vertices);
+            }
+        }
+        WHEN( "The mesh is scaled, rotated and mirrored") {
+            for (TriangleMesh *m : { &mesh, &reference }) {
+                m->scale(Vec3d(1., 2., 3.));
+                m->rotate_x(float(PI / 3.));
+                m->mirror_y();
+                m->transform(Geometry::assemble_transform(Vec3d(5., 0., 0.), Vec3d(0., 0., PI / 4.)));
+            }
+            THEN( "The facets stay released and the statistics match the full mesh.") {
+                REQUIRE(! mesh.has_facets());
+                REQUIRE(mesh.its.vertices == reference.its.vertices);
+                REQUIRE(mesh.its.indices == reference.its.indices);
+                REQUIRE(mesh.bounding_box().min.isApprox(reference.bounding_box().min));
+                REQUIRE(mesh.bounding_box().max.isApprox(reference.bounding_box().max));
+                REQUIRE(mesh.stl.stats.volume == Approx(reference.stl.stats.volume));
+            }
+            THEN( "The restored facets match the transformed full mesh.") {
+                mesh.restore_facets();
+                for (size_t i = 0; i < mesh.facets_count(); ++ i)
+                    for (size_t j = 0; j < 3; ++ j)
+                        REQUIRE(mesh.stl.facet_start[i].vertex[j] == reference.stl.facet_start[i].vertex[j]);
+            }
+        }
+    }
+}
+
 #ifdef TEST_PERFORMANCE
 TEST_CASE("Regression test for issue #4486 - files take forever to slice") {
     TriangleMesh mesh;
@@ -432,3 +514,26 @@ TEST_CASE("Profile test for issue #4486 - files take forever to slice") {
 
 }
 #endif //BUILD_PROFILE
+
+SCENARIO( "TriangleMesh: convex hull.") {
+    GIVEN( "A sphere with a cube merged inside") {
+        TriangleMesh mesh = make_sphere(10., PI / 16.);
+        mesh.merge(make_cube(5., 5., 5.));
+        mesh.repair();
+        WHEN( "The convex hull is calculated from the shared vertices and from the STL facets") {
+            TriangleMesh mesh_facets_only = mesh;
+            mesh_facets_only.its.clear();
+            REQUIRE(! mesh_facets_only.has_shared_vertices());
+            TriangleMesh hull        = mesh.convex_hull_3d();
+            TriangleMesh hull_facets = mesh_facets_only.convex_hull_3d();
+            THEN( "Both convex hulls are the same and enclose the sphere.") {
+                REQUIRE(hull.facets_count() == hull_facets.facets_count());
+                REQUIRE(hull.volume() == Approx(hull_facets.volume()));
+                REQUIRE(hull.bounding_box().min == mesh.bounding_box().min);
+                REQUIRE(hull.bounding_box().max == mesh.bounding_box().max);
+                REQUIRE(hull_facets.bounding_box().min == mesh.bounding_box().min);
+                REQUIRE(hull_facets.bounding_box().max == mesh.bounding_box().max);
+            }
+        }
+    }
+}
@@ -1189,3 +1189,68 @@ TEST_CASE("Test for biggest bounding box area", "[Nesting], [NestKernels]")
     REQUIRE(pile.size() == N);
     REQUIRE(bb.area() == N * N * W * W);
 }
+
+TEST_CASE("Nfp cache gives the same arrangement", "[Nesting], [NestKernels]")
+{
+    static const constexpr size_t N = 30;
+
+    // Copies of a single printer part, as in the fill bed use case.
+    auto &part = prusaParts().front();
+    std::vector<Item> input(N, part);
+    std::vector<Item> input_cached(N, part);
+
+    Box bin(250000000, 210000000);
+
+    NfpPlacer::Config pconfig;
+    pconfig.rotations = {0., Pi / 2.};
+
+    NfpPlacer::Config pconfig_cached = pconfig;
+    pconfig_cached.nfp_cache = std::make_shared<placers::NfpCache<PolygonImpl>>();
+
+    size_t bins = nest(input, bin, 0, NestConfig{pconfig});
+    size_t bins_cached = nest(input_cached, bin, 0, NestConfig{pconfig_cached});
+
+    // At most the nfps of the pairs of the two rotations of the part are needed.
+    REQUIRE(pconfig_cached.nfp_cache->size() > 0);
+    REQUIRE(pconfig_cached.nfp_cache->size() <= 4);
+    REQUIRE(bins == bins_cached);
+
+    for (size_t i = 0; i < N; ++i) {
+        REQUIRE(input[i].binId() == input_cached[i].binId());
+        REQUIRE(getX(input[i].translation()) == getX(input_cached[i].translation()));
+        REQUIRE(getY(input[i].translation()) == getY(input_cached[i].translation()));
+        REQUIRE(input[i].rotation() == Approx(input_cached[i].rotation()));
+    }
+}
+
+TEST_CASE("Nfp cache compares the shapes on a hit", "[Nesting], [NestKernels]")
+{
+    using Cache = placers::NfpCache<PolygonImpl>;
+
+    RectangleItem a(10, 20), b(30, 40), c(10, 21);
+    RectangleItem a_rotated(10, 20);
+    a_rotated.rotation(Pi / 2.);
+
+    REQUIRE(Cache::same_shape(a, RectangleItem(10, 20)));
+    REQUIRE(!Cache::same_shape(a, c));
+    REQUIRE(!Cache::same_shape(a, a_rotated));
+
+    Cache cache;
+    Cache::Key key{Cache::fingerprint(a), Cache::fingerprint(b)};
+    cache.insert(key, a, b, PolygonImpl(a.rawShape()));
+
+    PolygonImpl nfp;
+    REQUIRE(cache.find(key, a, b, nfp));
+    REQUIRE(sl::area(nfp) == Approx(sl::area(a.rawShape())));
+
+    // Items colliding with the key of other items are not given their nfp.
+    REQUIRE(!cache.find(key, c, b, nfp));
+    REQUIRE(!cache.find(key, a, c, nfp));
+    REQUIRE(!cache.find(key, a_rotated, b, nfp));
+
+    // The nfp of the colliding items replaces the cached one.
+    cache.insert(key, c, b, PolygonImpl(c.rawShape()));
+    REQUIRE(cache.size() == 1);
+    REQUIRE(!cache.find(key, a, b, nfp));
+    REQUIRE(cache.find(key, c, b, nfp));
+}
@@ -59,3 +59,35 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.y() == Approx(0.5));
     REQUIRE(closest_point.z() == Approx(1.));
 }
+
+TEST_CASE("Batched closest queries match the single point query", "[AABBIndirect]")
+{
+    TriangleMesh tmesh = make_sphere(10., 2. * PI / 90);
+    tmesh.repair();
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(tmesh.its.vertices, tmesh.its.indices);
+    REQUIRE(! tree.empty());
+
+    std::vector<Vec3d> points;
+    for (double x = -12.; x <= 12.; x += 1.5)
+        for (double y = -12.; y <= 12.; y += 1.5)
+            for (double z = -12.; z <= 12.; z += 1.5)
+                points.emplace_back(x, y, z);
+
+    std::vector<double> squared_distances;
+    std::vector<size_t> hit_idxs;
+    std::vector<Vec3d>  hit_points;
+    AABBTreeIndirect::squared_distances_to_indexed_triangle_set(
+        tmesh.its.vertices, tmesh.its.indices, tree, points, squared_distances, hit_idxs, hit_points);
+
+    REQUIRE(squared_distances.size() == points.size());
+    for (size_t i = 0; i < points.size(); ++ i) {
+        size_t hit_idx;
+        Vec3d  closest_point;
+        double squared_distance = AABBTreeIndirect::squared_distance_to_indexed_triangle_set(
+            tmesh.its.vertices, tmesh.its.indices, tree, points[i], hit_idx, closest_point);
+        REQUIRE(squared_distances[i] == Approx(squared_distance));
+        // Equidistant triangles may be reported differently, the distance must match.
+        REQUIRE((hit_points[i] - points[i]).squaredNorm() == Approx(squared_distance));
+    }
+}
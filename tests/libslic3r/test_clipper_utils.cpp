@@ -322,3 +322,39 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Clipper engine reused after Clear()", "[ClipperUtils]") {
+    ClipperLib::Path square { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+    ClipperLib::Path hole   { { 20, 20 }, { 20, 80 }, { 80, 80 }, { 80, 20 } };
+    ClipperLib::Path shifted { { 50, 50 }, { 150, 50 }, { 150, 150 }, { 50, 150 } };
+
+    auto difference = [](ClipperLib::Clipper &clipper, const ClipperLib::Path &subject, const ClipperLib::Path &clip) {
+        clipper.AddPath(subject.data(), subject.data() + subject.size(), ClipperLib::ptSubject, true);
+        clipper.AddPath(clip, ClipperLib::ptClip, true);
+        ClipperLib::PolyTree polytree;
+        clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        ClipperLib::Paths out;
+        ClipperLib::PolyTreeToPaths(polytree, out);
+        return out;
+    };
+
+    ClipperLib::Clipper reused;
+    for (int i = 0; i < 3; ++ i) {
+        for (const ClipperLib::Path *clip : { &hole, &shifted }) {
+            ClipperLib::Clipper fresh;
+            ClipperLib::Paths   expected = difference(fresh, square, *clip);
+            reused.Clear();
+            REQUIRE(difference(reused, square, *clip) == expected);
+        }
+    }
+
+    SECTION("Repeated ClipperUtils operations of a single thread") {
+        Polygons squares { Polygon({ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } }), Polygon({ { 50, 50 }, { 150, 50 }, { 150, 150 }, { 50, 150 } }) };
+        Polygons expected_union = union_(squares);
+        Polygons expected_diff  = diff(squares, offset(squares, -10.));
+        for (int i = 0; i < 3; ++ i) {
+            REQUIRE(union_(squares) == expected_union);
+            REQUIRE(diff(squares, offset(squares, -10.)) == expected_diff);
+        }
+    }
+}
@@ -1,5 +1,9 @@
 #include <catch2/catch.hpp>
 
+#include <sstream>
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Print.hpp"
@@ -204,6 +208,41 @@ SCENARIO("Config ini load/save interface", "[Config]") {
 			REQUIRE(config.option_throw<ConfigOptionStrings>("filament_colour", false)->values.front() == "#ABCD");
         }
     }
+    WHEN("load_from_ini_string is called") {
+		Slic3r::DynamicPrintConfig config;
+		config.load_from_ini_string("\xEF\xBB\xBF# comment\r\n; comment\n\n  layer_height =  0.15 \r\nunknown_key = 1\nfilament_colour = #ABCD\n[section]\nlayer_height = 0.3\n",
+            ForwardCompatibilitySubstitutionRule::Disable);
+        THEN("Config object contains the top level options.") {
+			REQUIRE(config.opt_float("layer_height") == Approx(0.15));
+			REQUIRE(config.option_throw<ConfigOptionStrings>("filament_colour", false)->values.front() == "#ABCD");
+        }
+    }
+    WHEN("load_from_ini_string is called with a duplicate key") {
+		Slic3r::DynamicPrintConfig config;
+        THEN("An exception is thrown.") {
+			REQUIRE_THROWS_AS(config.load_from_ini_string("layer_height = 0.15\nlayer_height = 0.2\n", ForwardCompatibilitySubstitutionRule::Disable), ConfigurationError);
+        }
+    }
+    WHEN("read_ini_tree is called on a config bundle") {
+        const std::string bundle = "\xEF\xBB\xBF# comment\r\ntop = 1\n[vendor]\nname = Test\n\n[ print:*common* ]\n  layer_height =  0.15 \r\n; comment\nstart_gcode = G28 ; home\n[print:0.15mm]\ninherits = *common*\nempty =\n";
+        boost::property_tree::ptree tree;
+        read_ini_tree(bundle, tree);
+        THEN("The tree is the same as the one read by boost::property_tree::read_ini().") {
+            std::istringstream is(bundle.substr(3));
+            boost::property_tree::ptree tree_boost;
+            boost::property_tree::read_ini(is, tree_boost);
+            REQUIRE(tree == tree_boost);
+            REQUIRE(tree.get<std::string>("print:*common*.layer_height") == "0.15");
+            REQUIRE(tree.get<std::string>("print:*common*.start_gcode") == "G28 ; home");
+        }
+    }
+    WHEN("read_ini_tree is called with a duplicate section or key") {
+        boost::property_tree::ptree tree;
+        THEN("An exception is thrown.") {
+            REQUIRE_THROWS_AS(read_ini_tree("[print:a]\nx = 1\n[print:a]\ny = 2\n", tree), ConfigurationError);
+            REQUIRE_THROWS_AS(read_ini_tree("[print:a]\nx = 1\nx = 2\n", tree), ConfigurationError);
+        }
+    }
 }
 
 SCENARIO("Config parameter conversion from old/related configurations.", "[Config][parameters]") {
@@ -218,5 +257,28 @@ SCENARIO("Config parameter conversion from old/related configurations.", "[Confi
                 REQUIRE(print.config().z_step == Approx(0.01));
             }
         }
+        WHEN("A config saved before the slicing threads became editable is loaded") {
+            // The obsolete "threads" key was set to the number of cores of the computer which saved the config.
+            Slic3r::DynamicPrintConfig config;
+            config.load_from_ini_string("threads = 2\n", ForwardCompatibilitySubstitutionRule::Disable);
+            THEN("The legacy threads key is dropped") {
+                REQUIRE(! config.has("threads"));
+                REQUIRE(! config.has("slicing_threads"));
+            }
+            THEN("The slicing threads of the print keep using all the cores") {
+                Slic3r::DynamicPrintConfig full_config = Slic3r::DynamicPrintConfig::full_print_config();
+                full_config.apply(config);
+                REQUIRE(full_config.opt_int("slicing_threads") == 0);
+            }
+        }
+        WHEN("The slicing threads are set with --threads on the command line") {
+            Slic3r::DynamicPrintAndCLIConfig config;
+            const char *argv[] = { "superslicer", "--threads", "3" };
+            t_config_option_keys extra;
+            REQUIRE(config.read_cli(3, argv, &extra));
+            THEN("The slicing threads are limited") {
+                REQUIRE(config.opt_int("slicing_threads") == 3);
+            }
+        }
     }
 }
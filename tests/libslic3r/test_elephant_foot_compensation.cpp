@@ -620,4 +620,17 @@ SCENARIO("Elephant foot compensation", "[ElephantFoot]") {
             }
         }
 	}
+
+	GIVEN("Contour with hole and a thin ring") {
+		ExPolygons expolys { contour_with_hole(), thin_ring() };
+        WHEN("Compensated by a fading compensation in one go") {
+			std::vector<double> compensations { 0.3, 0.2, 0.1 };
+			std::vector<ExPolygons> steps = elephant_foot_compensation(expolys, 0.8, compensations);
+            THEN("each step matches the compensation of its own") {
+				REQUIRE(steps.size() == compensations.size());
+				for (size_t i = 0; i < compensations.size(); ++ i)
+					REQUIRE(steps[i] == elephant_foot_compensation(expolys, 0.8, compensations[i]));
+            }
+        }
+	}
 }
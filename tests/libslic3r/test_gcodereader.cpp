@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCodeReader.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <sstream>
+
+using namespace Slic3r;
+
+// Parses the G-code line by line the way GCodeReader::parse_file() used to, to compare against the chunked parser.
+static std::vector<std::string> parse_lines_sequentially(GCodeReader &reader, const std::string &gcode, std::vector<float> &positions)
+{
+    std::vector<std::string> out;
+    std::istringstream ss(gcode);
+    std::string line;
+    while (std::getline(ss, line))
+        reader.parse_line(line, [&out, &positions](GCodeReader &reader, const GCodeReader::GCodeLine &gline) {
+            out.emplace_back(gline.raw());
+            positions.emplace_back(gline.new_X(reader) + gline.new_Y(reader) + gline.new_E(reader));
+        });
+    return out;
+}
+
+SCENARIO("GCodeReader parses files in chunks", "[GCodeReader]") {
+    GIVEN("A G-code file spanning several blocks with mixed line endings") {
+        std::string gcode = "; generated by test\n\nG90\r\nM83\n";
+        for (int i = 0; i < 100000; ++ i)
+            gcode += "G1 X" + std::to_string(i % 200) + " Y" + std::to_string(i % 150) + " E0.05 ; line " + std::to_string(i) + ((i % 7) ? "\n" : "\r\n");
+        gcode += "G92 E0\nG1 X1 Y2";
+
+        boost::filesystem::path temp = boost::filesystem::unique_path();
+        {
+            boost::nowide::ofstream f(temp.string(), std::ios::binary);
+            f << gcode;
+        }
+
+        WHEN("The file is parsed") {
+            GCodeReader reader_file;
+            std::vector<std::string> lines_file;
+            std::vector<float>       positions_file;
+            reader_file.parse_file(temp.string(), [&lines_file, &positions_file](GCodeReader &reader, const GCodeReader::GCodeLine &gline) {
+                lines_file.emplace_back(gline.raw());
+                positions_file.emplace_back(gline.new_X(reader) + gline.new_Y(reader) + gline.new_E(reader));
+            });
+            GCodeReader              reader_seq;
+            std::vector<float>       positions_seq;
+            std::vector<std::string> lines_seq = parse_lines_sequentially(reader_seq, gcode, positions_seq);
+            THEN("The lines and the tracked positions match parsing line by line") {
+                REQUIRE(lines_file.size() == lines_seq.size());
+                REQUIRE(lines_file == lines_seq);
+                REQUIRE(positions_file == positions_seq);
+                REQUIRE(reader_file.x() == reader_seq.x());
+                REQUIRE(reader_file.y() == reader_seq.y());
+            }
+        }
+        WHEN("Parsing is stopped from the callback") {
+            GCodeReader reader;
+            size_t      num_lines = 0;
+            reader.parse_file(temp.string(), [&num_lines](GCodeReader &reader, const GCodeReader::GCodeLine &gline) {
+                if (++ num_lines == 10)
+                    reader.quit_parsing_file();
+            });
+            THEN("No more lines are reported") {
+                REQUIRE(num_lines == 10);
+            }
+        }
+        boost::nowide::remove(temp.string().c_str());
+    }
+}
+
+SCENARIO("GCodeReader lines reference the parsed buffer", "[GCodeReader]") {
+    GIVEN("A buffer with commands and comments") {
+        std::string gcode = "  G1 X10 Y20.5 E1 ; move\nM107\n;TYPE:Perimeter\nG1 Z0.3\n";
+        GCodeReader reader;
+        std::vector<std::string> cmds, comments;
+        std::vector<bool>        is_g1;
+        std::string              modified;
+        reader.parse_buffer(gcode, [&](GCodeReader &reader, const GCodeReader::GCodeLine &gline) {
+            REQUIRE(gline.raw().data() >= gcode.data());
+            REQUIRE(gline.raw().data() + gline.raw().size() <= gcode.data() + gcode.size());
+            cmds.emplace_back(gline.cmd());
+            comments.emplace_back(gline.comment());
+            is_g1.emplace_back(gline.cmd_is("G1"));
+            if (gline.has('Z')) {
+                GCodeReader::GCodeLine line = gline;
+                line.set(reader, Z, 0.5f);
+                modified = std::string(line.raw());
+                REQUIRE(line.cmd_is("G1"));
+                REQUIRE(line.has('Z'));
+            }
+        });
+        THEN("The command and the comment are decoded once per line") {
+            REQUIRE(cmds == std::vector<std::string>{ "G1", "M107", "", "G1" });
+            REQUIRE(comments == std::vector<std::string>{ " move", "", "TYPE:Perimeter", "" });
+            REQUIRE(is_g1 == std::vector<bool>{ true, false, false, true });
+            REQUIRE(reader.x() == Approx(10.f));
+            REQUIRE(reader.y() == Approx(20.5f));
+            REQUIRE(reader.z() == Approx(0.3f));
+        }
+        THEN("A modified line owns its storage") {
+            REQUIRE(modified == "G1 Z0.500");
+        }
+    }
+}
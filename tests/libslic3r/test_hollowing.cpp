@@ -44,3 +44,36 @@ TEST_CASE("Negative 3D offset should produce smaller object.", "[Hollowing]")
     in_mesh.WriteOBJFile("merged_out.obj");
 }
 
+
+TEST_CASE("Sliced interior distance field should match the sliced interior mesh", "[Hollowing]")
+{
+    Slic3r::TriangleMesh in_mesh = load_model("20mm_cube.obj");
+    
+    Slic3r::sla::InteriorPtr interior = Slic3r::sla::generate_interior_grid(in_mesh);
+    REQUIRE(interior);
+    
+    Slic3r::TriangleMesh interior_mesh = Slic3r::sla::get_interior_mesh(*interior);
+    REQUIRE(! interior_mesh.empty());
+    interior_mesh.repair(true);
+    
+    std::vector<float> slice_grid = { float(in_mesh.bounding_box().center().z()) };
+    
+    std::vector<Slic3r::ExPolygons> mesh_slices;
+    Slic3r::TriangleMeshSlicer slicer(0.f, 0.f);
+    slicer.init(&interior_mesh, [] {});
+    slicer.slice(slice_grid, Slic3r::SlicingMode::Regular, &mesh_slices, [] {});
+    
+    std::vector<Slic3r::ExPolygons> grid_slices = Slic3r::sla::slice_interior(*interior, slice_grid);
+    
+    REQUIRE(mesh_slices.size() == 1);
+    REQUIRE(grid_slices.size() == 1);
+    REQUIRE(grid_slices.front().size() == mesh_slices.front().size());
+    
+    auto area = [](const Slic3r::ExPolygons &expolys) {
+        double a = 0.;
+        for (const Slic3r::ExPolygon &expoly : expolys) a += expoly.area();
+        return a;
+    };
+    
+    REQUIRE(area(grid_slices.front()) == Approx(area(mesh_slices.front())).epsilon(0.05));
+}
@@ -52,4 +52,82 @@ TEST_CASE("PNG read", "[PNG]") {
 
         REQUIRE(sum == rstsum);
     }
+
+    SECTION("Fast PNG encoder should produce the same image") {
+        // An off-centre skewed quad on a non-square raster, so that the rows
+        // differ and swapped dimensions or misplaced scanlines are detected.
+        auto drawn = create_raster({120, 80});
+        drawn.draw(ExPolygon{{-scaled(30.), -scaled(20.)},
+                             { scaled(25.), -scaled(35.)},
+                             { scaled(35.),  scaled(30.)},
+                             {-scaled(10.),  scaled(20.)}});
+
+        auto enc_fast = drawn.encode(sla::FastPNGRasterEncoder{});
+        auto enc_ref  = drawn.encode(sla::PNGRasterEncoder{});
+        REQUIRE(Slic3r::png::is_png({enc_fast.data(), enc_fast.size()}));
+
+        png::ImageGreyscale img, img_ref;
+        REQUIRE(png::decode_png({enc_fast.data(), enc_fast.size()}, img));
+        REQUIRE(png::decode_png({enc_ref.data(), enc_ref.size()}, img_ref));
+
+        REQUIRE(img.rows == drawn.resolution().height_px);
+        REQUIRE(img.cols == drawn.resolution().width_px);
+        REQUIRE(img.rows == img_ref.rows);
+        REQUIRE(img.cols == img_ref.cols);
+        REQUIRE(img.buf.size() == img_ref.buf.size());
+
+        size_t num_black = 0, num_white = 0;
+        for (size_t r = 0; r < img.rows; ++r)
+            for (size_t c = 0; c < img.cols; ++c) {
+                uint8_t px = img.buf[r * img.cols + c];
+                REQUIRE(px == drawn.read_pixel(c, r));
+                REQUIRE(px == img_ref.buf[r * img.cols + c]);
+                num_black += px == 0;
+                num_white += px == 255;
+            }
+
+        // The quad covers a part of the raster only.
+        REQUIRE(num_black > 0);
+        REQUIRE(num_white > 0);
+    }
+
+    SECTION("Identical rasters should be encoded only once") {
+        sla::CachedRasterEncoder encoder(sla::FastPNGRasterEncoder{});
+
+        auto first  = rst.encode(encoder);
+        auto second = create_raster({100, 100}).encode(encoder);
+
+        REQUIRE(encoder.reused() == 1);
+        REQUIRE(first.size() == second.size());
+
+        auto other = create_raster({100, 100});
+        other.draw(ExPolygon{{-scaled(10.), -scaled(10.)},
+                             { scaled(10.), -scaled(10.)},
+                             { scaled(10.),  scaled(10.)},
+                             {-scaled(10.),  scaled(10.)}});
+        other.encode(encoder);
+        REQUIRE(encoder.reused() == 1);
+    }
+
+    SECTION("The raster cache is bounded by bytes") {
+        auto square = create_raster({100, 100});
+        square.draw(ExPolygon{{-scaled(10.), -scaled(10.)},
+                              { scaled(10.), -scaled(10.)},
+                              { scaled(10.),  scaled(10.)},
+                              {-scaled(10.),  scaled(10.)}});
+
+        // Room for a single raster of 100 x 100 pixels.
+        sla::CachedRasterEncoder encoder(sla::FastPNGRasterEncoder{}, 15000);
+        rst.encode(encoder);
+        square.encode(encoder);
+        rst.encode(encoder);
+        REQUIRE(encoder.reused() == 0);
+        rst.encode(encoder);
+        REQUIRE(encoder.reused() == 1);
+
+        sla::CachedRasterEncoder tiny(sla::FastPNGRasterEncoder{}, 1000);
+        rst.encode(tiny);
+        rst.encode(tiny);
+        REQUIRE(tiny.reused() == 0);
+    }
 }
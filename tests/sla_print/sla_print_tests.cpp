@@ -253,3 +253,18 @@ TEST_CASE("Test concurrency")
 
     REQUIRE(s == Approx(ref));
 }
+
+TEST_CASE("Ordered stream should preserve the order of the results", "[SLARasterOutput]")
+{
+    const size_t N = 1000;
+    std::vector<size_t> out;
+    out.reserve(N);
+
+    sla::ccr_par::ordered_stream(size_t(0), N, 8,
+                                 [](size_t i) { return std::vector<size_t>(1, i * i); },
+                                 [&out](std::vector<size_t> &&v) { out.emplace_back(v.front()); });
+
+    REQUIRE(out.size() == N);
+    for (size_t i = 0; i < N; ++ i)
+        REQUIRE(out[i] == i * i);
+}
@@ -143,4 +143,28 @@ TEST_CASE("Two parallel plates should be supported", "[SupGen][Hollowed]")
     REQUIRE(!pts.empty());
 }
 
+TEST_CASE("Two adjacent new islands should both be supported", "[SupGen]")
+{
+    // Two narrow strips closer to each other than the minimal distance of the
+    // support points, appearing in the same layer.
+    double width = 0.6, depth = 10., height = 1., gap = 0.4;
+
+    TriangleMesh mesh = make_cube(width, depth, height);
+    TriangleMesh mesh_right = make_cube(width, depth, height);
+    mesh_right.translate(width + gap, 0., 0.);
+    mesh.merge(mesh_right);
+    mesh.translate(0., 0., 5.); // lift up
+    mesh.require_shared_vertices();
+
+    sla::SupportPointGenerator::Config cfg;
+    sla::SupportPoints pts = calc_support_pts(mesh, cfg);
+
+    auto on_left  = [width](const sla::SupportPoint &pt) { return pt.pos.x() < width + EPSILON; };
+    REQUIRE(std::any_of(pts.begin(), pts.end(), on_left));
+    REQUIRE(! std::all_of(pts.begin(), pts.end(), on_left));
+
+    double ddiff = min_point_distance(pts) - cfg.minimal_distance;
+    REQUIRE(ddiff > - 0.1 * cfg.minimal_distance);
+}
+
 }} // namespace Slic3r::sla
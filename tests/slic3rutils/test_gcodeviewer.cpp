@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+#include <libslic3r/Technologies.hpp>
+
+#include "slic3r/GUI/GCodeViewer.hpp"
+
+using namespace Slic3r;
+using namespace Slic3r::GUI;
+
+#if ENABLE_SPLITTED_VERTEX_BUFFER
+
+static size_t tbuffer_id(EMoveType type) { return static_cast<size_t>(type) - static_cast<size_t>(EMoveType::Retract); }
+
+static GCodeProcessor::MoveVertex make_move(EMoveType type, const Vec3f &position)
+{
+    GCodeProcessor::MoveVertex move;
+    move.type           = type;
+    move.extrusion_role = erPerimeter;
+    move.position       = position;
+    move.width          = 0.45f;
+    move.height         = 0.2f;
+    move.feedrate       = 40.f;
+    move.mm3_per_mm     = 0.08f;
+    return move;
+}
+
+SCENARIO("G-code preview toolpaths generation", "[GCodeViewer]") {
+    GIVEN("A single perimeter zig-zag too long for a single vertex buffer, followed by a retraction, a custom G-code and a travel") {
+        const size_t num_extrusions = 20000;
+        GCodeProcessor::Result result;
+        result.moves.emplace_back(make_move(EMoveType::Noop, Vec3f(0.f, 0.f, 0.2f)));
+        for (size_t i = 1; i <= num_extrusions; ++ i)
+            result.moves.emplace_back(make_move(EMoveType::Extrude, Vec3f(float(i % 2) * 10.f, float(i) * 0.01f, 0.2f)));
+        result.moves.emplace_back(make_move(EMoveType::Retract, result.moves.back().position));
+        result.moves.emplace_back(make_move(EMoveType::Custom_GCode, result.moves.back().position));
+        result.moves.emplace_back(make_move(EMoveType::Travel, Vec3f(0.f, 0.f, 0.2f)));
+
+        std::vector<GCodeToolpaths::TBuffer> buffers(static_cast<size_t>(EMoveType::Extrude));
+        GCodeToolpaths::init_buffers(buffers);
+        std::vector<GCodeToolpaths::MultiVertexBuffer> vertices(buffers.size());
+        std::vector<float> options_zs;
+        GCodeToolpaths::generate_vertices(result, buffers, vertices, options_zs);
+
+        const GCodeToolpaths::TBuffer           &extrude          = buffers[tbuffer_id(EMoveType::Extrude)];
+        const GCodeToolpaths::MultiVertexBuffer &extrude_vertices = vertices[tbuffer_id(EMoveType::Extrude)];
+        THEN("the extrusions are split into several vertex buffers") {
+            REQUIRE(extrude_vertices.size() > 1);
+            for (const GCodeToolpaths::VertexBuffer &v_buffer : extrude_vertices) {
+                REQUIRE(! v_buffer.empty());
+                REQUIRE(v_buffer.size() % extrude.vertices.vertex_size_floats() == 0);
+                REQUIRE(v_buffer.size() * sizeof(float) <= extrude.vertices.max_size_bytes());
+            }
+        }
+        THEN("the extrusions form a single path with a sub path per vertex buffer") {
+            REQUIRE(extrude.paths.size() == 1);
+            REQUIRE(extrude.paths.front().sub_paths.size() == extrude_vertices.size());
+            REQUIRE(extrude.paths.front().sub_paths.front().first.s_id == 0);
+            REQUIRE(extrude.paths.front().sub_paths.back().last.s_id == num_extrusions);
+        }
+        THEN("the retraction and the custom G-code are single points, the layer of the custom G-code is recorded") {
+            for (EMoveType type : { EMoveType::Retract, EMoveType::Custom_GCode }) {
+                const GCodeToolpaths::MultiVertexBuffer &option_vertices = vertices[tbuffer_id(type)];
+                REQUIRE(option_vertices.size() == 1);
+                REQUIRE(option_vertices.front().size() == buffers[tbuffer_id(type)].vertices.vertex_size_floats());
+            }
+            REQUIRE(options_zs.size() == 1);
+            REQUIRE(options_zs.front() == Approx(0.2f));
+        }
+        WHEN("the indices are generated") {
+            for (GCodeToolpaths::TBuffer &buffer : buffers)
+                buffer.paths.clear();
+            std::vector<GCodeToolpaths::MultiIndexBuffer>  indices(buffers.size());
+            std::vector<std::vector<unsigned int>>      vbuffer_ids(buffers.size());
+            for (size_t i = 0; i < buffers.size(); ++ i)
+                GCodeToolpaths::generate_indices(result, static_cast<unsigned char>(i), buffers[i], indices[i], vbuffer_ids[i]);
+            THEN("each index buffer refers to an existing vertex buffer and its indices stay within it") {
+                for (size_t i = 0; i < buffers.size(); ++ i) {
+                    REQUIRE(vbuffer_ids[i].size() == indices[i].size());
+                    for (size_t j = 0; j < indices[i].size(); ++ j) {
+                        REQUIRE(vbuffer_ids[i][j] < vertices[i].size());
+                        const size_t num_vertices = vertices[i][vbuffer_ids[i][j]].size() / buffers[i].vertices.vertex_size_floats();
+                        REQUIRE(! indices[i][j].empty());
+                        REQUIRE(size_t(*std::max_element(indices[i][j].begin(), indices[i][j].end())) < num_vertices);
+                    }
+                }
+            }
+            THEN("the paths are the same as those laid out with the vertices") {
+                REQUIRE(buffers[tbuffer_id(EMoveType::Extrude)].paths.size() == 1);
+                REQUIRE(buffers[tbuffer_id(EMoveType::Extrude)].paths.front().sub_paths.size() == vertices[tbuffer_id(EMoveType::Extrude)].size());
+                REQUIRE(buffers[tbuffer_id(EMoveType::Travel)].paths.size() == 1);
+            }
+        }
+    }
+}
+
+#endif // ENABLE_SPLITTED_VERTEX_BUFFER
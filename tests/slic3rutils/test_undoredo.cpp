@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+#include <libslic3r/Model.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+
+#include "slic3r/Utils/UndoRedo.hpp"
+#include "slic3r/GUI/Selection.hpp"
+
+using namespace Slic3r;
+
+static void replace_object(Model &model, double x)
+{
+    model.clear_objects();
+    model.add_object("cube", "", make_cube(x, 10., 10.))->add_instance();
+}
+
+static double object_size_x(const Model &model)
+{
+    REQUIRE(model.objects.size() == 1);
+    REQUIRE(model.objects.front()->volumes.size() == 1);
+    return model.objects.front()->volumes.front()->mesh().bounding_box().size().x();
+}
+
+SCENARIO("Undo / Redo stack compresses and spills meshes", "[UndoRedo]") {
+    GIVEN("Three snapshots of a model, each with its own cube") {
+        Model model;
+        GUI::Selection selection;
+        UndoRedo::SnapshotData snapshot_data;
+        // The snapshots are taken without the gizmos, which would require a 3D scene canvas.
+        UndoRedo::Stack stack;
+
+        replace_object(model, 10.);
+        stack.take_snapshot("A", model, selection, snapshot_data);
+        replace_object(model, 20.);
+        stack.take_snapshot("B", model, selection, snapshot_data);
+        replace_object(model, 30.);
+        // Capture the topmost state C and return to B, thus the meshes of A and C are referenced by the Undo / Redo stack only.
+        REQUIRE(stack.undo(model, selection, snapshot_data));
+        REQUIRE(object_size_x(model) == Approx(20.));
+
+        WHEN("the stack is squeezed below its memory limit") {
+            stack.set_memory_limit(1);
+            stack.release_least_recently_used();
+            THEN("the meshes are compressed and moved to the spill file") {
+                REQUIRE(stack.memsize_on_disk() > 0);
+            }
+            THEN("undo and redo restore the original meshes") {
+                REQUIRE(stack.undo(model, selection, snapshot_data));
+                REQUIRE(object_size_x(model) == Approx(10.));
+                REQUIRE(stack.redo(model));
+                REQUIRE(object_size_x(model) == Approx(20.));
+                REQUIRE(stack.redo(model));
+                REQUIRE(object_size_x(model) == Approx(30.));
+            }
+            THEN("a new mesh taking the memory of a released mesh gets its own history") {
+                replace_object(model, 40.);
+                stack.take_snapshot("D", model, selection, snapshot_data);
+                replace_object(model, 50.);
+                REQUIRE(stack.undo(model, selection, snapshot_data));
+                REQUIRE(object_size_x(model) == Approx(40.));
+                REQUIRE(stack.undo(model, selection, snapshot_data));
+                REQUIRE(object_size_x(model) == Approx(20.));
+                REQUIRE(stack.undo(model, selection, snapshot_data));
+                REQUIRE(object_size_x(model) == Approx(10.));
+                REQUIRE(stack.redo(model));
+                REQUIRE(stack.redo(model));
+                REQUIRE(object_size_x(model) == Approx(40.));
+                REQUIRE(stack.redo(model));
+                REQUIRE(object_size_x(model) == Approx(50.));
+            }
+        }
+    }
+}